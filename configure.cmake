@@ -17,6 +17,12 @@
 
 #### Features
 
+qt_feature("quick3dphysics-pvd" PRIVATE
+    LABEL "PhysX Visual Debugger"
+    PURPOSE "Builds the bundled PhysX with support for the PhysX Visual Debugger."
+    AUTODETECT OFF
+)
+
 qt_extra_definition("QT_VERSION_STR" "\"${PROJECT_VERSION}\"" PUBLIC)
 qt_extra_definition("QT_VERSION_MAJOR" ${PROJECT_VERSION_MAJOR} PUBLIC)
 qt_extra_definition("QT_VERSION_MINOR" ${PROJECT_VERSION_MINOR} PUBLIC)
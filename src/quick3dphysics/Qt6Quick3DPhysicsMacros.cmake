@@ -0,0 +1,136 @@
+# Copyright (C) 2025 The Qt Company Ltd.
+# SPDX-License-Identifier: BSD-3-Clause
+
+# Cooks meshes and heightmap images at build time with qphysicscooker and adds the cooked
+# files to the resources of the target.
+#
+# qt6_add_physics_assets(<target> <resource name>
+#     FILES <file>...
+#     [PREFIX <prefix>]
+#     [BASE <directory>]
+#     [KINDS <kind>...]
+#     [SERIALIZE]
+#     [OUTPUT_TARGETS <variable>]
+# )
+function(qt6_add_physics_assets target resource_name)
+    cmake_parse_arguments(PARSE_ARGV 2 arg "SERIALIZE" "PREFIX;BASE;OUTPUT_TARGETS" "FILES;KINDS")
+
+    if(arg_UNPARSED_ARGUMENTS)
+        message(FATAL_ERROR "Unknown arguments: ${arg_UNPARSED_ARGUMENTS}")
+    endif()
+    if(NOT arg_FILES)
+        message(FATAL_ERROR "qt6_add_physics_assets: no FILES given for ${resource_name}")
+    endif()
+
+    set(cooker_target ${QT_CMAKE_EXPORT_NAMESPACE}::qphysicscooker)
+    if(NOT TARGET ${cooker_target})
+        message(FATAL_ERROR "qt6_add_physics_assets: the ${cooker_target} tool is not available")
+    endif()
+
+    if(NOT arg_PREFIX)
+        set(arg_PREFIX "/")
+    endif()
+    if(arg_BASE)
+        get_filename_component(base_dir "${arg_BASE}" ABSOLUTE)
+    else()
+        set(base_dir "${CMAKE_CURRENT_SOURCE_DIR}")
+    endif()
+
+    set(kinds ${arg_KINDS})
+    if(NOT kinds)
+        set(kinds tri cvx hf)
+    endif()
+    foreach(kind IN LISTS kinds)
+        if(NOT kind MATCHES "^(tri|cvx|hf)$")
+            message(FATAL_ERROR "qt6_add_physics_assets: unknown kind '${kind}'")
+        endif()
+    endforeach()
+
+    set(cooker_options --jobs 1)
+    if(arg_SERIALIZE)
+        list(APPEND cooker_options --serialize)
+    endif()
+
+    set(output_root "${CMAKE_CURRENT_BINARY_DIR}/.qt/physics/${target}/${resource_name}")
+    set(cooked_files "")
+
+    # One command per input, so that only the assets that changed are cooked again
+    foreach(file IN LISTS arg_FILES)
+        get_filename_component(input "${file}" ABSOLUTE)
+        file(RELATIVE_PATH relative_input "${base_dir}" "${input}")
+        if(relative_input MATCHES "^\\.\\./")
+            message(FATAL_ERROR "qt6_add_physics_assets: ${file} is not below ${base_dir}")
+        endif()
+
+        get_filename_component(relative_dir "${relative_input}" DIRECTORY)
+        get_filename_component(name "${input}" NAME_WE)
+        get_filename_component(extension "${input}" LAST_EXT)
+        string(TOLOWER "${extension}" extension)
+        if(extension STREQUAL ".mesh")
+            set(file_kinds tri cvx)
+        else()
+            set(file_kinds hf)
+        endif()
+
+        set(output_dir "${output_root}")
+        set(alias_base "${name}")
+        if(relative_dir)
+            string(APPEND output_dir "/${relative_dir}")
+            set(alias_base "${relative_dir}/${name}")
+        endif()
+
+        set(outputs "")
+        set(cooker_kinds "")
+        foreach(kind IN LISTS file_kinds)
+            if(NOT kind IN_LIST kinds)
+                continue()
+            endif()
+            set(output "${output_dir}/${name}.cooked.${kind}")
+            set_source_files_properties("${output}" PROPERTIES
+                QT_RESOURCE_ALIAS "${alias_base}.cooked.${kind}")
+            list(APPEND outputs "${output}")
+            list(APPEND cooker_kinds "${kind}")
+        endforeach()
+
+        if(NOT outputs)
+            continue()
+        endif()
+
+        list(JOIN cooker_kinds "," cooker_kinds)
+        add_custom_command(
+            OUTPUT ${outputs}
+            COMMAND ${CMAKE_COMMAND} -E make_directory "${output_dir}"
+            COMMAND ${cooker_target} ${cooker_options} --kinds ${cooker_kinds}
+                    --output-dir "${output_dir}" "${input}"
+            DEPENDS "${input}" ${cooker_target}
+            COMMENT "Cooking ${relative_input}"
+            VERBATIM
+        )
+        list(APPEND cooked_files ${outputs})
+    endforeach()
+
+    if(NOT cooked_files)
+        message(FATAL_ERROR "qt6_add_physics_assets: nothing to cook for ${resource_name}")
+    endif()
+
+    set(output_targets "")
+    qt6_add_resources(${target} "${resource_name}"
+        PREFIX "${arg_PREFIX}"
+        FILES ${cooked_files}
+        OUTPUT_TARGETS output_targets
+    )
+
+    if(arg_OUTPUT_TARGETS)
+        set(${arg_OUTPUT_TARGETS} "${output_targets}" PARENT_SCOPE)
+    endif()
+endfunction()
+
+if(NOT QT_NO_CREATE_VERSIONLESS_FUNCTIONS)
+    function(qt_add_physics_assets)
+        qt6_add_physics_assets(${ARGV})
+        cmake_parse_arguments(PARSE_ARGV 2 arg "" "OUTPUT_TARGETS" "")
+        if(arg_OUTPUT_TARGETS)
+            set(${arg_OUTPUT_TARGETS} "${${arg_OUTPUT_TARGETS}}" PARENT_SCOPE)
+        endif()
+    endfunction()
+endif()
@@ -78,6 +78,8 @@ void QAbstractPhysXNode::rebuildDirtyShapes(QPhysicsWorld *, QPhysXWorld *) { }
 
 void QAbstractPhysXNode::updateFilters() { }
 
+void QAbstractPhysXNode::updateShapeGeometries() { }
+
 void QAbstractPhysXNode::cleanup(QPhysXWorld *)
 {
     for (auto *shape : shapes)
@@ -96,6 +98,11 @@ physx::PxTransform QAbstractPhysXNode::getGlobalPose()
     return {};
 }
 
+physx::PxBounds3 QAbstractPhysXNode::getWorldBounds()
+{
+    return physx::PxBounds3::empty();
+}
+
 bool QAbstractPhysXNode::useTriggerFlag()
 {
     return false;
@@ -127,4 +134,15 @@ void QAbstractPhysXNode::setFiltersDirty(bool dirty)
     frontendNode->m_filtersDirty = dirty;
 }
 
+bool QAbstractPhysXNode::shapeGeometriesDirty() const
+{
+    return frontendNode && frontendNode->m_shapeGeometriesDirty;
+}
+
+void QAbstractPhysXNode::setShapeGeometriesDirty(bool dirty)
+{
+    Q_ASSERT(frontendNode);
+    frontendNode->m_shapeGeometriesDirty = dirty;
+}
+
 QT_END_NAMESPACE
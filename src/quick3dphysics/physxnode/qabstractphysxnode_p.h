@@ -15,6 +15,7 @@
 // We mean it.
 //
 
+#include "foundation/PxBounds3.h"
 #include "foundation/PxTransform.h"
 #include "qtconfigmacros.h"
 
@@ -68,11 +69,14 @@ public:
     virtual void markDirtyShapes();
     virtual void rebuildDirtyShapes(QPhysicsWorld *, QPhysXWorld *);
     virtual void updateFilters();
+    virtual void updateShapeGeometries();
 
     virtual void sync(float deltaTime, QHash<QQuick3DNode *, QMatrix4x4> &transformCache) = 0;
     virtual void cleanup(QPhysXWorld *);
     virtual bool debugGeometryCapability();
     virtual physx::PxTransform getGlobalPose();
+    // The bounds of all shapes in the scene, or empty bounds if they are not known
+    virtual physx::PxBounds3 getWorldBounds();
 
     virtual bool useTriggerFlag();
     virtual DebugDrawBodyType getDebugDrawBodyType();
@@ -83,6 +87,9 @@ public:
     bool filtersDirty() const;
     void setFiltersDirty(bool dirty);
 
+    bool shapeGeometriesDirty() const;
+    void setShapeGeometriesDirty(bool dirty);
+
     QVector<physx::PxShape *> shapes;
     physx::PxMaterial *material = nullptr;
     QAbstractPhysicsNode *frontendNode = nullptr;
@@ -10,6 +10,7 @@
 #include "PxScene.h"
 
 #include "physxnode/qphysxworld_p.h"
+#include "qtquick3dphysics_tracepoints_p.h"
 #include "qabstractphysicsbody_p.h"
 #include "qheightfieldshape_p.h"
 #include "qphysicsutils_p.h"
@@ -72,17 +73,15 @@ void QPhysXActorBody::sync(float /*deltaTime*/,
                            QHash<QQuick3DNode *, QMatrix4x4> & /*transformCache*/)
 {
     auto *body = static_cast<QAbstractPhysicsBody *>(frontendNode);
+    if (!body->m_materialDirty)
+        return;
+
     if (QPhysicsMaterial *qtMaterial = body->physicsMaterial()) {
-        const float staticFriction = qtMaterial->staticFriction();
-        const float dynamicFriction = qtMaterial->dynamicFriction();
-        const float restitution = qtMaterial->restitution();
-        if (material->getStaticFriction() != staticFriction)
-            material->setStaticFriction(staticFriction);
-        if (material->getDynamicFriction() != dynamicFriction)
-            material->setDynamicFriction(dynamicFriction);
-        if (material->getRestitution() != restitution)
-            material->setRestitution(restitution);
+        material->setStaticFriction(qtMaterial->staticFriction());
+        material->setDynamicFriction(qtMaterial->dynamicFriction());
+        material->setRestitution(qtMaterial->restitution());
     }
+    body->m_materialDirty = false;
 }
 
 void QPhysXActorBody::markDirtyShapes()
@@ -125,10 +124,42 @@ void QPhysXActorBody::rebuildDirtyShapes(QPhysicsWorld * /*world*/, QPhysXWorld
 
 void QPhysXActorBody::createActor(QPhysXWorld * /*physX*/)
 {
-    auto &s_physx = StaticPhysXObjects::getReference();
     const physx::PxTransform trf = QPhysicsUtils::toPhysXTransform(frontendNode->scenePosition(),
                                                                    frontendNode->sceneRotation());
-    actor = s_physx.physics->createRigidDynamic(trf);
+    actor = createRigidDynamic(trf);
+}
+
+physx::PxRigidDynamic *QPhysXActorBody::createRigidDynamic(const physx::PxTransform &pose)
+{
+    auto &s_physx = StaticPhysXObjects::getReference();
+    return s_physx.physics->createRigidDynamic(pose);
+}
+
+physx::PxShape *QPhysXActorBody::createShape(QAbstractCollisionShape *collisionShape,
+                                             physx::PxMaterial *material, bool isTrigger,
+                                             int filterGroup, int filterIgnoreGroups)
+{
+    auto *geom = collisionShape->getPhysXGeometry();
+    if (!geom || !material)
+        return nullptr;
+
+    auto &s_physx = StaticPhysXObjects::getReference();
+    auto physXShape = s_physx.physics->createShape(*geom, *material);
+
+    if (isTrigger) {
+        physXShape->setFlag(physx::PxShapeFlag::eSIMULATION_SHAPE, false);
+        physXShape->setFlag(physx::PxShapeFlag::eTRIGGER_SHAPE, true);
+    }
+
+    { // Setup filtering
+        physx::PxFilterData filterData;
+        filterData.word0 = filterGroup;
+        filterData.word1 = filterIgnoreGroups;
+        physXShape->setSimulationFilterData(filterData);
+    }
+
+    physXShape->setLocalPose(getPhysXLocalTransform(collisionShape));
+    return physXShape;
 }
 
 bool QPhysXActorBody::debugGeometryCapability()
@@ -141,8 +172,16 @@ physx::PxTransform QPhysXActorBody::getGlobalPose()
     return actor->getGlobalPose();
 }
 
+physx::PxBounds3 QPhysXActorBody::getWorldBounds()
+{
+    if (!actor || actor->getNbShapes() == 0)
+        return physx::PxBounds3::empty();
+    return actor->getWorldBounds();
+}
+
 void QPhysXActorBody::buildShapes(QPhysXWorld * /*physX*/)
 {
+    Q_TRACE_SCOPE(QPhysXActorBody_buildShapes, int(frontendNode->getCollisionShapesList().size()));
     auto body = actor;
     for (auto *shape : shapes) {
         body->detachShape(*shape);
@@ -155,32 +194,19 @@ void QPhysXActorBody::buildShapes(QPhysXWorld * /*physX*/)
     for (const auto &collisionShape : frontendNode->getCollisionShapesList()) {
         // TODO: shapes can be shared between multiple actors.
         // Do we need to create new ones for every body?
-        auto *geom = collisionShape->getPhysXGeometry();
-        if (!geom || !material)
+        auto *physXShape = createShape(collisionShape, material, useTriggerFlag(),
+                                       frontendNode->filterGroup(),
+                                       frontendNode->filterIgnoreGroups());
+        if (!physXShape)
             continue;
 
-        auto &s_physx = StaticPhysXObjects::getReference();
-        auto physXShape = s_physx.physics->createShape(*geom, *material);
-
-        if (useTriggerFlag()) {
-            physXShape->setFlag(physx::PxShapeFlag::eSIMULATION_SHAPE, false);
-            physXShape->setFlag(physx::PxShapeFlag::eTRIGGER_SHAPE, true);
-        }
-
-        { // Setup filtering
-            physx::PxFilterData filterData;
-            filterData.word0 = frontendNode->filterGroup();
-            filterData.word1 = frontendNode->filterIgnoreGroups();
-            physXShape->setSimulationFilterData(filterData);
-        }
-
         shapes.push_back(physXShape);
-        physXShape->setLocalPose(getPhysXLocalTransform(collisionShape));
         body->attachShape(*physXShape);
     }
 
-    // Filters are always clean after building shapes
+    // Filters and geometries are always clean after building shapes
     setFiltersDirty(false);
+    setShapeGeometriesDirty(false);
 }
 
 void QPhysXActorBody::updateFilters()
@@ -200,4 +226,25 @@ void QPhysXActorBody::updateFilters()
     setFiltersDirty(false);
 }
 
+void QPhysXActorBody::updateShapeGeometries()
+{
+    if (!shapeGeometriesDirty())
+        return;
+
+    // Setting the geometry again updates the bounds and internal data of the shapes using a mesh
+    // that was changed in place
+    const auto &collisionShapes = frontendNode->getCollisionShapesList();
+    if (collisionShapes.size() != shapes.size()) {
+        setShapesDirty(true);
+        return;
+    }
+
+    for (int i = 0; i < shapes.size(); i++) {
+        if (auto *geom = collisionShapes[i]->getPhysXGeometry())
+            shapes[i]->setGeometry(*geom);
+    }
+
+    setShapeGeometriesDirty(false);
+}
+
 QT_END_NAMESPACE
@@ -19,11 +19,16 @@
 #include "qabstractphysxnode_p.h"
 
 namespace physx {
+class PxMaterial;
 class PxRigidActor;
+class PxRigidDynamic;
+class PxShape;
 }
 
 QT_BEGIN_NAMESPACE
 
+class QAbstractCollisionShape;
+
 class QPhysXActorBody : public QAbstractPhysXNode
 {
 public:
@@ -37,8 +42,15 @@ public:
 
     bool debugGeometryCapability() override;
     physx::PxTransform getGlobalPose() override;
+    physx::PxBounds3 getWorldBounds() override;
     void buildShapes(QPhysXWorld *physX);
     void updateFilters() override;
+    void updateShapeGeometries() override;
+
+    static physx::PxRigidDynamic *createRigidDynamic(const physx::PxTransform &pose);
+    static physx::PxShape *createShape(QAbstractCollisionShape *collisionShape,
+                                       physx::PxMaterial *material, bool isTrigger,
+                                       int filterGroup, int filterIgnoreGroups);
 
     physx::PxRigidActor *actor = nullptr;
 };
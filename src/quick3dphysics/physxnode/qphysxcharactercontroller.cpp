@@ -195,4 +195,11 @@ DebugDrawBodyType QPhysXCharacterController::getDebugDrawBodyType()
     return DebugDrawBodyType::Character;
 }
 
+physx::PxBounds3 QPhysXCharacterController::getWorldBounds()
+{
+    if (!controller)
+        return physx::PxBounds3::empty();
+    return controller->getActor()->getWorldBounds();
+}
+
 QT_END_NAMESPACE
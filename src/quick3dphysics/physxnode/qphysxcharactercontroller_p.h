@@ -37,6 +37,7 @@ public:
     void createMaterial(QPhysXWorld *physX) override;
     bool debugGeometryCapability() override;
     DebugDrawBodyType getDebugDrawBodyType() override;
+    physx::PxBounds3 getWorldBounds() override;
 
 private:
     physx::PxCapsuleController *controller = nullptr;
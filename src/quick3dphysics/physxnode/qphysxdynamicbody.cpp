@@ -5,17 +5,22 @@
 
 #include "PxRigidDynamic.h"
 
+#include "physxnode/qphysxworld_p.h"
 #include "qphysicscommands_p.h"
 #include "qphysicsutils_p.h"
 #include "qphysicsworld_p.h"
 #include "qabstractphysicsbody_p.h"
 #include "qdynamicrigidbody_p.h"
+#include "qtquick3dphysics_tracepoints_p.h"
+
+#include <QtCore/QElapsedTimer>
 
 QT_BEGIN_NAMESPACE
 
 static void processCommandQueue(QQueue<QPhysicsCommand *> &commandQueue,
                                 const QDynamicRigidBody &rigidBody, physx::PxRigidBody &body)
 {
+    Q_TRACE_SCOPE(QPhysXDynamicBody_processCommandQueue, int(commandQueue.size()));
     for (auto command : commandQueue) {
         command->execute(rigidBody, body);
         delete command;
@@ -96,6 +101,28 @@ static physx::PxTransform getPhysXWorldTransform(const QMatrix4x4 transform)
 
 QPhysXDynamicBody::QPhysXDynamicBody(QDynamicRigidBody *frontEnd) : QPhysXRigidBody(frontEnd) { }
 
+void QPhysXDynamicBody::init(QPhysicsWorld *world, QPhysXWorld *physX)
+{
+    QPhysXRigidBody::init(world, physX);
+    physXWorld = physX;
+
+    // A new actor has default lock flags and no kinematic target so flush everything once
+    auto *dynamicRigidBody = static_cast<QDynamicRigidBody *>(frontendNode);
+    dynamicRigidBody->m_axisLockDirty = true;
+    hasKinematicTarget = false;
+    sleepingPoseSynced = false;
+
+    // After this the sleep state is only updated by the simulation event callback
+    auto *dynamicActor = static_cast<physx::PxRigidDynamic *>(actor);
+    dynamicRigidBody->setIsSleeping(dynamicActor->isSleeping());
+}
+
+void QPhysXDynamicBody::createActor(QPhysXWorld *physX)
+{
+    QPhysXRigidBody::createActor(physX);
+    actor->setActorFlag(physx::PxActorFlag::eSEND_SLEEP_NOTIFIES, true);
+}
+
 DebugDrawBodyType QPhysXDynamicBody::getDebugDrawBodyType()
 {
     auto *dynamicRigidBody = static_cast<QDynamicRigidBody *>(frontendNode);
@@ -106,19 +133,39 @@ DebugDrawBodyType QPhysXDynamicBody::getDebugDrawBodyType()
 void QPhysXDynamicBody::sync(float deltaTime, QHash<QQuick3DNode *, QMatrix4x4> &transformCache)
 {
     auto *dynamicRigidBody = static_cast<QDynamicRigidBody *>(frontendNode);
-    // first update front end node from physx simulation
-    dynamicRigidBody->updateFromPhysicsTransform(actor->getGlobalPose());
+    // first update front end node from physx simulation. The pose is read back once more in the
+    // frame the body fell asleep in and then not again until it is woken up or gets a command.
+    const bool sleeping = dynamicRigidBody->isSleeping() && !dynamicRigidBody->isKinematic()
+            && dynamicRigidBody->commandQueue().isEmpty();
+    if (!sleeping || !sleepingPoseSynced)
+        dynamicRigidBody->updateFromPhysicsTransform(actor->getGlobalPose());
+    sleepingPoseSynced = sleeping;
 
     auto *dynamicActor = static_cast<physx::PxRigidDynamic *>(actor);
-    processCommandQueue(dynamicRigidBody->commandQueue(), *dynamicRigidBody, *dynamicActor);
+    if (!dynamicRigidBody->commandQueue().isEmpty()) {
+        QElapsedTimer timer;
+        timer.start();
+        processCommandQueue(dynamicRigidBody->commandQueue(), *dynamicRigidBody, *dynamicActor);
+        physXWorld->statistics.commandNsecs += timer.nsecsElapsed();
+    }
     if (dynamicRigidBody->isKinematic()) {
         // Since this is a kinematic body we need to calculate the transform by hand and since
         // bodies can occur in other bodies we need to calculate the tranform recursively for all
         // parents. To save some computation we cache these transforms in 'transformCache'.
         QMatrix4x4 transform = calculateKinematicNodeTransform(dynamicRigidBody, transformCache);
-        dynamicActor->setKinematicTarget(getPhysXWorldTransform(transform));
+        const physx::PxTransform target = getPhysXWorldTransform(transform);
+        // Only push the target when it moves so that resting kinematic bodies can fall asleep
+        if (!hasKinematicTarget || !QPhysicsUtils::fuzzyEquals(target, lastKinematicTarget)) {
+            dynamicActor->setKinematicTarget(target);
+            lastKinematicTarget = target;
+            hasKinematicTarget = true;
+        }
     } else {
-        dynamicActor->setRigidDynamicLockFlags(getLockFlags(dynamicRigidBody));
+        hasKinematicTarget = false;
+        if (dynamicRigidBody->m_axisLockDirty) {
+            dynamicActor->setRigidDynamicLockFlags(getLockFlags(dynamicRigidBody));
+            dynamicRigidBody->m_axisLockDirty = false;
+        }
     }
 
     const bool disabledPrevious = actor->getActorFlags() & physx::PxActorFlag::eDISABLE_SIMULATION;
@@ -129,8 +176,6 @@ void QPhysXDynamicBody::sync(float deltaTime, QHash<QQuick3DNode *, QMatrix4x4>
             dynamicActor->wakeUp();
     }
 
-    dynamicRigidBody->setIsSleeping(dynamicActor->isSleeping());
-
     QPhysXActorBody::sync(deltaTime, transformCache);
 }
 
@@ -28,10 +28,20 @@ class QPhysXDynamicBody : public QPhysXRigidBody
 public:
     QPhysXDynamicBody(QDynamicRigidBody *frontEnd);
 
+    void init(QPhysicsWorld *world, QPhysXWorld *physX) override;
+    void createActor(QPhysXWorld *physX) override;
     DebugDrawBodyType getDebugDrawBodyType() override;
     void sync(float deltaTime, QHash<QQuick3DNode *, QMatrix4x4> &transformCache) override;
     void rebuildDirtyShapes(QPhysicsWorld *world, QPhysXWorld *physX) override;
     void updateDefaultDensity(float density) override;
+
+private:
+    physx::PxTransform lastKinematicTarget = physx::PxTransform(physx::PxIdentity);
+    bool hasKinematicTarget = false;
+    // Set once the pose of a sleeping body has been read back, it does not change until it wakes
+    bool sleepingPoseSynced = false;
+    // The time spent executing queued commands is added to its frame statistics
+    QPhysXWorld *physXWorld = nullptr;
 };
 
 QT_END_NAMESPACE
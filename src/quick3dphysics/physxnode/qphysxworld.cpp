@@ -6,19 +6,24 @@
 #include "characterkinematic/PxControllerManager.h"
 #include "cooking/PxCooking.h"
 #include "extensions/PxDefaultCpuDispatcher.h"
-#include "pvd/PxPvdTransport.h"
 #include "PxFoundation.h"
 #include "PxPhysics.h"
 #include "PxPhysicsVersion.h"
 #include "PxRigidActor.h"
 #include "PxScene.h"
 #include "PxSimulationEventCallback.h"
+#include "foundation/PxProfiler.h"
 
 #include "qabstractphysicsnode_p.h"
+#include "qcacheutils_p.h"
+#include "qcookingparameters_p.h"
+#include "qphysicsmeshutils_p_p.h"
 #include "qphysicsutils_p.h"
+#include "qphysicsvisualdebugger_p.h"
 #include "qphysicsworld_p.h"
 #include "qstaticphysxobjects_p.h"
 #include "qtriggerbody_p.h"
+#include "qtquick3dphysics_tracepoints_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -45,7 +50,11 @@ public:
             QAbstractPhysicsNode *otherNode =
                     static_cast<QAbstractPhysicsNode *>(pairs[i].otherActor->userData);
 
-            if (!triggerNode || !otherNode) {
+            // Bodies simulated by PhysicsInstancing have no node
+            if (!otherNode)
+                continue;
+
+            if (!triggerNode) {
                 qWarning() << "QtQuick3DPhysics internal error: null pointer in trigger collision.";
                 continue;
             }
@@ -73,8 +82,14 @@ public:
 
     void onConstraintBreak(physx::PxConstraintInfo * /*constraints*/,
                            physx::PxU32 /*count*/) override {};
-    void onWake(physx::PxActor ** /*actors*/, physx::PxU32 /*count*/) override {};
-    void onSleep(physx::PxActor ** /*actors*/, physx::PxU32 /*count*/) override {};
+    void onWake(physx::PxActor **actors, physx::PxU32 count) override
+    {
+        registerSleepStateChanges(actors, count, false);
+    }
+    void onSleep(physx::PxActor **actors, physx::PxU32 count) override
+    {
+        registerSleepStateChanges(actors, count, true);
+    }
     void onContact(const physx::PxContactPairHeader &pairHeader, const physx::PxContactPair *pairs,
                    physx::PxU32 nbPairs) override
     {
@@ -142,6 +157,18 @@ public:
                    const physx::PxU32 /*count*/) override {};
 
 private:
+    void registerSleepStateChanges(physx::PxActor **actors, physx::PxU32 count, bool isSleeping)
+    {
+        QMutexLocker locker(&world->m_removedPhysicsNodesMutex);
+
+        for (physx::PxU32 i = 0; i < count; i++) {
+            QAbstractPhysicsNode *node = static_cast<QAbstractPhysicsNode *>(actors[i]->userData);
+            if (!node || world->isNodeRemoved(node))
+                continue;
+            world->registerSleepStateChange(node, isSleeping);
+        }
+    }
+
     QPhysicsWorld *world = nullptr;
 };
 
@@ -207,6 +234,27 @@ contactReportFilterShaderCCD(physx::PxFilterObjectAttributes /*attributes0*/,
     return physx::PxFilterFlag::eDEFAULT;
 }
 
+// Forwards the profiler zones of PhysX to the trace points so that they show up on the same
+// timeline as the rest of the application. PhysX only reports zones when it is built with
+// PX_PROFILE, which is the case when Qt is built with tracing.
+class ProfilerCallback : public physx::PxProfilerCallback
+{
+public:
+    void *zoneStart(const char *eventName, bool /*detached*/, uint64_t contextId) override
+    {
+        Q_TRACE(PhysX_zone_entry, eventName, contextId);
+        return nullptr;
+    }
+
+    void zoneEnd(void * /*profilerData*/, const char *eventName, bool /*detached*/,
+                 uint64_t contextId) override
+    {
+        Q_TRACE(PhysX_zone_exit, eventName, contextId);
+    }
+};
+
+static ProfilerCallback profilerCallback;
+
 #define PHYSX_RELEASE(x)                                                                           \
     if (x != nullptr) {                                                                            \
         x->release();                                                                              \
@@ -227,12 +275,11 @@ void QPhysXWorld::createWorld()
         qFatal("PxCreateFoundation failed!");
 
     s_physx.foundationCreated = true;
+    // A visual debugger connected with profile instrumentation replaces this callback
+    PxSetProfilerCallback(&profilerCallback);
 
-#if PHYSX_ENABLE_PVD
-    s_physx.pvd = PxCreatePvd(*m_physx->foundation);
-    s_physx.transport = physx::PxDefaultPvdSocketTransportCreate("qt", 5425, 10);
-    s_physx.pvd->connect(*m_physx->transport, physx::PxPvdInstrumentationFlag::eALL);
-#endif
+    // Off unless configured, the physics objects are then created without instrumentation
+    s_physx.pvd = QPhysicsVisualDebugger::connect(*s_physx.foundation, s_physx.transport);
 
     // FIXME: does the tolerance matter?
     s_physx.cooking = PxCreateCooking(PX_PHYSICS_VERSION, *s_physx.foundation,
@@ -245,14 +292,22 @@ void QPhysXWorld::deleteWorld()
     auto &s_physx = StaticPhysXObjects::getReference();
     s_physx.foundationRefCount--;
     if (s_physx.foundationRefCount == 0) {
+        // Background cooking uses the cooking object released below
+        QQuick3DPhysicsMeshManager::waitForCooking();
+        QCacheUtils::saveCacheIndex();
         PHYSX_RELEASE(controllerManager);
         PHYSX_RELEASE(scene);
         PHYSX_RELEASE(s_physx.dispatcher);
         PHYSX_RELEASE(s_physx.cooking);
-        PHYSX_RELEASE(s_physx.transport);
-        PHYSX_RELEASE(s_physx.pvd);
+        QCookingParameters::releaseCookings();
         PHYSX_RELEASE(s_physx.physics);
+        // The PVD flushes to the transport when it is released
+        PHYSX_RELEASE(s_physx.pvd);
+        PHYSX_RELEASE(s_physx.transport);
+        PxSetProfilerCallback(nullptr);
         PHYSX_RELEASE(s_physx.foundation);
+        // Frees the blocks of the deserialized meshes that were still in use
+        QCacheUtils::releaseSerializedData();
 
         delete callback;
         callback = nullptr;
@@ -312,6 +367,8 @@ void QPhysXWorld::createScene(float typicalLength, float typicalSpeed, const QVe
         sceneDesc.staticKineFilteringMode = physx::PxPairFilteringMode::eKEEP;
 
     scene = s_physx.physics->createScene(sceneDesc);
+    if (s_physx.pvd)
+        QPhysicsVisualDebugger::setupScene(scene);
 }
 
 QT_END_NAMESPACE
@@ -17,6 +17,11 @@
 
 #include "qtconfigmacros.h"
 
+#include <QtCore/QByteArray>
+#include <QtGui/QVector3D>
+
+#include "PxSimulationStatistics.h"
+
 namespace physx {
 class PxScene;
 class PxControllerManager;
@@ -26,7 +31,23 @@ QT_BEGIN_NAMESPACE
 
 class SimulationEventCallback;
 class QPhysicsWorld;
-class QVector3D;
+
+// The cost of one frame, published by QPhysicsWorld as its statistics
+struct QPhysXFrameStatistics
+{
+    // Written by the simulation thread before it reports the frame as done
+    qint64 simulateNsecs = 0;
+    qint64 fetchNsecs = 0;
+    physx::PxSimulationStatistics simulation;
+
+    // Written by the GUI thread while it processes the frame
+    qint64 syncNsecs = 0;
+    qint64 commandNsecs = 0;
+    qint64 contactCallbackNsecs = 0;
+    qint64 debugDrawNsecs = 0;
+    int shapeRebuildCount = 0;
+    int shapeGeometryUpdateCount = 0;
+};
 
 class QPhysXWorld
 {
@@ -41,6 +62,14 @@ public:
     SimulationEventCallback *callback = nullptr;
     physx::PxScene *scene = nullptr;
     bool isRunning = false;
+
+    // The debug visualization of the last simulated frame, written by the simulation thread
+    // before it reports the frame as done and read by the GUI thread before the next one starts
+    QByteArray visualizationVertices;
+    QVector3D visualizationBoundsMin;
+    QVector3D visualizationBoundsMax;
+
+    QPhysXFrameStatistics statistics;
 };
 
 QT_END_NAMESPACE
@@ -16,6 +16,7 @@
 //
 
 #include <QtQuick3DPhysics/qtquick3dphysicsglobal.h>
+#include <QtCore/QFuture>
 #include <QtQuick3D/private/qquick3dnode_p.h>
 #include <QtQml/QQmlEngine>
 
@@ -41,12 +42,18 @@ public:
 
     virtual bool isStaticShape() const = 0;
 
+    // Starts cooking the geometry on the cooking thread pool if it needs cooking. Returns an
+    // invalid future if there is nothing to cook.
+    virtual QFuture<QByteArray> cookAsync() { return QFuture<QByteArray>(); }
+
 public slots:
     void setEnableDebugDraw(bool enableDebugDraw);
 
 signals:
     void enableDebugDrawChanged(bool enableDebugDraw);
     void needsRebuild(QObject *);
+    // The geometry was changed in place, the PhysX shapes using it only need to be updated
+    void needsGeometryUpdate(QObject *);
 
 protected:
     bool m_scaleDirty = true;
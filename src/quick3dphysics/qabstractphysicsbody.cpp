@@ -35,6 +35,7 @@ QT_BEGIN_NAMESPACE
 QAbstractPhysicsBody::QAbstractPhysicsBody()
 {
     m_physicsMaterial = new QPhysicsMaterial(this);
+    connectMaterialSignals();
 }
 
 QPhysicsMaterial *QAbstractPhysicsBody::physicsMaterial() const
@@ -47,6 +48,8 @@ void QAbstractPhysicsBody::setPhysicsMaterial(QPhysicsMaterial *newPhysicsMateri
     if (m_physicsMaterial == newPhysicsMaterial)
         return;
     m_physicsMaterial = newPhysicsMaterial;
+    connectMaterialSignals();
+    m_materialDirty = true;
     emit physicsMaterialChanged();
 }
 
@@ -63,4 +66,24 @@ void QAbstractPhysicsBody::setSimulationEnabled(bool newSimulationEnabled)
     emit simulationEnabledChanged();
 }
 
+void QAbstractPhysicsBody::connectMaterialSignals()
+{
+    // The material can be shared between several bodies so instead of letting the backend compare
+    // the material values every frame we mark the body dirty when any of its values change.
+    for (const auto &connection : std::as_const(m_materialConnections))
+        disconnect(connection);
+    m_materialConnections.clear();
+
+    if (!m_physicsMaterial)
+        return;
+
+    const auto markDirty = [this] { m_materialDirty = true; };
+    m_materialConnections.append(connect(m_physicsMaterial, &QPhysicsMaterial::staticFrictionChanged,
+                                         this, markDirty));
+    m_materialConnections.append(connect(m_physicsMaterial,
+                                         &QPhysicsMaterial::dynamicFrictionChanged, this, markDirty));
+    m_materialConnections.append(connect(m_physicsMaterial, &QPhysicsMaterial::restitutionChanged,
+                                         this, markDirty));
+}
+
 QT_END_NAMESPACE
@@ -44,8 +44,14 @@ Q_SIGNALS:
     void simulationEnabledChanged();
 
 private:
+    void connectMaterialSignals();
+
     QPhysicsMaterial *m_physicsMaterial = nullptr;
+    QList<QMetaObject::Connection> m_materialConnections;
     bool m_simulationEnabled = true;
+    bool m_materialDirty = false;
+
+    friend class QPhysXActorBody;
 };
 
 QT_END_NAMESPACE
@@ -3,6 +3,7 @@
 
 #include "qabstractphysicsnode_p.h"
 #include <QtQuick3D/private/qquick3dobject_p.h>
+#include <QtQuick3D/private/qquick3dnode_p_p.h>
 #include <foundation/PxTransform.h>
 
 #include "qphysicsworld_p.h"
@@ -151,15 +152,91 @@ void QAbstractPhysicsNode::updateFromPhysicsTransform(const physx::PxTransform &
     // Get this nodes parent transform
     const QQuick3DNode *parentNode = static_cast<QQuick3DNode *>(parentItem());
 
-    if (!parentNode) {
-        // then it is the same space
-        setRotation(qtRotation);
-        setPosition(qtPosition);
+    QVector3D localPosition = qtPosition;
+    QQuaternion localRotation = qtRotation;
+    if (parentNode) {
+        localPosition = parentNode->mapPositionFromScene(qtPosition);
+        localRotation = parentNode->sceneRotation().inverted() * qtRotation;
+    }
+
+    if (m_directTransformUpdates) {
+        // Written into the node by the world once all bodies are synced
+        m_pendingPosition = localPosition;
+        m_pendingRotation = localRotation;
+        m_hasPendingTransform = true;
     } else {
-        setPosition(parentNode->mapPositionFromScene(qtPosition));
-        const auto relativeRotation = parentNode->sceneRotation().inverted() * qtRotation;
-        setRotation(relativeRotation);
+        setRotation(localRotation);
+        setPosition(localPosition);
+    }
+}
+
+// Writes the pending transform straight into the node without emitting any signals. Returns true
+// if one of the change signals has something connected to it and emitTransformChanged() needs to
+// be called.
+bool QAbstractPhysicsNode::writePendingTransform()
+{
+    static const QMetaMethod positionChangedSignal =
+            QMetaMethod::fromSignal(&QQuick3DNode::positionChanged);
+    static const QMetaMethod xChangedSignal = QMetaMethod::fromSignal(&QQuick3DNode::xChanged);
+    static const QMetaMethod yChangedSignal = QMetaMethod::fromSignal(&QQuick3DNode::yChanged);
+    static const QMetaMethod zChangedSignal = QMetaMethod::fromSignal(&QQuick3DNode::zChanged);
+    static const QMetaMethod rotationChangedSignal =
+            QMetaMethod::fromSignal(&QQuick3DNode::rotationChanged);
+    static const QMetaMethod eulerRotationChangedSignal =
+            QMetaMethod::fromSignal(&QQuick3DNode::eulerRotationChanged);
+
+    m_hasPendingTransform = false;
+    m_changedTransformSignals = 0;
+
+    QQuick3DNodePrivate *d = QQuick3DNodePrivate::get(this);
+    const QVector3D oldPosition = d->m_position;
+    const bool positionDirty = oldPosition != m_pendingPosition;
+    const bool rotationDirty = !(d->m_rotation == m_pendingRotation);
+
+    if (!positionDirty && !rotationDirty)
+        return false;
+
+    if (positionDirty) {
+        d->m_position = m_pendingPosition;
+        if (isSignalConnected(positionChangedSignal))
+            m_changedTransformSignals |= PositionChanged;
+        if (oldPosition.x() != m_pendingPosition.x() && isSignalConnected(xChangedSignal))
+            m_changedTransformSignals |= XChanged;
+        if (oldPosition.y() != m_pendingPosition.y() && isSignalConnected(yChangedSignal))
+            m_changedTransformSignals |= YChanged;
+        if (oldPosition.z() != m_pendingPosition.z() && isSignalConnected(zChangedSignal))
+            m_changedTransformSignals |= ZChanged;
+    }
+    if (rotationDirty) {
+        d->m_rotation = m_pendingRotation;
+        if (isSignalConnected(rotationChangedSignal))
+            m_changedTransformSignals |= RotationChanged;
+        if (isSignalConnected(eulerRotationChangedSignal))
+            m_changedTransformSignals |= EulerRotationChanged;
     }
+    d->markSceneTransformDirty();
+    update();
+
+    return m_changedTransformSignals != 0;
+}
+
+void QAbstractPhysicsNode::emitTransformChanged()
+{
+    const int changed = m_changedTransformSignals;
+    m_changedTransformSignals = 0;
+
+    if (changed & PositionChanged)
+        emit positionChanged();
+    if (changed & XChanged)
+        emit xChanged();
+    if (changed & YChanged)
+        emit yChanged();
+    if (changed & ZChanged)
+        emit zChanged();
+    if (changed & RotationChanged)
+        emit rotationChanged();
+    if (changed & EulerRotationChanged)
+        emit eulerRotationChanged();
 }
 
 bool QAbstractPhysicsNode::sendContactReports() const
@@ -236,6 +313,11 @@ void QAbstractPhysicsNode::onShapeNeedsRebuild(QObject * /*object*/)
     m_shapesDirty = true;
 }
 
+void QAbstractPhysicsNode::onShapeNeedsGeometryUpdate(QObject * /*object*/)
+{
+    m_shapeGeometriesDirty = true;
+}
+
 void QAbstractPhysicsNode::qmlAppendShape(QQmlListProperty<QAbstractCollisionShape> *list,
                                           QAbstractCollisionShape *shape)
 {
@@ -266,6 +348,8 @@ void QAbstractPhysicsNode::qmlAppendShape(QQmlListProperty<QAbstractCollisionSha
     // Connect to rebuild signal
     connect(shape, &QAbstractCollisionShape::needsRebuild, self,
             &QAbstractPhysicsNode::onShapeNeedsRebuild);
+    connect(shape, &QAbstractCollisionShape::needsGeometryUpdate, self,
+            &QAbstractPhysicsNode::onShapeNeedsGeometryUpdate);
 }
 
 QAbstractCollisionShape *
@@ -87,6 +87,7 @@ public:
 private Q_SLOTS:
     void onShapeDestroyed(QObject *object);
     void onShapeNeedsRebuild(QObject *object);
+    void onShapeNeedsGeometryUpdate(QObject *object);
 
 Q_SIGNALS:
     void bodyContact(QAbstractPhysicsNode *body, const QVector<QVector3D> &positions,
@@ -108,8 +109,21 @@ private:
     static qsizetype qmlShapeCount(QQmlListProperty<QAbstractCollisionShape> *list);
     static void qmlClearShapes(QQmlListProperty<QAbstractCollisionShape> *list);
 
+    bool writePendingTransform();
+    void emitTransformChanged();
+
+    enum TransformSignal {
+        PositionChanged = 0x01,
+        XChanged = 0x02,
+        YChanged = 0x04,
+        ZChanged = 0x08,
+        RotationChanged = 0x10,
+        EulerRotationChanged = 0x20,
+    };
+
     QVector<QAbstractCollisionShape *> m_collisionShapes;
     bool m_shapesDirty = false;
+    bool m_shapeGeometriesDirty = false;
     bool m_sendContactReports = false;
     bool m_receiveContactReports = false;
     bool m_sendTriggerReports = false;
@@ -118,6 +132,12 @@ private:
     int m_filterGroup = 0;
     int m_filterIgnoreGroups = 0;
     bool m_filtersDirty = false;
+    bool m_directTransformUpdates = false;
+    // The transform read back from the simulation when m_directTransformUpdates is set
+    bool m_hasPendingTransform = false;
+    QVector3D m_pendingPosition;
+    QQuaternion m_pendingRotation;
+    int m_changedTransformSignals = 0;
 
     friend class QAbstractPhysXNode;
     friend class QPhysicsWorld; // for register/deregister TODO: cleaner mechanism
@@ -3,20 +3,250 @@
 
 #include "qcacheutils_p.h"
 
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QList>
+#include <QMutex>
+#include <QSaveFile>
+#include <QTimeZone>
 #include <QtQml/QQmlFile>
+
+#include <memory>
+
+#include "PxPhysicsVersion.h"
+#include "cooking/PxConvexMeshDesc.h"
+#include "cooking/PxCooking.h"
 #include <extensions/PxExtensionsAPI.h>
+#include <extensions/PxSerialization.h>
+#include <common/PxCollection.h>
+#include <common/PxSerialFramework.h>
+#include <geometry/PxConvexMesh.h>
+#include <geometry/PxHeightField.h>
+#include <geometry/PxTriangleMesh.h>
 #include "qphysicsworld_p.h"
+#include "qstaticphysxobjects_p.h"
+#include "qtquick3dphysics_tracepoints_p.h"
 
 QT_BEGIN_NAMESPACE
 namespace QCacheUtils {
 
-enum class CacheGeometry { TriangleMesh, ConvexMesh, HeightField };
+// The environment is read on first use, not when the library is loaded
+static const QString &cachePath()
+{
+    static const QString path = qEnvironmentVariable("QT_PHYSICS_CACHE_PATH");
+    return path;
+}
+
+// Bump when the layout of the cache files or the key changes
+static constexpr quint32 CACHE_FORMAT_VERSION = 3;
 
-static QString MESH_CACHE_PATH = qEnvironmentVariable("QT_PHYSICS_CACHE_PATH");
+template<typename T>
+static void addToHash(QCryptographicHash &hash, T value)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    hash.addData(QByteArrayView(reinterpret_cast<const char *>(&value), sizeof(T)));
+}
 
-static QString getCachedFilename(const QString &filePath, CacheGeometry geom)
+static void addCookingParamsToHash(QCryptographicHash &hash, const physx::PxCookingParams &params)
+{
+    // Hash the fields one by one since the struct contains padding
+    addToHash(hash, params.areaTestEpsilon);
+    addToHash(hash, params.planeTolerance);
+    addToHash(hash, quint32(params.convexMeshCookingType));
+    addToHash(hash, params.suppressTriangleMeshRemapTable);
+    addToHash(hash, params.buildTriangleAdjacencies);
+    addToHash(hash, params.buildGPUData);
+    addToHash(hash, params.scale.length);
+    addToHash(hash, params.scale.speed);
+    addToHash(hash, quint32(params.meshPreprocessParams));
+    addToHash(hash, params.meshWeldTolerance);
+    addToHash(hash, params.gaussMapLimit);
+
+    const physx::PxMeshMidPhase::Enum midphase = params.midphaseDesc.getType();
+    addToHash(hash, quint32(midphase));
+    if (midphase == physx::PxMeshMidPhase::eBVH33) {
+        addToHash(hash, params.midphaseDesc.mBVH33Desc.meshSizePerformanceTradeOff);
+        addToHash(hash, quint32(params.midphaseDesc.mBVH33Desc.meshCookingHint));
+    } else if (midphase == physx::PxMeshMidPhase::eBVH34) {
+        addToHash(hash, params.midphaseDesc.mBVH34Desc.numPrimsPerLeaf);
+    }
+}
+
+// The cache index maps source files to their size, modification time and SHA-256 so the source
+// only has to be hashed again when its metadata changed. In trusted mode the index is treated as
+// a prebuilt manifest: entries are used without looking at the source file at all and the index
+// is never written, which suits read-only deployments. Otherwise new entries are written in one
+// go when the physics world has prepared its initial shapes and when it is shut down.
+static const QString CACHE_INDEX_FILENAME = QStringLiteral("index.json");
+
+static bool cacheTrusted()
+{
+    static const bool trusted = qEnvironmentVariableIntValue("QT_PHYSICS_CACHE_TRUSTED") != 0;
+    return trusted;
+}
+
+// Local source files are keyed relative to this directory, so that an index prepared in advance
+// matches wherever the application is installed
+static const QString &cacheRoot()
+{
+    static const QString root = qEnvironmentVariableIsSet("QT_PHYSICS_CACHE_ROOT")
+            ? QFileInfo(qEnvironmentVariable("QT_PHYSICS_CACHE_ROOT")).absoluteFilePath()
+            : QCoreApplication::applicationDirPath();
+    return root;
+}
+
+QString cacheIndexKey(const QString &filePath, const QString &root)
+{
+    if (filePath.startsWith(u':'))
+        return QDir::cleanPath(filePath);
+
+    // Files outside of the root keep their absolute path so they can not clash with files below it
+    const QString absolutePath = QFileInfo(filePath).absoluteFilePath();
+    const QString relativePath = QDir(root).relativeFilePath(absolutePath);
+    if (relativePath.startsWith(QLatin1String("../")) || QDir::isAbsolutePath(relativePath))
+        return absolutePath;
+    return relativePath;
+}
+
+static QMutex cacheIndexMutex;
+static QHash<QString, CacheIndexEntry> cacheIndex;
+static bool cacheIndexLoaded = false;
+// Set when the index has entries that are not written to the index file yet
+static bool cacheIndexDirty = false;
+
+static void loadCacheIndex()
+{
+    if (cacheIndexLoaded)
+        return;
+    cacheIndexLoaded = true;
+
+    QFile indexFile(cachePath() + QLatin1Char('/') + CACHE_INDEX_FILENAME);
+    if (!indexFile.open(QIODevice::ReadOnly))
+        return;
+
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(indexFile.readAll(), &error);
+    if (error.error != QJsonParseError::NoError) {
+        qCWarning(lcQuick3dPhysics) << "Ignoring invalid cache index" << indexFile.fileName()
+                                    << error.errorString();
+        return;
+    }
+
+    const QJsonObject sources = document.object().value(QLatin1String("sources")).toObject();
+    for (auto it = sources.constBegin(); it != sources.constEnd(); ++it) {
+        const QJsonObject object = it.value().toObject();
+        CacheIndexEntry entry;
+        entry.size = object.value(QLatin1String("size")).toInteger(-1);
+        entry.lastModified = object.value(QLatin1String("mtime")).toInteger(-1);
+        const QString hash = object.value(QLatin1String("sha256")).toString();
+        entry.hash = QByteArray::fromHex(hash.toLatin1());
+        if (!entry.hash.isEmpty())
+            cacheIndex.insert(it.key(), entry);
+    }
+
+    qCDebug(lcQuick3dPhysics) << "Read" << cacheIndex.size() << "entries from"
+                              << indexFile.fileName();
+}
+
+bool writeCacheIndex(const QString &indexPath, const QHash<QString, CacheIndexEntry> &index)
+{
+    QJsonObject sources;
+    for (auto it = index.constBegin(); it != index.constEnd(); ++it) {
+        QJsonObject object;
+        object.insert(QLatin1String("size"), it->size);
+        object.insert(QLatin1String("mtime"), it->lastModified);
+        object.insert(QLatin1String("sha256"), QString::fromLatin1(it->hash.toHex()));
+        sources.insert(it.key(), object);
+    }
+
+    QJsonObject root;
+    root.insert(QLatin1String("sources"), sources);
+
+    QSaveFile indexFile(indexPath);
+    if (!indexFile.open(QIODevice::WriteOnly)) {
+        qCWarning(lcQuick3dPhysics) << "Could not open" << indexPath << "for writing.";
+        return false;
+    }
+    indexFile.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    if (!indexFile.commit()) {
+        qCWarning(lcQuick3dPhysics) << "Could not write" << indexPath;
+        return false;
+    }
+    return true;
+}
+
+QByteArray sourceHash(const QString &filePath)
+{
+    const QString indexKey = cacheIndexKey(filePath, cacheRoot());
+    CacheIndexEntry indexed;
+    {
+        QMutexLocker locker(&cacheIndexMutex);
+        loadCacheIndex();
+        indexed = cacheIndex.value(indexKey);
+    }
+
+    // A trusted index is used without looking at the source file at all
+    if (cacheTrusted() && !indexed.hash.isEmpty())
+        return indexed.hash;
+
+    const QFileInfo fileInfo(filePath);
+    const qint64 size = fileInfo.size();
+    const qint64 lastModified = fileInfo.lastModified(QTimeZone::UTC).toMSecsSinceEpoch();
+    if (!indexed.hash.isEmpty() && indexed.size == size && indexed.lastModified == lastModified)
+        return indexed.hash;
+
+    // Hashing large files takes a while, so other cooking threads can use the index meanwhile
+    QFile sourceFile(filePath);
+    if (!sourceFile.open(QIODevice::ReadOnly)) {
+        qWarning() << "Could not open" << filePath;
+        return QByteArray();
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    if (!hash.addData(&sourceFile)) {
+        qWarning() << "Could not read" << filePath;
+        return QByteArray();
+    }
+
+    CacheIndexEntry entry;
+    entry.size = size;
+    entry.lastModified = lastModified;
+    entry.hash = hash.result();
+
+    // The index file is written by saveCacheIndex() once a batch of shapes has been cooked
+    QMutexLocker locker(&cacheIndexMutex);
+    cacheIndex.insert(indexKey, entry);
+    if (!cacheTrusted())
+        cacheIndexDirty = true;
+
+    return entry.hash;
+}
+
+void saveCacheIndex()
+{
+    QHash<QString, CacheIndexEntry> index;
+    {
+        QMutexLocker locker(&cacheIndexMutex);
+        if (!cacheIndexDirty)
+            return;
+        cacheIndexDirty = false;
+        index = cacheIndex;
+    }
+    writeCacheIndex(cachePath() + QLatin1Char('/') + CACHE_INDEX_FILENAME, index);
+}
+
+// The cache file name is the hash of everything that affects the cooked result: the source
+// hash, the geometry type, the cooking parameters and the PhysX version. Files with the same
+// name in different directories therefore get separate entries and a changed source, cooking
+// setup or SDK simply maps to a new entry instead of overwriting or invalidating an old one.
+static QString getCachedFilename(const QString &filePath, CacheGeometry geom,
+                                 const QCookingParameters::Settings &settings)
 {
     const char *extension = "unknown_physx";
     switch (geom) {
@@ -31,45 +261,57 @@ static QString getCachedFilename(const QString &filePath, CacheGeometry geom)
         break;
     }
 
+    const QByteArray fileHash = sourceHash(filePath);
+    if (fileHash.isEmpty())
+        return QString();
+
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    addToHash(hash, CACHE_FORMAT_VERSION);
+    addToHash(hash, quint32(PX_PHYSICS_VERSION));
+    addToHash(hash, quint32(geom));
+    addCookingParamsToHash(hash, settings.cookingParams());
+    if (geom == CacheGeometry::ConvexMesh) {
+        physx::PxConvexMeshDesc convexDesc;
+        settings.applyToConvexDesc(convexDesc);
+        addToHash(hash, quint32(convexDesc.flags));
+        addToHash(hash, convexDesc.vertexLimit);
+        addToHash(hash, convexDesc.quantizedCount);
+    }
+    hash.addData(fileHash);
+
     return QString::fromUtf8("%1/%2.%3")
-            .arg(MESH_CACHE_PATH, QFileInfo(filePath).fileName(), QLatin1StringView(extension));
+            .arg(cachePath(), QString::fromLatin1(hash.result().toHex()),
+                 QLatin1StringView(extension));
 }
 
 static void readCachedMesh(const QString &meshFilename, physx::PxPhysics &physics,
                            physx::PxTriangleMesh *&triangleMesh, physx::PxConvexMesh *&convexMesh,
-                           physx::PxHeightField *&heightField, CacheGeometry geom)
+                           physx::PxHeightField *&heightField, CacheGeometry geom,
+                           const QCookingParameters::Settings &settings)
 {
-    if (MESH_CACHE_PATH.isEmpty())
+    if (cachePath().isEmpty())
+        return;
+
+    Q_TRACE_SCOPE(QCacheUtils_readCachedMesh, meshFilename);
+    const QString cacheFilename = getCachedFilename(meshFilename, geom, settings);
+    if (cacheFilename.isEmpty())
         return;
 
-    QString cacheFilename = getCachedFilename(meshFilename, geom);
     QFile cacheFile(cacheFilename);
-    QFile meshFile(meshFilename);
     uchar *cacheData = nullptr;
-    uchar *meshData = nullptr;
 
     auto cleanup = qScopeGuard([&] {
         if (cacheData)
             cacheFile.unmap(cacheData);
-        if (meshData)
-            meshFile.unmap(meshData);
         if (cacheFile.isOpen())
             cacheFile.close();
-        if (meshFile.isOpen())
-            meshFile.close();
     });
 
-    if (!cacheFile.open(QIODevice::ReadOnly)) {
-        return;
-    }
-    if (!meshFile.open(QIODevice::ReadOnly)) {
-        qWarning() << "Could not open" << meshFilename;
+    if (!cacheFile.open(QIODevice::ReadOnly))
         return;
-    }
 
-    // first uint64 (8 bytes) is hash of input file
-    if (cacheFile.size() <= qint64(sizeof(uint64_t))) {
-        qWarning() << "Invalid convex mesh from file" << cacheFilename;
+    if (cacheFile.size() == 0) {
+        qWarning() << "Invalid cached mesh in file" << cacheFilename;
         return;
     }
 
@@ -78,20 +320,8 @@ static void readCachedMesh(const QString &meshFilename, physx::PxPhysics &physic
         qWarning() << "Could not map" << cacheFilename;
         return;
     }
-    uint64_t cacheHash = *reinterpret_cast<uint64_t *>(cacheData);
 
-    meshData = meshFile.map(0, meshFile.size());
-    if (!meshData) {
-        qWarning() << "Could not map" << meshFilename;
-        return;
-    }
-    uint64_t meshHash = qHash(QByteArrayView(meshData, meshFile.size()));
-
-    if (cacheHash != meshHash)
-        return; // hash is different, need to re-cook
-
-    physx::PxDefaultMemoryInputData input(cacheData + sizeof(uint64_t),
-                                          physx::PxU32(cacheFile.size() - sizeof(uint64_t)));
+    physx::PxDefaultMemoryInputData input(cacheData, physx::PxU32(cacheFile.size()));
 
     switch (geom) {
     case CacheGeometry::TriangleMesh: {
@@ -115,92 +345,255 @@ static void readCachedMesh(const QString &meshFilename, physx::PxPhysics &physic
 }
 
 static void writeCachedMesh(const QString &meshFilename, physx::PxDefaultMemoryOutputStream &buf,
-                            CacheGeometry geom)
+                            CacheGeometry geom, const QCookingParameters::Settings &settings)
 {
-    if (MESH_CACHE_PATH.isEmpty())
+    if (cachePath().isEmpty())
         return;
 
-    QString cacheFilename = getCachedFilename(meshFilename, geom);
-    QFile cacheFile(cacheFilename);
-    QFile meshFile(meshFilename);
-    uchar *cacheData = nullptr;
-    uchar *meshData = nullptr;
-
-    auto cleanup = qScopeGuard([&] {
-        if (cacheData)
-            cacheFile.unmap(cacheData);
-        if (meshData)
-            meshFile.unmap(meshData);
-        if (cacheFile.isOpen())
-            cacheFile.close();
-        if (meshFile.isOpen())
-            meshFile.close();
-    });
+    const QString cacheFilename = getCachedFilename(meshFilename, geom, settings);
+    if (cacheFilename.isEmpty())
+        return;
 
+    // Write to a temporary file and rename so a reader never sees a partially written entry
+    QSaveFile cacheFile(cacheFilename);
     if (!cacheFile.open(QIODevice::WriteOnly)) {
-        qCWarning(lcQuick3dPhysics) << "Could not open" << cacheFile.fileName() << "for writing.";
-        return;
-    }
-    if (!meshFile.open(QIODevice::ReadOnly)) {
-        qWarning() << "Could not open" << meshFilename;
+        qCWarning(lcQuick3dPhysics) << "Could not open" << cacheFilename << "for writing.";
         return;
     }
 
-    meshData = meshFile.map(0, meshFile.size());
-    if (!meshData) {
-        qWarning() << "Could not map" << meshFilename;
+    cacheFile.write(reinterpret_cast<char *>(buf.getData()), buf.getSize());
+    if (!cacheFile.commit()) {
+        qCWarning(lcQuick3dPhysics) << "Could not write" << cacheFilename;
         return;
     }
-    uint64_t meshHash = qHash(QByteArrayView(meshData, meshFile.size()));
 
-    cacheFile.write(reinterpret_cast<char *>(&meshHash), sizeof(uint64_t));
-    cacheFile.write(reinterpret_cast<char *>(buf.getData()), buf.getSize());
-    cacheFile.close();
+    qCDebug(lcQuick3dPhysics) << "Wrote" << buf.getSize() << "bytes to" << cacheFilename;
+}
 
-    qCDebug(lcQuick3dPhysics) << "Wrote" << cacheFile.size() << "bytes to" << cacheFile.fileName();
+QByteArray readCachedData(const QString &filePath, CacheGeometry geom,
+                          const QCookingParameters::Settings &settings)
+{
+    if (cachePath().isEmpty())
+        return QByteArray();
+
+    Q_TRACE_SCOPE(QCacheUtils_readCachedData, filePath);
+    const QString cacheFilename = getCachedFilename(filePath, geom, settings);
+    if (cacheFilename.isEmpty())
+        return QByteArray();
+
+    QFile cacheFile(cacheFilename);
+    if (!cacheFile.open(QIODevice::ReadOnly))
+        return QByteArray();
+
+    qCDebug(lcQuick3dPhysics) << "Read" << cacheFile.size() << "bytes from" << cacheFilename;
+    return cacheFile.readAll();
 }
 
-void writeCachedTriangleMesh(const QString &filePath, physx::PxDefaultMemoryOutputStream &buf)
+void writeCachedTriangleMesh(const QString &filePath, physx::PxDefaultMemoryOutputStream &buf,
+                             const QCookingParameters::Settings &settings)
 {
-    writeCachedMesh(filePath, buf, CacheGeometry::TriangleMesh);
+    writeCachedMesh(filePath, buf, CacheGeometry::TriangleMesh, settings);
 }
 
-void writeCachedConvexMesh(const QString &filePath, physx::PxDefaultMemoryOutputStream &buf)
+void writeCachedConvexMesh(const QString &filePath, physx::PxDefaultMemoryOutputStream &buf,
+                           const QCookingParameters::Settings &settings)
 {
-    writeCachedMesh(filePath, buf, CacheGeometry::ConvexMesh);
+    writeCachedMesh(filePath, buf, CacheGeometry::ConvexMesh, settings);
 }
 
 void writeCachedHeightField(const QString &filePath, physx::PxDefaultMemoryOutputStream &buf)
 {
-    writeCachedMesh(filePath, buf, CacheGeometry::HeightField);
+    writeCachedMesh(filePath, buf, CacheGeometry::HeightField, QCookingParameters::Settings());
+}
+
+// Memory block that the objects deserialized from one PhysX binary collection live in. PhysX does
+// not own this memory, so it is freed once every object handed out from it has been released.
+struct SerializedBlock
+{
+    std::unique_ptr<QFile> file; // Owns the mapping when the block is a mapped file
+    void *alignedData = nullptr; // Set when the data had to be copied
+    QList<physx::PxBase *> otherObjects; // Objects of the collection that were not handed out
+    int users = 0; // Handed out objects that have not been released yet
+};
+// The deserialized objects that were handed out and the blocks they live in
+static QHash<physx::PxBase *, std::shared_ptr<SerializedBlock>> serializedObjects;
+// Handed out objects whose owners released them while PhysX shapes still used them
+static QList<physx::PxBase *> releasedSerializedObjects;
+
+bool isSerializedCollection(QByteArrayView header)
+{
+    return header.startsWith("SEBD");
+}
+
+static physx::PxU32 referenceCount(physx::PxBase *object)
+{
+    if (auto *triangleMesh = object->is<physx::PxTriangleMesh>())
+        return triangleMesh->getReferenceCount();
+    if (auto *convexMesh = object->is<physx::PxConvexMesh>())
+        return convexMesh->getReferenceCount();
+    if (auto *heightField = object->is<physx::PxHeightField>())
+        return heightField->getReferenceCount();
+    return 1;
+}
+
+static void freeSerializedBlock(SerializedBlock &block)
+{
+    for (physx::PxBase *object : std::as_const(block.otherObjects)) {
+        if (object->isReleasable())
+            object->release();
+    }
+    block.otherObjects.clear();
+    qFreeAligned(block.alignedData);
+    block.alignedData = nullptr;
+    block.file.reset();
+}
+
+static physx::PxBase *readSerializedCollection(std::unique_ptr<QFile> file,
+                                               physx::PxPhysics &physics, CacheGeometry geom)
+{
+    const QString fileName = file->fileName();
+    const qint64 size = file->size();
+    auto block = std::make_shared<SerializedBlock>();
+    void *data = nullptr;
+
+    // Deserializing patches the pointers in the block, so the memory has to be writable. A
+    // private mapping is copy-on-write, which leaves the bulk of the mesh data shared with the
+    // page cache. Resources are read-only and are copied once into an aligned block instead.
+    const bool isResource = fileName.startsWith(u':');
+    if (!isResource)
+        data = file->map(0, size, QFileDevice::MapPrivateOption);
+
+    if (data && (quintptr(data) & (PX_SERIAL_FILE_ALIGN - 1)) == 0) {
+        block->file = std::move(file);
+    } else {
+        if (data)
+            file->unmap(static_cast<uchar *>(data));
+        data = qMallocAligned(size_t(size), PX_SERIAL_FILE_ALIGN);
+        if (!data || !file->seek(0)
+            || file->read(static_cast<char *>(data), size) != size) {
+            qWarning() << "Could not read" << fileName;
+            qFreeAligned(data);
+            return nullptr;
+        }
+        block->alignedData = data;
+    }
+
+    auto *registry = physx::PxSerialization::createSerializationRegistry(physics);
+    auto *collection = physx::PxSerialization::createCollectionFromBinary(data, *registry);
+    registry->release();
+
+    if (!collection) {
+        qWarning() << "Could not deserialize" << fileName;
+        qFreeAligned(block->alignedData);
+        return nullptr;
+    }
+
+    physx::PxBase *result = nullptr;
+    for (physx::PxU32 i = 0; i < collection->getNbObjects(); i++) {
+        physx::PxBase &object = collection->getObject(i);
+        physx::PxBase *match = nullptr;
+        switch (geom) {
+        case CacheGeometry::TriangleMesh:
+            match = object.is<physx::PxTriangleMesh>();
+            break;
+        case CacheGeometry::ConvexMesh:
+            match = object.is<physx::PxConvexMesh>();
+            break;
+        case CacheGeometry::HeightField:
+            match = object.is<physx::PxHeightField>();
+            break;
+        }
+        if (match && !result)
+            result = match;
+        else
+            block->otherObjects.append(&object);
+    }
+    // Releases the collection but not the objects in it
+    collection->release();
+
+    if (!result) {
+        freeSerializedBlock(*block);
+        return nullptr;
+    }
+
+    block->users++;
+    serializedObjects.insert(result, std::move(block));
+    return result;
+}
+
+void releaseObject(physx::PxBase *object)
+{
+    if (object == nullptr)
+        return;
+    if (!serializedObjects.contains(object)) {
+        object->release();
+        return;
+    }
+
+    // The block can only be freed once the shapes using the object have released it as well
+    releasedSerializedObjects.append(object);
+    releaseUnusedSerializedData();
+}
+
+void releaseUnusedSerializedData()
+{
+    releasedSerializedObjects.removeIf([](physx::PxBase *object) {
+        if (referenceCount(object) > 1)
+            return false;
+        const std::shared_ptr<SerializedBlock> block = serializedObjects.take(object);
+        object->release();
+        if (--block->users == 0)
+            freeSerializedBlock(*block);
+        return true;
+    });
+}
+
+void releaseSerializedData()
+{
+    // Releasing PxPhysics has released the objects, only the memory is left
+    for (const std::shared_ptr<SerializedBlock> &block : std::as_const(serializedObjects)) {
+        block->otherObjects.clear();
+        freeSerializedBlock(*block);
+    }
+    serializedObjects.clear();
+    releasedSerializedObjects.clear();
 }
 
 static void readCookedMesh(const QString &meshFilename, physx::PxPhysics &physics,
                            physx::PxTriangleMesh *&triangleMesh, physx::PxConvexMesh *&convexMesh,
                            physx::PxHeightField *&heightField, CacheGeometry geom)
 {
-    QFile file(meshFilename);
+    Q_TRACE_SCOPE(QCacheUtils_readCookedMesh, meshFilename);
+    auto file = std::make_unique<QFile>(meshFilename);
     uchar *data = nullptr;
 
-    auto cleanup = qScopeGuard([&] {
-        if (data)
-            file.unmap(data);
-        if (file.isOpen())
-            file.close();
-    });
-
-    if (!file.open(QIODevice::ReadOnly)) {
+    if (!file->open(QIODevice::ReadOnly)) {
         qWarning() << "Could not open" << meshFilename;
         return;
     }
 
-    data = file.map(0, file.size());
+    if (isSerializedCollection(file->peek(4))) {
+        physx::PxBase *object = readSerializedCollection(std::move(file), physics, geom);
+        if (object) {
+            triangleMesh = object->is<physx::PxTriangleMesh>();
+            convexMesh = object->is<physx::PxConvexMesh>();
+            heightField = object->is<physx::PxHeightField>();
+        }
+        return;
+    }
+
+    auto cleanup = qScopeGuard([&] {
+        if (data)
+            file->unmap(data);
+    });
+
+    data = file->map(0, file->size());
     if (!data) {
         qWarning() << "Could not map" << meshFilename;
         return;
     }
 
-    physx::PxDefaultMemoryInputData input(data, physx::PxU32(file.size()));
+    physx::PxDefaultMemoryInputData input(data, physx::PxU32(file->size()));
 
     switch (geom) {
     case CacheGeometry::TriangleMesh: {
@@ -217,23 +610,25 @@ static void readCookedMesh(const QString &meshFilename, physx::PxPhysics &physic
     }
 }
 
-physx::PxTriangleMesh *readCachedTriangleMesh(const QString &filePath, physx::PxPhysics &physics)
+physx::PxTriangleMesh *readCachedTriangleMesh(const QString &filePath, physx::PxPhysics &physics,
+                                              const QCookingParameters::Settings &settings)
 {
     physx::PxTriangleMesh *triangleMesh = nullptr;
     physx::PxConvexMesh *convexMesh = nullptr;
     physx::PxHeightField *heightField = nullptr;
     readCachedMesh(filePath, physics, triangleMesh, convexMesh, heightField,
-                   CacheGeometry::TriangleMesh);
+                   CacheGeometry::TriangleMesh, settings);
     return triangleMesh;
 }
 
-physx::PxConvexMesh *readCachedConvexMesh(const QString &filePath, physx::PxPhysics &physics)
+physx::PxConvexMesh *readCachedConvexMesh(const QString &filePath, physx::PxPhysics &physics,
+                                          const QCookingParameters::Settings &settings)
 {
     physx::PxTriangleMesh *triangleMesh = nullptr;
     physx::PxConvexMesh *convexMesh = nullptr;
     physx::PxHeightField *heightField = nullptr;
     readCachedMesh(filePath, physics, triangleMesh, convexMesh, heightField,
-                   CacheGeometry::ConvexMesh);
+                   CacheGeometry::ConvexMesh, settings);
     return convexMesh;
 }
 
@@ -243,7 +638,7 @@ physx::PxHeightField *readCachedHeightField(const QString &filePath, physx::PxPh
     physx::PxConvexMesh *convexMesh = nullptr;
     physx::PxHeightField *heightField = nullptr;
     readCachedMesh(filePath, physics, triangleMesh, convexMesh, heightField,
-                   CacheGeometry::HeightField);
+                   CacheGeometry::HeightField, QCookingParameters::Settings());
     return heightField;
 }
 
@@ -16,9 +16,14 @@
 //
 
 #include <QtCore/qtconfigmacros.h>
+#include <QtCore/QByteArray>
+#include <QtCore/QByteArrayView>
+#include <QtCore/QHash>
 #include <QtCore/QString>
+#include <QtQuick3DPhysics/private/qcookingparameters_p.h>
 
 namespace physx {
+class PxBase;
 class PxDefaultMemoryOutputStream;
 class PxTriangleMesh;
 class PxConvexMesh;
@@ -28,17 +33,58 @@ class PxHeightField;
 
 QT_BEGIN_NAMESPACE
 namespace QCacheUtils {
-void writeCachedTriangleMesh(const QString &filePath, physx::PxDefaultMemoryOutputStream &buf);
-void writeCachedConvexMesh(const QString &filePath, physx::PxDefaultMemoryOutputStream &buf);
+enum class CacheGeometry { TriangleMesh, ConvexMesh, HeightField };
+
+// The cache entries of meshes depend on the cooking settings they were cooked with
+void writeCachedTriangleMesh(const QString &filePath, physx::PxDefaultMemoryOutputStream &buf,
+                             const QCookingParameters::Settings &settings = {});
+void writeCachedConvexMesh(const QString &filePath, physx::PxDefaultMemoryOutputStream &buf,
+                           const QCookingParameters::Settings &settings = {});
 void writeCachedHeightField(const QString &filePath, physx::PxDefaultMemoryOutputStream &buf);
 
 physx::PxTriangleMesh *readCookedTriangleMesh(const QString &filePath, physx::PxPhysics &physics);
 physx::PxConvexMesh *readCookedConvexMesh(const QString &filePath, physx::PxPhysics &physics);
 physx::PxHeightField *readCookedHeightField(const QString &filePath, physx::PxPhysics &physics);
 
-physx::PxTriangleMesh *readCachedTriangleMesh(const QString &filePath, physx::PxPhysics &physics);
-physx::PxConvexMesh *readCachedConvexMesh(const QString &filePath, physx::PxPhysics &physics);
+physx::PxTriangleMesh *readCachedTriangleMesh(const QString &filePath, physx::PxPhysics &physics,
+                                              const QCookingParameters::Settings &settings = {});
+physx::PxConvexMesh *readCachedConvexMesh(const QString &filePath, physx::PxPhysics &physics,
+                                          const QCookingParameters::Settings &settings = {});
 physx::PxHeightField *readCachedHeightField(const QString &filePath, physx::PxPhysics &physics);
+
+// Files written with the cooker's --serialize option are PhysX binary collections. The returned
+// objects are deserialized in place from a mapping of the file.
+bool isSerializedCollection(QByteArrayView header);
+// Releases a mesh or height field returned by the functions above. A deserialized object, the
+// rest of its collection and its memory are released once no PhysX shape uses it anymore.
+void releaseObject(physx::PxBase *object);
+// Releases the deserialized objects that PhysX shapes stopped using since they were released
+void releaseUnusedSerializedData();
+// Frees the memory of deserialized objects, must only be called after PxPhysics was released
+void releaseSerializedData();
+// Writes the index of the source file hashes if hashes were added since it was last written
+Q_QUICK3DPHYSICS_EXPORT void saveCacheIndex();
+
+// An entry of the index.json file in the cache directory that records the hash of a source file
+struct CacheIndexEntry
+{
+    qint64 size = -1;
+    qint64 lastModified = -1; // In milliseconds since the epoch, UTC
+    QByteArray hash; // SHA-256 of the file contents
+};
+
+// Returns the key of a source file in the cache index. Resource files are keyed by their resource
+// path, local files by their path relative to root unless they are outside of it.
+Q_QUICK3DPHYSICS_EXPORT QString cacheIndexKey(const QString &filePath, const QString &root);
+// Writes a cache index in the format that is read from the cache directory
+Q_QUICK3DPHYSICS_EXPORT bool writeCacheIndex(const QString &indexPath,
+                                             const QHash<QString, CacheIndexEntry> &index);
+// Returns the SHA-256 of a source file, only reading the file if the index has no matching entry
+Q_QUICK3DPHYSICS_EXPORT QByteArray sourceHash(const QString &filePath);
+
+// Returns the cached cooked data without creating any PhysX object, safe to call from any thread
+QByteArray readCachedData(const QString &filePath, CacheGeometry geom,
+                          const QCookingParameters::Settings &settings = {});
 }
 QT_END_NAMESPACE
 
@@ -3,6 +3,8 @@
 
 #include "qcollisiondebugmeshbuilder_p.h"
 
+#include <QtGui/QMatrix4x4>
+
 QT_BEGIN_NAMESPACE
 
 QCollisionDebugMeshBuilder::QCollisionDebugMeshBuilder() { }
@@ -25,10 +27,11 @@ QByteArray QCollisionDebugMeshBuilder::generateVertexArray()
 {
     QByteArray output;
     const int size = m_normals.count();
-    output.resize(4 * 4 * sizeof(float) * size);
+    output.resize(2 * vertexStride * size);
 
     float *data = reinterpret_cast<float *>(output.data());
 
+    // Each vertex is a position with w = 1 followed by the normal with w = 0
     for (int i = 0; i < size; ++i) {
         const QVector3D &start = m_vertices[i * 2];
         const QVector3D &end = m_vertices[i * 2 + 1];
@@ -37,23 +40,23 @@ QByteArray QCollisionDebugMeshBuilder::generateVertexArray()
         data[0] = start.x();
         data[1] = start.y();
         data[2] = start.z();
-        data[4] = 1.0f;
+        data[3] = 1.0f;
 
-        data[5] = normal.x();
-        data[6] = normal.y();
-        data[7] = normal.z();
-        data[8] = 0.0f;
+        data[4] = normal.x();
+        data[5] = normal.y();
+        data[6] = normal.z();
+        data[7] = 0.0f;
 
         data += 8;
         data[0] = end.x();
         data[1] = end.y();
         data[2] = end.z();
-        data[4] = 1.0f;
+        data[3] = 1.0f;
 
-        data[5] = normal.x();
-        data[6] = normal.y();
-        data[7] = normal.z();
-        data[8] = 0.0f;
+        data[4] = normal.x();
+        data[5] = normal.y();
+        data[6] = normal.z();
+        data[7] = 0.0f;
 
         data += 8;
     }
@@ -61,4 +64,27 @@ QByteArray QCollisionDebugMeshBuilder::generateVertexArray()
     return output;
 }
 
+void QCollisionDebugMeshBuilder::appendTransformed(QByteArray &output,
+                                                   const QByteArray &vertexArray,
+                                                   const QMatrix4x4 &transform,
+                                                   QVector3D &boundsMin, QVector3D &boundsMax)
+{
+    const qsizetype offset = output.size();
+    output.append(vertexArray);
+
+    // The debug materials are unlit so the normals are copied as they are
+    float *data = reinterpret_cast<float *>(output.data() + offset);
+    const qsizetype count = vertexArray.size() / vertexStride;
+    for (qsizetype i = 0; i < count; ++i, data += 8) {
+        const QVector3D position = transform.map(QVector3D(data[0], data[1], data[2]));
+        data[0] = position.x();
+        data[1] = position.y();
+        data[2] = position.z();
+        boundsMin = QVector3D(qMin(boundsMin.x(), position.x()), qMin(boundsMin.y(), position.y()),
+                              qMin(boundsMin.z(), position.z()));
+        boundsMax = QVector3D(qMax(boundsMax.x(), position.x()), qMax(boundsMax.y(), position.y()),
+                              qMax(boundsMax.z(), position.z()));
+    }
+}
+
 QT_END_NAMESPACE
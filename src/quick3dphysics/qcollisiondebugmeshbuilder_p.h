@@ -15,9 +15,12 @@
 // We mean it.
 //
 
+#include <QtCore/QByteArray>
 #include <QtCore/QVector>
 #include <QtGui/QVector3D>
 
+class QMatrix4x4;
+
 QT_BEGIN_NAMESPACE
 
 class QCollisionDebugMeshBuilder
@@ -32,6 +35,15 @@ public:
 
     QByteArray generateVertexArray();
 
+    // Size of one vertex in the arrays generated by generateVertexArray
+    static constexpr int vertexStride = 8 * sizeof(float);
+
+    // Appends the vertices of a generated vertex array to output with the positions transformed,
+    // and grows the bounds to include them
+    static void appendTransformed(QByteArray &output, const QByteArray &vertexArray,
+                                  const QMatrix4x4 &transform, QVector3D &boundsMin,
+                                  QVector3D &boundsMax);
+
 private:
     QVector<QVector3D> m_vertices;
     QVector<QVector3D> m_normals;
@@ -46,6 +46,53 @@ QT_BEGIN_NAMESPACE
     \since 6.7
 */
 
+/*!
+    \qmlproperty bool ConvexMeshShape::asynchronous
+    \since 6.9
+
+    This property holds whether the mesh is cooked on a background thread. While the mesh is
+    cooking, the shape has no collision geometry unless
+    \l{ConvexMeshShape::}{boundingBoxPlaceholder} is set, and \l{ConvexMeshShape::}{ready} is \c false.
+    When cooking finishes, the shapes of the bodies using it are rebuilt.
+
+    Default value: \c false
+*/
+
+/*!
+    \qmlproperty bool ConvexMeshShape::boundingBoxPlaceholder
+    \since 6.9
+
+    This property holds whether a box with the size of the mesh bounds is used as the collision
+    geometry while the mesh is being cooked in the background. The box is centered on the shape.
+    Only used when \l{ConvexMeshShape::}{asynchronous} is \c true.
+
+    Default value: \c false
+*/
+
+/*!
+    \qmlproperty bool ConvexMeshShape::ready
+    \since 6.9
+    \readonly
+
+    This property holds whether the mesh geometry is available. It is \c false while the mesh is
+    being cooked in the background.
+*/
+
+/*!
+    \qmlproperty CookingParameters ConvexMeshShape::cookingParameters
+    \since 6.9
+
+    This property holds the parameters used when cooking the mesh of this shape. If it is not
+    set, the \l{PhysicsWorld::}{cookingParameters} of the physics world are used, and if
+    those are not set either, the default parameters. The vertex limit and quantization
+    settings only apply to convex meshes.
+
+    Changing the parameters cooks the mesh again. Meshes loaded from
+    \l{Qt Quick 3D Physics Cooking}{precooked files} are used as they are.
+
+    Default value: \c null
+*/
+
 QMeshShape::MeshType QConvexMeshShape::shapeType() const
 {
     return QMeshShape::MeshType::CONVEX;
@@ -0,0 +1,383 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "qcookingparameters_p.h"
+
+#include "PxPhysicsVersion.h"
+#include "cooking/PxConvexMeshDesc.h"
+#include "cooking/PxCooking.h"
+
+#include "qstaticphysxobjects_p.h"
+
+#include <QtCore/QMutex>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \qmltype CookingParameters
+    \inqmlmodule QtQuick3D.Physics
+    \since 6.9
+    \brief Controls how meshes are cooked.
+
+    Before a ConvexMeshShape or TriangleMeshShape can be used, its mesh is cooked into a format
+    that PhysX can use efficiently. CookingParameters configures this step, trading off how fast
+    a mesh is cooked against how fast collisions with it can be queried and how much memory it
+    uses.
+
+    The parameters are set on a \l PhysicsWorld, where they apply to all mesh shapes of that world,
+    or on a single \l{MeshShape::cookingParameters}{mesh shape}, which overrides the world
+    parameters. For example, procedurally generated geometry that changes often can be cooked
+    quickly while static level geometry is cooked for the fastest queries:
+
+    \qml
+    TriangleMeshShape {
+        geometry: generatedTerrain
+        cookingParameters: CookingParameters {
+            meshCookingHint: CookingParameters.CookingPerformance
+            precomputeActiveEdges: false
+        }
+    }
+    \endqml
+
+    The parameters are part of the key of the \l{Qt Quick 3D Physics Cooking}{cooking cache}. They
+    are ignored for files that were cooked in advance with the cooker tool.
+
+    \note Changing the parameters of a world only affects meshes that are cooked afterwards.
+*/
+
+/*!
+    \qmlproperty enumeration CookingParameters::midPhase
+    This property defines the acceleration structure used for triangle meshes.
+
+    \value CookingParameters.BVH33
+        The default structure. It is tuned with \l meshCookingHint and
+        \l meshSizePerformanceTradeOff.
+    \value CookingParameters.BVH34
+        A structure that is usually faster to cook and to query and uses less memory. It is tuned
+        with \l primitivesPerLeaf.
+
+    Default value: \c CookingParameters.BVH33
+*/
+
+/*!
+    \qmlproperty enumeration CookingParameters::meshCookingHint
+    This property defines whether the cooking of a \c BVH33 triangle mesh optimizes for query
+    performance or for cooking speed.
+
+    \value CookingParameters.SimulationPerformance
+        The mesh is slower to cook but faster to query.
+    \value CookingParameters.CookingPerformance
+        The mesh is faster to cook but slower to query.
+
+    Default value: \c CookingParameters.SimulationPerformance
+*/
+
+/*!
+    \qmlproperty float CookingParameters::meshSizePerformanceTradeOff
+    This property defines the trade-off between the memory used by a \c BVH33 triangle mesh and
+    its query performance. Lower values use less memory, higher values give faster queries.
+
+    Default value: \c 0.55
+
+    Range: \c{[0, 1]}
+*/
+
+/*!
+    \qmlproperty int CookingParameters::primitivesPerLeaf
+    This property defines the number of triangles per leaf of a \c BVH34 triangle mesh. Fewer
+    triangles per leaf give faster queries, more triangles per leaf use less memory.
+
+    Default value: \c 4
+
+    Range: \c{[4, 15]}
+*/
+
+/*!
+    \qmlproperty bool CookingParameters::precomputeActiveEdges
+    This property defines whether the edges of a triangle mesh that can produce contacts are
+    computed during cooking. Disabling it makes cooking faster, but contact generation against
+    the mesh can become slower and less robust.
+
+    Default value: \c true
+*/
+
+/*!
+    \qmlproperty bool CookingParameters::cleanMesh
+    This property defines whether triangle meshes are cleaned during cooking, removing duplicate
+    vertices and degenerate triangles. Disabling it makes cooking faster but the mesh must then
+    already be clean, otherwise collisions with it are undefined.
+
+    Default value: \c true
+*/
+
+/*!
+    \qmlproperty float CookingParameters::weldTolerance
+    This property defines the distance within which vertices of a triangle mesh are welded
+    together while cleaning. A value of \c 0 disables welding. Welding requires \l cleanMesh.
+
+    Default value: \c 0
+
+    Range: \c{[0, inf]}
+*/
+
+/*!
+    \qmlproperty bool CookingParameters::buildGPUData
+    This property defines whether the data for GPU accelerated simulation is cooked. Qt Quick 3D
+    Physics simulates on the CPU, so enabling it only makes cooking slower and meshes bigger.
+
+    Default value: \c false
+*/
+
+/*!
+    \qmlproperty int CookingParameters::convexVertexLimit
+    This property defines the maximum number of vertices of the hull of a convex mesh. Hulls with
+    fewer vertices are faster to collide with but approximate the mesh less closely.
+
+    Default value: \c 255
+
+    Range: \c{[8, 255]}
+*/
+
+/*!
+    \qmlproperty int CookingParameters::convexQuantizedCount
+    This property defines the number of vertices the input of a convex mesh is quantized to before
+    computing its hull. This speeds up cooking of meshes with many vertices. A value of \c 0
+    disables quantization.
+
+    Default value: \c 0
+
+    Range: \c 0 or \c{[4, 65535]}
+*/
+
+bool QCookingParameters::Settings::operator==(const Settings &other) const
+{
+    return midPhase == other.midPhase && meshCookingHint == other.meshCookingHint
+            && meshSizePerformanceTradeOff == other.meshSizePerformanceTradeOff
+            && primitivesPerLeaf == other.primitivesPerLeaf
+            && precomputeActiveEdges == other.precomputeActiveEdges
+            && cleanMesh == other.cleanMesh && weldTolerance == other.weldTolerance
+            && buildGPUData == other.buildGPUData && convexVertexLimit == other.convexVertexLimit
+            && convexQuantizedCount == other.convexQuantizedCount;
+}
+
+physx::PxCookingParams QCookingParameters::Settings::cookingParams() const
+{
+    // Same scale as the shared cooking object, see QPhysXWorld::createWorld()
+    physx::PxCookingParams params = physx::PxCookingParams(physx::PxTolerancesScale());
+
+    if (midPhase == MidPhase::BVH34) {
+        params.midphaseDesc.setToDefault(physx::PxMeshMidPhase::eBVH34);
+        params.midphaseDesc.mBVH34Desc.numPrimsPerLeaf = physx::PxU32(primitivesPerLeaf);
+    } else {
+        params.midphaseDesc.setToDefault(physx::PxMeshMidPhase::eBVH33);
+        params.midphaseDesc.mBVH33Desc.meshSizePerformanceTradeOff = meshSizePerformanceTradeOff;
+        params.midphaseDesc.mBVH33Desc.meshCookingHint =
+                meshCookingHint == MeshCookingHint::CookingPerformance
+                ? physx::PxMeshCookingHint::eCOOKING_PERFORMANCE
+                : physx::PxMeshCookingHint::eSIM_PERFORMANCE;
+    }
+
+    using PreprocessingFlag = physx::PxMeshPreprocessingFlag;
+    if (!precomputeActiveEdges)
+        params.meshPreprocessParams |= PreprocessingFlag::eDISABLE_ACTIVE_EDGES_PRECOMPUTE;
+    if (!cleanMesh)
+        params.meshPreprocessParams |= PreprocessingFlag::eDISABLE_CLEAN_MESH;
+    if (weldTolerance > 0.f) {
+        params.meshPreprocessParams |= PreprocessingFlag::eWELD_VERTICES;
+        params.meshWeldTolerance = weldTolerance;
+    }
+    params.buildGPUData = buildGPUData;
+
+    return params;
+}
+
+void QCookingParameters::Settings::applyToConvexDesc(physx::PxConvexMeshDesc &desc) const
+{
+    desc.vertexLimit = physx::PxU16(convexVertexLimit);
+    if (convexQuantizedCount > 0) {
+        desc.flags |= physx::PxConvexFlag::eQUANTIZE_INPUT;
+        desc.quantizedCount = physx::PxU16(convexQuantizedCount);
+    }
+}
+
+// Creating a cooking object is not free, so there is one per distinct set of settings in use
+static QMutex customCookingsMutex;
+static QList<std::pair<QCookingParameters::Settings, physx::PxCooking *>> customCookings;
+
+physx::PxCooking *QCookingParameters::Settings::cooking() const
+{
+    const auto &s_physx = StaticPhysXObjects::getReference();
+    if (isDefault())
+        return s_physx.cooking;
+
+    QMutexLocker locker(&customCookingsMutex);
+    for (const auto &entry : std::as_const(customCookings)) {
+        if (entry.first == *this)
+            return entry.second;
+    }
+
+    if (s_physx.foundation == nullptr)
+        return nullptr;
+    auto *customCooking =
+            PxCreateCooking(PX_PHYSICS_VERSION, *s_physx.foundation, cookingParams());
+    if (customCooking)
+        customCookings.append({ *this, customCooking });
+    return customCooking;
+}
+
+void QCookingParameters::releaseCookings()
+{
+    QMutexLocker locker(&customCookingsMutex);
+    for (const auto &entry : std::as_const(customCookings))
+        entry.second->release();
+    customCookings.clear();
+}
+
+QCookingParameters::QCookingParameters(QObject *parent) : QObject(parent) { }
+
+QCookingParameters::MidPhase QCookingParameters::midPhase() const
+{
+    return m_settings.midPhase;
+}
+
+void QCookingParameters::setMidPhase(MidPhase midPhase)
+{
+    if (m_settings.midPhase == midPhase)
+        return;
+    m_settings.midPhase = midPhase;
+    emit midPhaseChanged();
+    emit settingsChanged();
+}
+
+QCookingParameters::MeshCookingHint QCookingParameters::meshCookingHint() const
+{
+    return m_settings.meshCookingHint;
+}
+
+void QCookingParameters::setMeshCookingHint(MeshCookingHint meshCookingHint)
+{
+    if (m_settings.meshCookingHint == meshCookingHint)
+        return;
+    m_settings.meshCookingHint = meshCookingHint;
+    emit meshCookingHintChanged();
+    emit settingsChanged();
+}
+
+float QCookingParameters::meshSizePerformanceTradeOff() const
+{
+    return m_settings.meshSizePerformanceTradeOff;
+}
+
+void QCookingParameters::setMeshSizePerformanceTradeOff(float meshSizePerformanceTradeOff)
+{
+    meshSizePerformanceTradeOff = qBound(0.f, meshSizePerformanceTradeOff, 1.f);
+    if (qFuzzyCompare(m_settings.meshSizePerformanceTradeOff, meshSizePerformanceTradeOff))
+        return;
+    m_settings.meshSizePerformanceTradeOff = meshSizePerformanceTradeOff;
+    emit meshSizePerformanceTradeOffChanged();
+    emit settingsChanged();
+}
+
+int QCookingParameters::primitivesPerLeaf() const
+{
+    return m_settings.primitivesPerLeaf;
+}
+
+void QCookingParameters::setPrimitivesPerLeaf(int primitivesPerLeaf)
+{
+    primitivesPerLeaf = qBound(4, primitivesPerLeaf, 15);
+    if (m_settings.primitivesPerLeaf == primitivesPerLeaf)
+        return;
+    m_settings.primitivesPerLeaf = primitivesPerLeaf;
+    emit primitivesPerLeafChanged();
+    emit settingsChanged();
+}
+
+bool QCookingParameters::precomputeActiveEdges() const
+{
+    return m_settings.precomputeActiveEdges;
+}
+
+void QCookingParameters::setPrecomputeActiveEdges(bool precomputeActiveEdges)
+{
+    if (m_settings.precomputeActiveEdges == precomputeActiveEdges)
+        return;
+    m_settings.precomputeActiveEdges = precomputeActiveEdges;
+    emit precomputeActiveEdgesChanged();
+    emit settingsChanged();
+}
+
+bool QCookingParameters::cleanMesh() const
+{
+    return m_settings.cleanMesh;
+}
+
+void QCookingParameters::setCleanMesh(bool cleanMesh)
+{
+    if (m_settings.cleanMesh == cleanMesh)
+        return;
+    m_settings.cleanMesh = cleanMesh;
+    emit cleanMeshChanged();
+    emit settingsChanged();
+}
+
+float QCookingParameters::weldTolerance() const
+{
+    return m_settings.weldTolerance;
+}
+
+void QCookingParameters::setWeldTolerance(float weldTolerance)
+{
+    weldTolerance = qMax(0.f, weldTolerance);
+    if (qFuzzyCompare(m_settings.weldTolerance, weldTolerance))
+        return;
+    m_settings.weldTolerance = weldTolerance;
+    emit weldToleranceChanged();
+    emit settingsChanged();
+}
+
+bool QCookingParameters::buildGPUData() const
+{
+    return m_settings.buildGPUData;
+}
+
+void QCookingParameters::setBuildGPUData(bool buildGPUData)
+{
+    if (m_settings.buildGPUData == buildGPUData)
+        return;
+    m_settings.buildGPUData = buildGPUData;
+    emit buildGPUDataChanged();
+    emit settingsChanged();
+}
+
+int QCookingParameters::convexVertexLimit() const
+{
+    return m_settings.convexVertexLimit;
+}
+
+void QCookingParameters::setConvexVertexLimit(int convexVertexLimit)
+{
+    convexVertexLimit = qBound(8, convexVertexLimit, 255);
+    if (m_settings.convexVertexLimit == convexVertexLimit)
+        return;
+    m_settings.convexVertexLimit = convexVertexLimit;
+    emit convexVertexLimitChanged();
+    emit settingsChanged();
+}
+
+int QCookingParameters::convexQuantizedCount() const
+{
+    return m_settings.convexQuantizedCount;
+}
+
+void QCookingParameters::setConvexQuantizedCount(int convexQuantizedCount)
+{
+    convexQuantizedCount = convexQuantizedCount <= 0 ? 0 : qBound(4, convexQuantizedCount, 0xffff);
+    if (m_settings.convexQuantizedCount == convexQuantizedCount)
+        return;
+    m_settings.convexQuantizedCount = convexQuantizedCount;
+    emit convexQuantizedCountChanged();
+    emit settingsChanged();
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,143 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#ifndef QCOOKINGPARAMETERS_H
+#define QCOOKINGPARAMETERS_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuick3DPhysics/qtquick3dphysicsglobal.h>
+#include <QtQml/QQmlEngine>
+
+namespace physx {
+class PxCooking;
+struct PxCookingParams;
+class PxConvexMeshDesc;
+}
+
+QT_BEGIN_NAMESPACE
+
+class Q_QUICK3DPHYSICS_EXPORT QCookingParameters : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(MidPhase midPhase READ midPhase WRITE setMidPhase NOTIFY midPhaseChanged)
+    Q_PROPERTY(MeshCookingHint meshCookingHint READ meshCookingHint WRITE setMeshCookingHint
+                       NOTIFY meshCookingHintChanged)
+    Q_PROPERTY(float meshSizePerformanceTradeOff READ meshSizePerformanceTradeOff WRITE
+                       setMeshSizePerformanceTradeOff NOTIFY meshSizePerformanceTradeOffChanged)
+    Q_PROPERTY(int primitivesPerLeaf READ primitivesPerLeaf WRITE setPrimitivesPerLeaf NOTIFY
+                       primitivesPerLeafChanged)
+    Q_PROPERTY(bool precomputeActiveEdges READ precomputeActiveEdges WRITE
+                       setPrecomputeActiveEdges NOTIFY precomputeActiveEdgesChanged)
+    Q_PROPERTY(bool cleanMesh READ cleanMesh WRITE setCleanMesh NOTIFY cleanMeshChanged)
+    Q_PROPERTY(float weldTolerance READ weldTolerance WRITE setWeldTolerance NOTIFY
+                       weldToleranceChanged)
+    Q_PROPERTY(bool buildGPUData READ buildGPUData WRITE setBuildGPUData NOTIFY
+                       buildGPUDataChanged)
+    Q_PROPERTY(int convexVertexLimit READ convexVertexLimit WRITE setConvexVertexLimit NOTIFY
+                       convexVertexLimitChanged)
+    Q_PROPERTY(int convexQuantizedCount READ convexQuantizedCount WRITE setConvexQuantizedCount
+                       NOTIFY convexQuantizedCountChanged)
+    QML_NAMED_ELEMENT(CookingParameters)
+    QML_ADDED_IN_VERSION(6, 9)
+
+public:
+    enum class MidPhase { BVH33, BVH34 };
+    Q_ENUM(MidPhase)
+
+    enum class MeshCookingHint { SimulationPerformance, CookingPerformance };
+    Q_ENUM(MeshCookingHint)
+
+    // The plain values, copied to the cooking jobs
+    struct Settings
+    {
+        MidPhase midPhase = MidPhase::BVH33;
+        MeshCookingHint meshCookingHint = MeshCookingHint::SimulationPerformance;
+        float meshSizePerformanceTradeOff = 0.55f;
+        int primitivesPerLeaf = 4;
+        bool precomputeActiveEdges = true;
+        bool cleanMesh = true;
+        float weldTolerance = 0.f;
+        bool buildGPUData = false;
+        int convexVertexLimit = 255;
+        int convexQuantizedCount = 0;
+
+        bool operator==(const Settings &other) const;
+        bool operator!=(const Settings &other) const { return !(*this == other); }
+        bool isDefault() const { return *this == Settings(); }
+
+        physx::PxCookingParams cookingParams() const;
+        void applyToConvexDesc(physx::PxConvexMeshDesc &desc) const;
+        // Returns the cooking object for the settings. The shared cooking object is used for the
+        // default settings, other settings get one that is created once and kept until
+        // releaseCookings() is called. Safe to call from the cooking threads.
+        physx::PxCooking *cooking() const;
+    };
+
+    // Releases the cooking objects of non-default settings, called when PhysX is shut down
+    static void releaseCookings();
+
+    explicit QCookingParameters(QObject *parent = nullptr);
+
+    const Settings &settings() const { return m_settings; }
+
+    MidPhase midPhase() const;
+    void setMidPhase(MidPhase midPhase);
+
+    MeshCookingHint meshCookingHint() const;
+    void setMeshCookingHint(MeshCookingHint meshCookingHint);
+
+    float meshSizePerformanceTradeOff() const;
+    void setMeshSizePerformanceTradeOff(float meshSizePerformanceTradeOff);
+
+    int primitivesPerLeaf() const;
+    void setPrimitivesPerLeaf(int primitivesPerLeaf);
+
+    bool precomputeActiveEdges() const;
+    void setPrecomputeActiveEdges(bool precomputeActiveEdges);
+
+    bool cleanMesh() const;
+    void setCleanMesh(bool cleanMesh);
+
+    float weldTolerance() const;
+    void setWeldTolerance(float weldTolerance);
+
+    bool buildGPUData() const;
+    void setBuildGPUData(bool buildGPUData);
+
+    int convexVertexLimit() const;
+    void setConvexVertexLimit(int convexVertexLimit);
+
+    int convexQuantizedCount() const;
+    void setConvexQuantizedCount(int convexQuantizedCount);
+
+Q_SIGNALS:
+    void midPhaseChanged();
+    void meshCookingHintChanged();
+    void meshSizePerformanceTradeOffChanged();
+    void primitivesPerLeafChanged();
+    void precomputeActiveEdgesChanged();
+    void cleanMeshChanged();
+    void weldToleranceChanged();
+    void buildGPUDataChanged();
+    void convexVertexLimitChanged();
+    void convexQuantizedCountChanged();
+    // Emitted together with any of the signals above
+    void settingsChanged();
+
+private:
+    Settings m_settings;
+};
+
+QT_END_NAMESPACE
+
+#endif // QCOOKINGPARAMETERS_H
@@ -11,9 +11,48 @@
 #include <geometry/PxConvexMesh.h>
 #include <geometry/PxTriangleMesh.h>
 #include <geometry/PxHeightField.h>
+#include <geometry/PxHeightFieldSample.h>
+#include <common/PxRenderBuffer.h>
 
 #include <QQuick3DGeometry>
 
+namespace {
+
+// The most rows or columns of a height field that are drawn
+constexpr int maxHeightFieldLines = 257;
+
+// Writes vertices in the layout of the visualization geometry and keeps track of their bounds
+struct VisualizationWriter
+{
+    float *data = nullptr;
+    physx::PxBounds3 bounds = physx::PxBounds3::empty();
+
+    void add(const physx::PxVec3 &position, physx::PxU32 color)
+    {
+        data[0] = position.x;
+        data[1] = position.y;
+        data[2] = position.z;
+        data[3] = 1.0f;
+
+        // The colors are 0xAARRGGBB, but PhysX leaves the alpha at zero for many of its lines
+        data[4] = float((color >> 16) & 0xff) / 255.0f;
+        data[5] = float((color >> 8) & 0xff) / 255.0f;
+        data[6] = float(color & 0xff) / 255.0f;
+        data[7] = 1.0f;
+
+        data += 8;
+        bounds.include(position);
+    }
+
+    void addLine(const physx::PxVec3 &start, const physx::PxVec3 &end, physx::PxU32 color)
+    {
+        add(start, color);
+        add(end, color);
+    }
+};
+
+}
+
 QQuick3DGeometry *QDebugDrawHelper::generateBoxGeometry(const QVector3D &halfExtents)
 {
     auto boxGeometry = new QQuick3DGeometry();
@@ -346,19 +385,37 @@ QQuick3DGeometry *QDebugDrawHelper::generateHeightFieldGeometry(physx::PxHeightF
     float minHeight = 0.f;
     float maxHeight = 0.f;
 
+    // Read all samples at once instead of one virtual call per sample
+    QList<physx::PxHeightFieldSample> samples(qsizetype(numRows) * numCols);
+    heightField->saveCells(samples.data(),
+                           physx::PxU32(samples.size() * sizeof(physx::PxHeightFieldSample)));
+
+    // Large height fields are drawn with every step'th row and column so that the wireframe does
+    // not get millions of lines. The last row and column are always included.
+    const int step = qMax(1, (qMax(numRows, numCols) - 1 + maxHeightFieldLines - 2)
+                                     / (maxHeightFieldLines - 1));
+    QList<int> rows;
+    for (int row = 0; row < numRows - 1; row += step)
+        rows.append(row);
+    rows.append(numRows - 1);
+    QList<int> cols;
+    for (int col = 0; col < numCols - 1; col += step)
+        cols.append(col);
+    cols.append(numCols - 1);
+
     auto sample = [&](int row, int col) -> QVector3D {
-        const float height = heightField->getSample(row, col).height * heightF;
+        const float height = samples.at(qsizetype(row) * numCols + col).height * heightF;
         maxHeight = qMax(maxHeight, height);
         minHeight = qMin(minHeight, height);
         return QVector3D(row * rowScale, height, col * columnScale);
     };
 
-    for (int row = 0; row < numRows; row++) {
-        for (int col = 0; col < numCols; col++) {
-            if (row < numRows - 1)
-                builder.addLine(sample(row, col), sample(row + 1, col));
-            if (col < numCols - 1)
-                builder.addLine(sample(row, col), sample(row, col + 1));
+    for (int i = 0; i < rows.size(); i++) {
+        for (int j = 0; j < cols.size(); j++) {
+            if (i < rows.size() - 1)
+                builder.addLine(sample(rows[i], cols[j]), sample(rows[i + 1], cols[j]));
+            if (j < cols.size() - 1)
+                builder.addLine(sample(rows[i], cols[j]), sample(rows[i], cols[j + 1]));
         }
     }
 
@@ -474,3 +531,75 @@ QDebugDrawHelper::generateTriangleMeshGeometry(physx::PxTriangleMesh *triangleMe
     geometry->setVertexData(builder.generateVertexArray());
     return geometry;
 }
+
+QQuick3DGeometry *QDebugDrawHelper::generateBatchGeometry()
+{
+    auto geometry = new QQuick3DGeometry();
+    geometry->clear();
+    geometry->addAttribute(QQuick3DGeometry::Attribute::PositionSemantic, 0,
+                           QQuick3DGeometry::Attribute::ComponentType::F32Type);
+    geometry->addAttribute(QQuick3DGeometry::Attribute::NormalSemantic, 16,
+                           QQuick3DGeometry::Attribute::ComponentType::F32Type);
+    geometry->setStride(QCollisionDebugMeshBuilder::vertexStride);
+    geometry->setPrimitiveType(QQuick3DGeometry::PrimitiveType::Lines);
+    return geometry;
+}
+
+QQuick3DGeometry *QDebugDrawHelper::generateVisualizationGeometry()
+{
+    auto geometry = new QQuick3DGeometry();
+    geometry->clear();
+    geometry->addAttribute(QQuick3DGeometry::Attribute::PositionSemantic, 0,
+                           QQuick3DGeometry::Attribute::ComponentType::F32Type);
+    geometry->addAttribute(QQuick3DGeometry::Attribute::ColorSemantic, 16,
+                           QQuick3DGeometry::Attribute::ComponentType::F32Type);
+    geometry->setStride(32);
+    geometry->setPrimitiveType(QQuick3DGeometry::PrimitiveType::Lines);
+    return geometry;
+}
+
+void QDebugDrawHelper::writeVisualizationVertices(const physx::PxRenderBuffer &renderBuffer,
+                                                  float pointSize, QByteArray &vertices,
+                                                  QVector3D &boundsMin, QVector3D &boundsMax)
+{
+    const physx::PxU32 nbLines = renderBuffer.getNbLines();
+    const physx::PxU32 nbPoints = renderBuffer.getNbPoints();
+    const physx::PxU32 nbTriangles = renderBuffer.getNbTriangles();
+    const qsizetype vertexCount = 2 * qsizetype(nbLines) + 6 * qsizetype(nbPoints + nbTriangles);
+
+    vertices.resize(vertexCount * 8 * sizeof(float));
+    if (vertexCount == 0)
+        return;
+
+    VisualizationWriter writer;
+    writer.data = reinterpret_cast<float *>(vertices.data());
+
+    const physx::PxDebugLine *lines = renderBuffer.getLines();
+    for (physx::PxU32 i = 0; i < nbLines; ++i) {
+        writer.add(lines[i].pos0, lines[i].color0);
+        writer.add(lines[i].pos1, lines[i].color1);
+    }
+
+    const physx::PxDebugPoint *points = renderBuffer.getPoints();
+    for (physx::PxU32 i = 0; i < nbPoints; ++i) {
+        const physx::PxVec3 &p = points[i].pos;
+        const physx::PxU32 color = points[i].color;
+        writer.addLine(p - physx::PxVec3(pointSize, 0, 0), p + physx::PxVec3(pointSize, 0, 0),
+                       color);
+        writer.addLine(p - physx::PxVec3(0, pointSize, 0), p + physx::PxVec3(0, pointSize, 0),
+                       color);
+        writer.addLine(p - physx::PxVec3(0, 0, pointSize), p + physx::PxVec3(0, 0, pointSize),
+                       color);
+    }
+
+    const physx::PxDebugTriangle *triangles = renderBuffer.getTriangles();
+    for (physx::PxU32 i = 0; i < nbTriangles; ++i) {
+        const physx::PxDebugTriangle &triangle = triangles[i];
+        writer.addLine(triangle.pos0, triangle.pos1, triangle.color0);
+        writer.addLine(triangle.pos1, triangle.pos2, triangle.color1);
+        writer.addLine(triangle.pos2, triangle.pos0, triangle.color2);
+    }
+
+    boundsMin = QPhysicsUtils::toQtType(writer.bounds.minimum);
+    boundsMax = QPhysicsUtils::toQtType(writer.bounds.maximum);
+}
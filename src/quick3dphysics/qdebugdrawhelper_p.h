@@ -21,9 +21,11 @@ namespace physx {
 class PxHeightField;
 class PxTriangleMesh;
 class PxConvexMesh;
+class PxRenderBuffer;
 }
 
 QT_BEGIN_NAMESPACE
+class QByteArray;
 class QVector3D;
 class QQuick3DGeometry;
 
@@ -36,6 +38,14 @@ QQuick3DGeometry *generateHeightFieldGeometry(physx::PxHeightField *heightField,
                                               float rowScale, float columnScale);
 QQuick3DGeometry *generateConvexMeshGeometry(physx::PxConvexMesh *convexMesh);
 QQuick3DGeometry *generateTriangleMeshGeometry(physx::PxTriangleMesh *triangleMesh);
+// An empty line geometry for the vertices of several shapes in scene coordinates
+QQuick3DGeometry *generateBatchGeometry();
+// An empty line geometry with a color for each vertex, for the PhysX debug visualization
+QQuick3DGeometry *generateVisualizationGeometry();
+// Writes the lines of the PhysX debug visualization as the vertices of a visualization geometry.
+// Points are drawn as crosses with pointSize long arms and triangles as their edges.
+void writeVisualizationVertices(const physx::PxRenderBuffer &renderBuffer, float pointSize,
+                                QByteArray &vertices, QVector3D &boundsMin, QVector3D &boundsMax);
 
 };
 
@@ -253,8 +253,10 @@ QT_BEGIN_NAMESPACE
     \since 6.9
 
     Is set to \c{true} if the body is sleeping. While it is technically possible to set this property
-    it should be seen as a read-only property that is set on every frame the physics simulation is
-    running.
+    it should be seen as a read-only property that is updated whenever the physics simulation
+    reports that the body fell asleep or woke up.
+
+    \sa PhysicsWorld::bodiesWoke, PhysicsWorld::bodiesSlept
 */
 
 /*!
@@ -561,6 +563,7 @@ void QDynamicRigidBody::setLinearAxisLock(AxisLock newAxisLockLinear)
     if (m_linearAxisLock == newAxisLockLinear)
         return;
     m_linearAxisLock = newAxisLockLinear;
+    m_axisLockDirty = true;
     emit linearAxisLockChanged();
 }
 
@@ -574,6 +577,7 @@ void QDynamicRigidBody::setAngularAxisLock(AxisLock newAxisLockAngular)
     if (m_angularAxisLock == newAxisLockAngular)
         return;
     m_angularAxisLock = newAxisLockAngular;
+    m_axisLockDirty = true;
     emit angularAxisLockChanged();
 }
 
@@ -194,6 +194,7 @@ private:
     bool m_isKinematic = false;
     AxisLock m_linearAxisLock = AxisLock::LockNone;
     AxisLock m_angularAxisLock = AxisLock::LockNone;
+    bool m_axisLockDirty = false;
     QQueue<QPhysicsCommand *> m_commandQueue;
     bool m_gravityEnabled = true;
     MassMode m_massMode = MassMode::DefaultDensity;
@@ -202,6 +203,8 @@ private:
     RotationData m_kinematicRotation;
     QVector3D m_kinematicPivot;
     bool m_isSleeping = false;
+
+    friend class QPhysXDynamicBody;
 };
 
 QT_END_NAMESPACE
@@ -4,8 +4,10 @@
 #include "qcacheutils_p.h"
 #include "qheightfieldshape_p.h"
 
+#include <QFile>
 #include <QFileInfo>
 #include <QImage>
+#include <QImageReader>
 #include <QQmlContext>
 #include <QQmlFile>
 #include <QtQuick3D/QQuick3DGeometry>
@@ -23,7 +25,10 @@
 #include "geometry/PxHeightField.h"
 #include "geometry/PxHeightFieldDesc.h"
 
+#include "qphysicsheightmap_p.h"
+#include "qphysicsmeshutils_p_p.h"
 #include "qphysicsworld_p.h"
+#include "qstaticphysxobjects_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -33,26 +38,45 @@ QT_BEGIN_NAMESPACE
 class QQuick3DPhysicsHeightField
 {
 public:
-    QQuick3DPhysicsHeightField(const QString &qmlSource);
+    QQuick3DPhysicsHeightField(const QString &qmlSource, const QRect &sourceRect = QRect());
     QQuick3DPhysicsHeightField(QQuickImage *image);
     ~QQuick3DPhysicsHeightField();
 
     void ref() { ++refCount; }
     int deref() { return --refCount; }
     void writeSamples(const QImage &heightMap);
+    // Returns the height field, cooking it on the calling thread or waiting for background cooking
     physx::PxHeightField *heightField();
+    QFuture<QByteArray> cookAsync();
+    bool isCooked() const;
+    // Queues replacing the samples in the rectangle of the image, the samples are stored column
+    // by column. Returns false if the rectangle is not inside the height field.
+    bool requestModification(const QRect &rect, QList<physx::PxHeightFieldSample> samples);
+    // Replaces the queued samples. Must only be called while no physics world is simulating.
+    // Returns true if any samples were replaced.
+    bool applyPendingModifications();
 
     int rows() const;
     int columns() const;
 
 private:
     QString m_sourcePath;
+    // Only this part of the source image is used when valid
+    QRect m_sourceRect;
     // This raw pointer is safe to store since when the Image or
     // HeightFieldShape is destroyed, this heightfield will be dereferenced
     // from all shapes and deleted.
     QQuickImage *m_image = nullptr;
     physx::PxHeightFieldSample *m_samples = nullptr;
     physx::PxHeightField *m_heightField = nullptr;
+    QFuture<QByteArray> m_cookingFuture;
+    // The sample modifications waiting for the next frame
+    struct Modification
+    {
+        QRect rect;
+        QList<physx::PxHeightFieldSample> samples;
+    };
+    QList<Modification> m_pendingModifications;
     int m_rows = 0;
     int m_columns = 0;
     int refCount = 0;
@@ -62,31 +86,50 @@ class QQuick3DPhysicsHeightFieldManager
 {
 public:
     static QQuick3DPhysicsHeightField *getHeightField(const QUrl &source,
-                                                      const QObject *contextObject);
+                                                      const QObject *contextObject,
+                                                      const QRect &sourceRect = QRect());
     static QQuick3DPhysicsHeightField *getHeightField(QQuickImage *source);
     static void releaseHeightField(QQuick3DPhysicsHeightField *heightField);
+    static bool hasPendingModifications() { return !pendingHeightFields.isEmpty(); }
+    // Applies the queued modifications and returns the height fields that changed. The height
+    // fields are shared by all physics worlds, so none of them may be simulating.
+    static QSet<QQuick3DPhysicsHeightField *> applyPendingModifications();
 
 private:
+    friend class QQuick3DPhysicsHeightField;
     static QHash<QString, QQuick3DPhysicsHeightField *> heightFieldHash;
     static QHash<QQuickImage *, QQuick3DPhysicsHeightField *> heightFieldImageHash;
+    static QSet<QQuick3DPhysicsHeightField *> pendingHeightFields;
 };
 
 QHash<QString, QQuick3DPhysicsHeightField *> QQuick3DPhysicsHeightFieldManager::heightFieldHash;
 QHash<QQuickImage *, QQuick3DPhysicsHeightField *>
         QQuick3DPhysicsHeightFieldManager::heightFieldImageHash;
+QSet<QQuick3DPhysicsHeightField *> QQuick3DPhysicsHeightFieldManager::pendingHeightFields;
 
 QQuick3DPhysicsHeightField *
-QQuick3DPhysicsHeightFieldManager::getHeightField(const QUrl &source, const QObject *contextObject)
+QQuick3DPhysicsHeightFieldManager::getHeightField(const QUrl &source, const QObject *contextObject,
+                                                  const QRect &sourceRect)
 {
     const QQmlContext *context = qmlContext(contextObject);
 
     const auto resolvedUrl = context ? context->resolvedUrl(source) : source;
     const auto qmlSource = QQmlFile::urlToLocalFileOrQrc(resolvedUrl);
 
-    auto *heightField = heightFieldHash.value(qmlSource);
+    // Parts of the same image are different height fields
+    QString key = qmlSource;
+    if (sourceRect.isValid()) {
+        key += QStringLiteral("#%1,%2,%3x%4")
+                       .arg(sourceRect.x())
+                       .arg(sourceRect.y())
+                       .arg(sourceRect.width())
+                       .arg(sourceRect.height());
+    }
+
+    auto *heightField = heightFieldHash.value(key);
     if (!heightField) {
-        heightField = new QQuick3DPhysicsHeightField(qmlSource);
-        heightFieldHash[qmlSource] = heightField;
+        heightField = new QQuick3DPhysicsHeightField(qmlSource, sourceRect);
+        heightFieldHash[key] = heightField;
     }
     heightField->ref();
     return heightField;
@@ -107,6 +150,7 @@ void QQuick3DPhysicsHeightFieldManager::releaseHeightField(QQuick3DPhysicsHeight
 {
     if (heightField != nullptr && heightField->deref() == 0) {
         qCDebug(lcQuick3dPhysics()) << "deleting height field" << heightField;
+        pendingHeightFields.remove(heightField);
         erase_if(heightFieldHash,
                  [heightField](std::pair<const QString &, QQuick3DPhysicsHeightField *&> h) {
                      return h.second == heightField;
@@ -119,8 +163,20 @@ void QQuick3DPhysicsHeightFieldManager::releaseHeightField(QQuick3DPhysicsHeight
     }
 }
 
-QQuick3DPhysicsHeightField::QQuick3DPhysicsHeightField(const QString &qmlSource)
-    : m_sourcePath(qmlSource)
+QSet<QQuick3DPhysicsHeightField *> QQuick3DPhysicsHeightFieldManager::applyPendingModifications()
+{
+    QSet<QQuick3DPhysicsHeightField *> modifiedHeightFields;
+    for (auto *heightField : std::as_const(pendingHeightFields)) {
+        if (heightField->applyPendingModifications())
+            modifiedHeightFields.insert(heightField);
+    }
+    pendingHeightFields.clear();
+    return modifiedHeightFields;
+}
+
+QQuick3DPhysicsHeightField::QQuick3DPhysicsHeightField(const QString &qmlSource,
+                                                       const QRect &sourceRect)
+    : m_sourcePath(qmlSource), m_sourceRect(sourceRect)
 {
 }
 
@@ -129,6 +185,88 @@ QQuick3DPhysicsHeightField::QQuick3DPhysicsHeightField(QQuickImage *image) : m_i
 QQuick3DPhysicsHeightField::~QQuick3DPhysicsHeightField()
 {
     free(m_samples);
+    // PhysX shapes still using the height field hold their own reference to it
+    if (StaticPhysXObjects::getReference().physicsCreated)
+        QCacheUtils::releaseObject(m_heightField);
+}
+
+// Reads only the part of the image inside sourceRect, if it is valid
+static QImage readHeightMap(const QString &sourcePath, const QRect &sourceRect)
+{
+    QImageReader reader(sourcePath);
+    if (sourceRect.isValid())
+        reader.setClipRect(sourceRect);
+    return reader.read();
+}
+
+static bool cookHeightField(const physx::PxHeightFieldSample *samples, int numRows, int numCols,
+                            physx::PxOutputStream &buf)
+{
+    const auto cooking = StaticPhysXObjects::getReference().cooking;
+    if (!numRows || !numCols || !cooking)
+        return false;
+
+    physx::PxHeightFieldDesc hfDesc;
+    hfDesc.format = physx::PxHeightFieldFormat::eS16_TM;
+    hfDesc.nbColumns = numRows;
+    hfDesc.nbRows = numCols;
+    hfDesc.samples.data = samples;
+    hfDesc.samples.stride = sizeof(physx::PxHeightFieldSample);
+
+    return cooking->cookHeightField(hfDesc, buf);
+}
+
+// Runs on a worker thread, the PhysX height field is created from the result on the GUI thread
+static QByteArray cookHeightFieldData(const QString &sourcePath, const QRect &sourceRect,
+                                      QImage heightMap)
+{
+    const bool fromFile = !sourcePath.isEmpty();
+    // The cache and cooked files hold the whole image
+    const bool fromFilePart = fromFile && sourceRect.isValid();
+    if (fromFilePart) {
+        heightMap = readHeightMap(sourcePath, sourceRect);
+    } else if (fromFile) {
+        QByteArray data = QCacheUtils::readCachedData(sourcePath,
+                                                      QCacheUtils::CacheGeometry::HeightField);
+        if (!data.isEmpty())
+            return data;
+
+        QFile file(sourcePath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            qWarning() << "Could not open" << sourcePath;
+            return QByteArray();
+        }
+
+        // Serialized collections are deserialized in place on the GUI thread, only pass on
+        // the header so that the file is not read here
+        if (QCacheUtils::isSerializedCollection(file.peek(4)))
+            return file.read(4);
+
+        data = file.readAll();
+
+        // Files written by the cooker start with the PhysX stream identifier
+        if (data.startsWith("NXS"))
+            return data;
+
+        heightMap = QImage::fromData(data);
+    }
+
+    const int numRows = heightMap.height();
+    const int numCols = heightMap.width();
+    QList<physx::PxHeightFieldSample> samples(qsizetype(numRows) * numCols);
+    QPhysicsHeightMap::fillSamples(heightMap, samples.data());
+
+    physx::PxDefaultMemoryOutputStream buf;
+    if (!cookHeightField(samples.constData(), numRows, numCols, buf)) {
+        qCWarning(lcQuick3dPhysics) << "Could not cook height field from"
+                                    << (fromFile ? sourcePath : QStringLiteral("image"));
+        return QByteArray();
+    }
+
+    if (fromFile && !fromFilePart)
+        QCacheUtils::writeCachedHeightField(sourcePath, buf);
+
+    return QByteArray(reinterpret_cast<const char *>(buf.getData()), buf.getSize());
 }
 
 void QQuick3DPhysicsHeightField::writeSamples(const QImage &heightMap)
@@ -141,12 +279,27 @@ void QQuick3DPhysicsHeightField::writeSamples(const QImage &heightMap)
     free(m_samples);
     m_samples = reinterpret_cast<physx::PxHeightFieldSample *>(
             malloc(sizeof(physx::PxHeightFieldSample) * (numRows * numCols)));
-    for (int i = 0; i < numCols; i++)
-        for (int j = 0; j < numRows; j++) {
-            float f = heightMap.pixelColor(i, j).valueF() - 0.5;
-            // qDebug() << i << j << f;
-            m_samples[i * numRows + j] = { qint16(0xffff * f), 0, 0 }; //{qint16(i%3*2 + j), 0, 0};
-        }
+    QPhysicsHeightMap::fillSamples(heightMap, m_samples);
+}
+
+QFuture<QByteArray> QQuick3DPhysicsHeightField::cookAsync()
+{
+    if (m_heightField || m_cookingFuture.isValid())
+        return m_cookingFuture;
+
+    const QString sourcePath = m_image ? QString() : m_sourcePath;
+    const QRect sourceRect = m_sourceRect;
+    const QImage heightMap = m_image ? m_image->image() : QImage();
+    m_cookingFuture =
+            QQuick3DPhysicsMeshManager::runCookingJob([sourcePath, sourceRect, heightMap] {
+                return cookHeightFieldData(sourcePath, sourceRect, heightMap);
+            });
+    return m_cookingFuture;
+}
+
+bool QQuick3DPhysicsHeightField::isCooked() const
+{
+    return m_heightField || (m_cookingFuture.isValid() && m_cookingFuture.isFinished());
 }
 
 physx::PxHeightField *QQuick3DPhysicsHeightField::heightField()
@@ -158,14 +311,45 @@ physx::PxHeightField *QQuick3DPhysicsHeightField::heightField()
     if (thePhysics == nullptr)
         return nullptr;
 
+    if (m_cookingFuture.isValid()) {
+        const QByteArray data = m_cookingFuture.result();
+        m_cookingFuture = QFuture<QByteArray>();
+        if (data.isEmpty())
+            return nullptr;
+        if (QCacheUtils::isSerializedCollection(data)) {
+            m_heightField = QCacheUtils::readCookedHeightField(m_sourcePath, *thePhysics);
+            if (m_heightField != nullptr) {
+                m_rows = m_heightField->getNbRows();
+                m_columns = m_heightField->getNbColumns();
+            }
+            return m_heightField;
+        }
+        physx::PxDefaultMemoryInputData input(
+                reinterpret_cast<physx::PxU8 *>(const_cast<char *>(data.constData())),
+                physx::PxU32(data.size()));
+        m_heightField = thePhysics->createHeightField(input);
+        if (m_heightField != nullptr) {
+            // The cooked rows run along the image width, see cookHeightField()
+            m_rows = m_heightField->getNbColumns();
+            m_columns = m_heightField->getNbRows();
+        }
+        qCDebug(lcQuick3dPhysics) << "created height field" << m_heightField << m_columns << m_rows
+                                  << "from background cooking";
+        return m_heightField;
+    }
+
     // No source set
     if (m_image == nullptr && m_sourcePath.isEmpty())
         return nullptr;
 
     // Reading from image property has precedence
     const bool readFromFile = m_image == nullptr;
+    // The cache and cooked files hold the whole image
+    const bool readFromFilePart = readFromFile && m_sourceRect.isValid();
 
-    if (readFromFile) {
+    if (readFromFilePart) {
+        writeSamples(readHeightMap(m_sourcePath, m_sourceRect));
+    } else if (readFromFile) {
         // Try read cached file
         m_heightField = QCacheUtils::readCachedHeightField(m_sourcePath, *thePhysics);
         if (m_heightField != nullptr) {
@@ -192,17 +376,8 @@ physx::PxHeightField *QQuick3DPhysicsHeightField::heightField()
     int numCols = m_columns;
     auto samples = m_samples;
 
-    physx::PxHeightFieldDesc hfDesc;
-    hfDesc.format = physx::PxHeightFieldFormat::eS16_TM;
-    hfDesc.nbColumns = numRows;
-    hfDesc.nbRows = numCols;
-    hfDesc.samples.data = samples;
-    hfDesc.samples.stride = sizeof(physx::PxHeightFieldSample);
-
     physx::PxDefaultMemoryOutputStream buf;
-
-    const auto cooking = QPhysicsWorld::getCooking();
-    if (numRows && numCols && cooking && cooking->cookHeightField(hfDesc, buf)) {
+    if (cookHeightField(samples, numRows, numCols, buf)) {
         auto size = buf.getSize();
         auto *data = buf.getData();
         physx::PxDefaultMemoryInputData input(data, size);
@@ -210,7 +385,7 @@ physx::PxHeightField *QQuick3DPhysicsHeightField::heightField()
         qCDebug(lcQuick3dPhysics) << "created height field" << m_heightField << numCols << numRows
                                   << "from"
                                   << (readFromFile ? m_sourcePath : QString::fromUtf8("image"));
-        if (readFromFile)
+        if (readFromFile && !readFromFilePart)
             QCacheUtils::writeCachedHeightField(m_sourcePath, buf);
     } else {
         qCWarning(lcQuick3dPhysics) << "Could not create height field from"
@@ -220,6 +395,51 @@ physx::PxHeightField *QQuick3DPhysicsHeightField::heightField()
     return m_heightField;
 }
 
+bool QQuick3DPhysicsHeightField::requestModification(const QRect &rect,
+                                                     QList<physx::PxHeightFieldSample> samples)
+{
+    auto *hf = heightField();
+    if (hf == nullptr) {
+        qWarning() << "HeightFieldShape: the height field has not been created yet";
+        return false;
+    }
+
+    // The rows of the PhysX height field run along the image width, see cookHeightField()
+    const QRect bounds(0, 0, int(hf->getNbRows()), int(hf->getNbColumns()));
+    if (rect.isEmpty() || !bounds.contains(rect)) {
+        qWarning() << "HeightFieldShape:" << rect << "is outside of the height field" << bounds;
+        return false;
+    }
+
+    m_pendingModifications.append({ rect, std::move(samples) });
+    QQuick3DPhysicsHeightFieldManager::pendingHeightFields.insert(this);
+    return true;
+}
+
+bool QQuick3DPhysicsHeightField::applyPendingModifications()
+{
+    bool modified = false;
+    for (const auto &modification : std::as_const(m_pendingModifications)) {
+        if (!m_heightField)
+            break;
+
+        physx::PxHeightFieldDesc hfDesc;
+        hfDesc.format = physx::PxHeightFieldFormat::eS16_TM;
+        hfDesc.nbRows = modification.rect.width();
+        hfDesc.nbColumns = modification.rect.height();
+        hfDesc.samples.data = modification.samples.constData();
+        hfDesc.samples.stride = sizeof(physx::PxHeightFieldSample);
+
+        // Not shrinking the bounds avoids going through all samples of the height field
+        if (m_heightField->modifySamples(modification.rect.y(), modification.rect.x(), hfDesc,
+                                         false)) {
+            modified = true;
+        }
+    }
+    m_pendingModifications.clear();
+    return modified;
+}
+
 int QQuick3DPhysicsHeightField::rows() const
 {
     return m_rows;
@@ -240,9 +460,12 @@ int QQuick3DPhysicsHeightField::columns() const
     The HeightFieldShape type defines a physical surface where the height is determined by
     the \l {QColor#The HSV Color Model}{value} of the pixels of the \l {source} image. The
     x-axis of the image is mapped to the positive x-axis of the scene, and the y-axis of the
-    image is mapped to the negative z-axis of the scene. A typical use case is to represent
+    image is mapped to the positive z-axis of the scene. A typical use case is to represent
     natural terrain.
 
+    Grayscale images with 16 bits per pixel, 64-bit RGBA images and floating point images are
+    read at full precision. Images with 8 bits per channel give 256 distinct heights.
+
     Objects that are controlled by the physics simulation cannot use HeightFieldShape: It can only
     be used with \l StaticRigidBody and \l {DynamicRigidBody::isKinematic}{kinematic bodies}.
 
@@ -290,6 +513,28 @@ int QQuick3DPhysicsHeightField::columns() const
     \since 6.7
 */
 
+/*!
+    \qmlmethod bool HeightFieldShape::modifySamples(rect rect, list<real> heights)
+    \since 6.9
+
+    Replaces the heights of the samples inside \a rect, given in pixels of the height map. The
+    \a heights list holds \c{rect.width * rect.height} values, row by row, in the same range as
+    the values of the height map: \c 0 is the lowest and \c 1 the highest point of the
+    \l{extents}.
+
+    The height field is changed in place, so the bodies using it do not have to be created again.
+    This makes it suitable for deforming terrain, for example when digging or making craters.
+    Height field shapes using the same \l source or \l image share their height field and will
+    all see the change, also in other physics worlds. The change is lost when the height map
+    itself changes.
+
+    The samples are replaced between two simulation steps when none of the physics worlds is
+    simulating, so the change takes effect from the next step on. This function can be called at any time, for example from
+    \l{PhysicsWorld::}{frameDone}.
+
+    Returns \c true if the rectangle is inside the height field and the samples will be replaced.
+*/
+
 QHeightFieldShape::QHeightFieldShape() = default;
 
 QHeightFieldShape::~QHeightFieldShape()
@@ -299,6 +544,13 @@ QHeightFieldShape::~QHeightFieldShape()
         QQuick3DPhysicsHeightFieldManager::releaseHeightField(m_heightField);
 }
 
+QFuture<QByteArray> QHeightFieldShape::cookAsync()
+{
+    if (!m_heightField || m_heightField->isCooked())
+        return QFuture<QByteArray>();
+    return m_heightField->cookAsync();
+}
+
 physx::PxGeometry *QHeightFieldShape::getPhysXGeometry()
 {
     if (m_dirtyPhysx || m_scaleDirty || !m_heightFieldGeometry) {
@@ -307,6 +559,43 @@ physx::PxGeometry *QHeightFieldShape::getPhysXGeometry()
     return m_heightFieldGeometry;
 }
 
+bool QHeightFieldShape::modifySamples(const QRect &rect, const QList<float> &heights)
+{
+    if (heights.size() != qsizetype(rect.width()) * rect.height()) {
+        qWarning() << "HeightFieldShape: expected" << qsizetype(rect.width()) * rect.height()
+                   << "heights for" << rect << "but got" << heights.size();
+        return false;
+    }
+
+    if (!m_heightField) {
+        qWarning() << "HeightFieldShape: cannot modify samples without a height map";
+        return false;
+    }
+
+    QList<physx::PxHeightFieldSample> samples(heights.size());
+    QPhysicsHeightMap::fillSamples(heights.constData(), rect.width(), rect.height(),
+                                   samples.data());
+
+    // The physics world applies the samples before the next step and then updates the bounds of
+    // the shapes of all bodies using the height field
+    return m_heightField->requestModification(rect, std::move(samples));
+}
+
+bool QHeightFieldShape::hasPendingModifications()
+{
+    return QQuick3DPhysicsHeightFieldManager::hasPendingModifications();
+}
+
+QSet<QQuick3DPhysicsHeightField *> QHeightFieldShape::applyPendingModifications()
+{
+    return QQuick3DPhysicsHeightFieldManager::applyPendingModifications();
+}
+
+QQuick3DPhysicsHeightField *QHeightFieldShape::physicsHeightField() const
+{
+    return m_heightField;
+}
+
 void QHeightFieldShape::updatePhysXGeometry()
 {
     delete m_heightFieldGeometry;
@@ -373,7 +662,8 @@ void QHeightFieldShape::setSource(const QUrl &newSource)
 
     // Load new height field only if we don't have image as source
     if (m_image == nullptr && !newSource.isEmpty()) {
-        m_heightField = QQuick3DPhysicsHeightFieldManager::getHeightField(m_heightMapSource, this);
+        m_heightField = QQuick3DPhysicsHeightFieldManager::getHeightField(m_heightMapSource, this,
+                                                                          m_sourceRect);
         emit needsRebuild(this);
     }
 
@@ -381,6 +671,28 @@ void QHeightFieldShape::setSource(const QUrl &newSource)
     emit sourceChanged();
 }
 
+const QRect &QHeightFieldShape::sourceRect() const
+{
+    return m_sourceRect;
+}
+
+void QHeightFieldShape::setSourceRect(const QRect &newSourceRect)
+{
+    if (m_sourceRect == newSourceRect)
+        return;
+    m_sourceRect = newSourceRect;
+
+    // Only the height field from the source uses the rectangle
+    if (m_image != nullptr || m_heightMapSource.isEmpty())
+        return;
+
+    QQuick3DPhysicsHeightFieldManager::releaseHeightField(m_heightField);
+    m_heightField = QQuick3DPhysicsHeightFieldManager::getHeightField(m_heightMapSource, this,
+                                                                      m_sourceRect);
+    m_dirtyPhysx = true;
+    emit needsRebuild(this);
+}
+
 QQuickImage *QHeightFieldShape::image() const
 {
     return m_image;
@@ -409,7 +721,8 @@ void QHeightFieldShape::setImage(QQuickImage *newImage)
     if (m_image != nullptr)
         m_heightField = QQuick3DPhysicsHeightFieldManager::getHeightField(m_image);
     else if (!m_heightMapSource.isEmpty())
-        m_heightField = QQuick3DPhysicsHeightFieldManager::getHeightField(m_heightMapSource, this);
+        m_heightField = QQuick3DPhysicsHeightFieldManager::getHeightField(m_heightMapSource, this,
+                                                                          m_sourceRect);
 
     m_dirtyPhysx = true;
     emit needsRebuild(this);
@@ -18,6 +18,7 @@
 #include <QtQuick3DPhysics/qtquick3dphysicsglobal.h>
 #include <QtQuick3DPhysics/private/qabstractcollisionshape_p.h>
 #include <QtCore/QObject>
+#include <QtCore/QSet>
 #include <QtGui/QVector3D>
 #include <QtQml/QQmlEngine>
 #include <QtQuick3D/QQuick3DGeometry>
@@ -48,12 +49,17 @@ public:
     ~QHeightFieldShape();
 
     physx::PxGeometry *getPhysXGeometry() override;
+    QFuture<QByteArray> cookAsync() override;
 
     Q_REVISION(6, 5) const QUrl &source() const;
     Q_REVISION(6, 5) void setSource(const QUrl &newSource);
 
     const QVector3D &hfOffset() const { return m_hfOffset; }
 
+    // Only the part of the source image inside the rectangle is used when it is valid
+    const QRect &sourceRect() const;
+    void setSourceRect(const QRect &newSourceRect);
+
     const QVector3D &extents() const;
     void setExtents(const QVector3D &newExtents);
     bool isStaticShape() const override { return true; }
@@ -61,6 +67,16 @@ public:
     Q_REVISION(6, 7) QQuickImage *image() const;
     Q_REVISION(6, 7) void setImage(QQuickImage *newImage);
 
+    Q_REVISION(6, 9) Q_INVOKABLE bool modifySamples(const QRect &rect,
+                                                    const QList<float> &heights);
+
+    static bool hasPendingModifications();
+    // Replaces the samples queued by modifySamples() in all height fields and returns the height
+    // fields that changed. Must only be called while no physics world is simulating.
+    static QSet<QQuick3DPhysicsHeightField *> applyPendingModifications();
+    // The shared height field the geometry of the shape is created from
+    QQuick3DPhysicsHeightField *physicsHeightField() const;
+
 signals:
     Q_REVISION(6, 5) void sourceChanged();
     void extentsChanged();
@@ -80,6 +96,7 @@ private:
     physx::PxHeightFieldGeometry *m_heightFieldGeometry = nullptr;
     QVector3D m_hfOffset;
     QUrl m_heightMapSource;
+    QRect m_sourceRect;
     bool m_dirtyPhysx = false;
     QVector3D m_extents = { 100, 100, 100 };
     bool m_extentsSetExplicitly = false;
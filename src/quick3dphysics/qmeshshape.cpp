@@ -3,9 +3,11 @@
 
 #include "qcacheutils_p.h"
 #include "qmeshshape_p.h"
+#include "qphysicsmeshreader_p.h"
 
 #include <QFile>
-#include <QFileInfo>
+#include <QPromise>
+#include <QThreadPool>
 #include <QtQuick3D/QQuick3DGeometry>
 #include <extensions/PxExtensionsAPI.h>
 
@@ -17,12 +19,12 @@
 #include <QtQml/QQmlFile>
 #include <QtQml/qqmlcontext.h>
 
-#include <QtQuick3DUtils/private/qssgmesh_p.h>
 #include <QtQuick3D/QQuick3DGeometry>
 
 #include "qmeshshape_p.h"
 #include "qphysicsworld_p.h"
 #include "qphysicsmeshutils_p_p.h"
+#include "qstaticphysxobjects_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -40,327 +42,525 @@ attributeBySemantic(const QQuick3DGeometry *geometry,
     return QQuick3DGeometry::Attribute();
 };
 
-physx::PxConvexMesh *QQuick3DPhysicsMesh::convexMesh()
+Q_GLOBAL_STATIC(QThreadPool, cookingThreadPool)
+
+static bool cookConvexMesh(const QQuick3DPhysicsMesh::CookingSource &source,
+                           const QCookingParameters::Settings &settings,
+                           physx::PxOutputStream &buf)
 {
-    if (m_convexMesh != nullptr)
-        return m_convexMesh;
+    physx::PxCooking *cooking = settings.cooking();
+    if (!cooking || source.stride <= 0)
+        return false;
 
-    physx::PxPhysics *thePhysics = QPhysicsWorld::getPhysics();
-    if (thePhysics == nullptr)
-        return nullptr;
+    physx::PxConvexMeshDesc convexDesc;
+    convexDesc.points.count = source.vertexData.size() / source.stride;
+    convexDesc.points.stride = source.stride;
+    convexDesc.points.data = source.vertexData.constData() + source.posOffset;
+    convexDesc.flags = physx::PxConvexFlag::eCOMPUTE_CONVEX;
+    settings.applyToConvexDesc(convexDesc);
 
-    if (m_meshGeometry)
-        return convexMeshGeometrySource();
-    if (!m_meshPath.isEmpty())
-        return convexMeshQmlSource();
-    return nullptr;
+    // NOTE: Since we are making a mesh for the convex hull and are only
+    // interested in the positions we can Skip the index array.
+
+    physx::PxConvexMeshCookingResult::Enum result;
+    return cooking->cookConvexMesh(convexDesc, buf, &result);
 }
 
-physx::PxTriangleMesh *QQuick3DPhysicsMesh::triangleMesh()
+static bool cookTriangleMesh(const QQuick3DPhysicsMesh::CookingSource &source,
+                             const QCookingParameters::Settings &settings,
+                             physx::PxOutputStream &buf)
 {
-    if (m_triangleMesh != nullptr)
-        return m_triangleMesh;
+    physx::PxCooking *cooking = settings.cooking();
+    if (!cooking || source.stride <= 0)
+        return false;
 
-    physx::PxPhysics *thePhysics = QPhysicsWorld::getPhysics();
-    if (thePhysics == nullptr)
-        return nullptr;
+    physx::PxTriangleMeshDesc triangleDesc;
+    triangleDesc.points.count = source.vertexData.size() / source.stride;
+    triangleDesc.points.stride = source.stride;
+    triangleDesc.points.data = source.vertexData.constData() + source.posOffset;
 
-    if (m_meshGeometry)
-        return triangleMeshGeometrySource();
-    if (!m_meshPath.isEmpty())
-        return triangleMeshQmlSource();
-    return nullptr;
+    if (source.indexData.size()) {
+        triangleDesc.triangles.data = source.indexData.constData();
+        if (source.u16Indices) {
+            triangleDesc.flags.set(physx::PxMeshFlag::e16_BIT_INDICES);
+            triangleDesc.triangles.stride = sizeof(quint16) * 3;
+        } else {
+            triangleDesc.triangles.stride = sizeof(quint32) * 3;
+        }
+        triangleDesc.triangles.count = source.indexData.size() / triangleDesc.triangles.stride;
+    }
+
+    physx::PxTriangleMeshCookingResult::Enum result;
+    return cooking->cookTriangleMesh(triangleDesc, buf, &result);
 }
 
-physx::PxConvexMesh *QQuick3DPhysicsMesh::convexMeshQmlSource()
+static QQuick3DPhysicsMesh::CookingSource
+meshDataCookingSource(const QPhysicsMeshReader::MeshData &meshData)
 {
-    physx::PxPhysics *thePhysics = QPhysicsWorld::getPhysics();
+    QQuick3DPhysicsMesh::CookingSource source;
+    source.vertexData = meshData.positions;
+    source.stride = sizeof(QVector3D);
+    source.posOffset = 0;
+    source.indexData = meshData.indices;
+    source.u16Indices = meshData.u16Indices;
+    return source;
+}
 
-    m_convexMesh = QCacheUtils::readCachedConvexMesh(m_meshPath, *thePhysics);
-    if (m_convexMesh != nullptr)
-        return m_convexMesh;
+// Runs on a worker thread. Only touches the copied source data and thread-safe PhysX cooking, the
+// PhysX mesh itself is created from the result on the GUI thread.
+static QByteArray cookMeshData(const QQuick3DPhysicsMesh::CookingSource &source,
+                               QQuick3DPhysicsMesh::MeshType type,
+                               const QCookingParameters::Settings &settings)
+{
+    const auto geom = type == QQuick3DPhysicsMesh::Convex
+            ? QCacheUtils::CacheGeometry::ConvexMesh
+            : QCacheUtils::CacheGeometry::TriangleMesh;
+    const bool fromFile = !source.meshPath.isEmpty();
+    QQuick3DPhysicsMesh::CookingSource cookingSource = source;
+
+    if (fromFile) {
+        QByteArray data = QCacheUtils::readCachedData(source.meshPath, geom, settings);
+        if (!data.isEmpty())
+            return data;
+
+        QFile file(source.meshPath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            qWarning() << "Could not open" << source.meshPath;
+            return QByteArray();
+        }
 
-    m_convexMesh = QCacheUtils::readCookedConvexMesh(m_meshPath, *thePhysics);
-    if (m_convexMesh != nullptr)
-        return m_convexMesh;
+        // Serialized collections are deserialized in place on the GUI thread, only pass on
+        // the header so that the file is not read here
+        if (QCacheUtils::isSerializedCollection(file.peek(4)))
+            return file.read(4);
 
-    loadSsgMesh();
+        // Files written by the cooker start with the PhysX stream identifier
+        if (file.peek(3) == "NXS")
+            return file.readAll();
 
-    if (!m_ssgMesh.isValid())
-        return nullptr;
+        const QPhysicsMeshReader::MeshData meshData = QPhysicsMeshReader::readMesh(&file);
+        if (!meshData.isValid()) {
+            qCWarning(lcQuick3dPhysics) << "Could not read mesh from" << source.meshPath;
+            return QByteArray();
+        }
+        cookingSource = meshDataCookingSource(meshData);
+    }
+
+    physx::PxDefaultMemoryOutputStream buf;
+    const bool cooked = type == QQuick3DPhysicsMesh::Convex
+            ? cookConvexMesh(cookingSource, settings, buf)
+            : cookTriangleMesh(cookingSource, settings, buf);
+    if (!cooked) {
+        qCWarning(lcQuick3dPhysics) << "Could not cook mesh"
+                                    << (fromFile ? source.meshPath : QStringLiteral("geometry"));
+        return QByteArray();
+    }
 
-    const int vStride = m_ssgMesh.vertexBuffer().stride;
-    const int vCount = m_ssgMesh.vertexBuffer().data.size() / vStride;
+    if (fromFile) {
+        if (type == QQuick3DPhysicsMesh::Convex)
+            QCacheUtils::writeCachedConvexMesh(source.meshPath, buf, settings);
+        else
+            QCacheUtils::writeCachedTriangleMesh(source.meshPath, buf, settings);
+    }
 
-    qCDebug(lcQuick3dPhysics) << "prepare cooking" << vCount << "verts";
+    return QByteArray(reinterpret_cast<const char *>(buf.getData()), buf.getSize());
+}
 
-    physx::PxConvexMeshDesc convexDesc;
-    convexDesc.points.count = vCount;
-    convexDesc.points.stride = vStride;
-    convexDesc.points.data = m_ssgMesh.vertexBuffer().data.constData() + m_posOffset;
-    convexDesc.flags = physx::PxConvexFlag::eCOMPUTE_CONVEX;
+QQuick3DPhysicsMesh::~QQuick3DPhysicsMesh()
+{
+    for (CookedMeshes &cooked : m_cookedMeshes)
+        releaseMeshes(cooked);
+}
 
-    // NOTE: Since we are making a mesh for the convex hull and are only
-    // interested in the positions we can Skip the index array.
+void QQuick3DPhysicsMesh::releaseMeshes(CookedMeshes &cooked)
+{
+    // PhysX shapes still using the meshes hold their own reference to them
+    if (StaticPhysXObjects::getReference().physicsCreated) {
+        QCacheUtils::releaseObject(cooked.convexMesh);
+        QCacheUtils::releaseObject(cooked.triangleMesh);
+    }
+    cooked.convexMesh = nullptr;
+    cooked.triangleMesh = nullptr;
+}
 
-    physx::PxDefaultMemoryOutputStream buf;
-    physx::PxConvexMeshCookingResult::Enum result;
-    const auto cooking = QPhysicsWorld::getCooking();
-    if (cooking && cooking->cookConvexMesh(convexDesc, buf, &result)) {
-        auto size = buf.getSize();
-        auto *data = buf.getData();
-        physx::PxDefaultMemoryInputData input(data, size);
-        m_convexMesh = thePhysics->createConvexMesh(input);
-        qCDebug(lcQuick3dPhysics) << "Created convex mesh" << m_convexMesh << "for mesh" << this;
-        QCacheUtils::writeCachedConvexMesh(m_meshPath, buf);
-    } else {
-        qCWarning(lcQuick3dPhysics) << "Could not create convex mesh from" << m_meshPath;
+void QQuick3DPhysicsMesh::refSettings(const QCookingParameters::Settings &settings)
+{
+    cookedMeshes(settings).users++;
+}
+
+void QQuick3DPhysicsMesh::derefSettings(const QCookingParameters::Settings &settings)
+{
+    for (CookedMeshes &cooked : m_cookedMeshes) {
+        if (cooked.settings == settings) {
+            cooked.users--;
+            break;
+        }
+    }
+
+    // Cooking results that have not been turned into meshes yet are kept for the nodes that
+    // started the cooking
+    m_cookedMeshes.removeIf([this](CookedMeshes &cooked) {
+        if (cooked.users > 0 || cooked.cookingFutures[Convex].isValid()
+            || cooked.cookingFutures[Triangle].isValid())
+            return false;
+        qCDebug(lcQuick3dPhysics) << "Releasing unused meshes of mesh" << this;
+        releaseMeshes(cooked);
+        m_pendingRefits.removeAll(cooked.settings);
+        return true;
+    });
+}
+
+QQuick3DPhysicsMesh::CookedMeshes &
+QQuick3DPhysicsMesh::cookedMeshes(const QCookingParameters::Settings &settings)
+{
+    for (CookedMeshes &cooked : m_cookedMeshes) {
+        if (cooked.settings == settings)
+            return cooked;
     }
+    m_cookedMeshes.append(CookedMeshes { settings, nullptr, nullptr, {} });
+    return m_cookedMeshes.last();
+}
 
-    return m_convexMesh;
+const QQuick3DPhysicsMesh::CookedMeshes *
+QQuick3DPhysicsMesh::findCookedMeshes(const QCookingParameters::Settings &settings) const
+{
+    for (const CookedMeshes &cooked : m_cookedMeshes) {
+        if (cooked.settings == settings)
+            return &cooked;
+    }
+    return nullptr;
 }
 
-physx::PxConvexMesh *QQuick3DPhysicsMesh::convexMeshGeometrySource()
+QFuture<QByteArray> QQuick3DPhysicsMesh::cookAsync(MeshType type,
+                                                   const QCookingParameters::Settings &settings)
 {
-    auto vertexBuffer = m_meshGeometry->vertexData();
+    QFuture<QByteArray> &future = cookedMeshes(settings).cookingFutures[type];
+    if (future.isValid())
+        return future;
+
+    CookingSource source;
+    if (m_meshGeometry)
+        source = geometryCookingSource();
+    else
+        source.meshPath = m_meshPath;
+
+    future = QQuick3DPhysicsMeshManager::runCookingJob(
+            [source, type, settings] { return cookMeshData(source, type, settings); });
 
+    qCDebug(lcQuick3dPhysics) << "Started cooking" << (type == Convex ? "convex" : "triangle")
+                              << "mesh" << this;
+    return future;
+}
+
+bool QQuick3DPhysicsMesh::isCooked(MeshType type,
+                                   const QCookingParameters::Settings &settings) const
+{
+    const CookedMeshes *cooked = findCookedMeshes(settings);
+    if (!cooked)
+        return false;
+    if ((type == Convex && cooked->convexMesh) || (type == Triangle && cooked->triangleMesh))
+        return true;
+    const QFuture<QByteArray> &future = cooked->cookingFutures[type];
+    return future.isValid() && future.isFinished();
+}
+
+QQuick3DPhysicsMesh::CookingSource QQuick3DPhysicsMesh::geometryCookingSource() const
+{
+    Q_ASSERT(m_meshGeometry);
+
+    CookingSource source;
     if (m_meshGeometry->primitiveType() != QQuick3DGeometry::PrimitiveType::Triangles) {
         qWarning() << "QQuick3DPhysicsMesh: Invalid geometry primitive type, must be Triangles. ";
-        return nullptr;
+        return source;
     }
 
-    if (!vertexBuffer.size()) {
+    source.vertexData = m_meshGeometry->vertexData();
+    if (!source.vertexData.size()) {
         qWarning() << "QQuick3DPhysicsMesh: Invalid geometry, vertexData is empty. ";
-        return nullptr;
+        return source;
     }
 
     const auto vertexAttribute =
             attributeBySemantic(m_meshGeometry, QQuick3DGeometry::Attribute::PositionSemantic);
     Q_ASSERT(vertexAttribute.componentType == QQuick3DGeometry::Attribute::F32Type);
 
-    const auto stride = m_meshGeometry->stride();
-    const auto numVertices = vertexBuffer.size() / stride;
+    source.stride = m_meshGeometry->stride();
+    source.posOffset = vertexAttribute.offset;
 
-    physx::PxConvexMeshDesc convexDesc;
-    convexDesc.points.count = numVertices;
-    convexDesc.points.stride = stride;
-    convexDesc.points.data = vertexBuffer.constData() + vertexAttribute.offset;
-    convexDesc.flags = physx::PxConvexFlag::eCOMPUTE_CONVEX;
+    source.indexData = m_meshGeometry->indexData();
+    if (source.indexData.size()) {
+        const auto indexAttribute =
+                attributeBySemantic(m_meshGeometry, QQuick3DGeometry::Attribute::IndexSemantic);
+        Q_ASSERT(indexAttribute.componentType == QQuick3DGeometry::Attribute::U16Type
+                 || indexAttribute.componentType == QQuick3DGeometry::Attribute::U32Type);
+        source.u16Indices = indexAttribute.componentType == QQuick3DGeometry::Attribute::U16Type;
+    }
 
-    // NOTE: Since we are making a mesh for the convex hull and are only
-    // interested in the positions we can Skip the index array.
+    return source;
+}
 
-    const auto cooking = QPhysicsWorld::getCooking();
-    physx::PxDefaultMemoryOutputStream buf;
-    physx::PxConvexMeshCookingResult::Enum result;
-    if (cooking && cooking->cookConvexMesh(convexDesc, buf, &result)) {
-        auto size = buf.getSize();
-        auto *data = buf.getData();
-        physx::PxDefaultMemoryInputData input(data, size);
-        m_convexMesh = QPhysicsWorld::getPhysics()->createConvexMesh(input);
-        qCDebug(lcQuick3dPhysics) << "Created convex mesh" << m_convexMesh << "for mesh" << this;
-    } else {
-        qCWarning(lcQuick3dPhysics) << "Could not create convex mesh for" << this;
+physx::PxConvexMesh *QQuick3DPhysicsMesh::convexMesh(const QCookingParameters::Settings &settings)
+{
+    CookedMeshes &cooked = cookedMeshes(settings);
+    if (cooked.convexMesh != nullptr)
+        return cooked.convexMesh;
+
+    physx::PxPhysics *thePhysics = QPhysicsWorld::getPhysics();
+    if (thePhysics == nullptr)
+        return nullptr;
+
+    if (cooked.cookingFutures[Convex].isValid()) {
+        const QByteArray data = cooked.cookingFutures[Convex].result();
+        cooked.cookingFutures[Convex] = QFuture<QByteArray>();
+        if (data.isEmpty())
+            return nullptr;
+        if (QCacheUtils::isSerializedCollection(data)) {
+            cooked.convexMesh = QCacheUtils::readCookedConvexMesh(m_meshPath, *thePhysics);
+            return cooked.convexMesh;
+        }
+        physx::PxDefaultMemoryInputData input(
+                reinterpret_cast<physx::PxU8 *>(const_cast<char *>(data.constData())),
+                physx::PxU32(data.size()));
+        cooked.convexMesh = thePhysics->createConvexMesh(input);
+        qCDebug(lcQuick3dPhysics) << "Created convex mesh" << cooked.convexMesh << "for mesh"
+                                  << this;
+        return cooked.convexMesh;
     }
 
-    return m_convexMesh;
+    if (m_meshGeometry)
+        cooked.convexMesh = convexMeshGeometrySource(settings);
+    else if (!m_meshPath.isEmpty())
+        cooked.convexMesh = convexMeshQmlSource(settings);
+    return cooked.convexMesh;
 }
 
-physx::PxTriangleMesh *QQuick3DPhysicsMesh::triangleMeshQmlSource()
+physx::PxTriangleMesh *
+QQuick3DPhysicsMesh::triangleMesh(const QCookingParameters::Settings &settings)
 {
+    CookedMeshes &cooked = cookedMeshes(settings);
+    if (cooked.triangleMesh != nullptr)
+        return cooked.triangleMesh;
+
     physx::PxPhysics *thePhysics = QPhysicsWorld::getPhysics();
+    if (thePhysics == nullptr)
+        return nullptr;
 
-    m_triangleMesh = QCacheUtils::readCachedTriangleMesh(m_meshPath, *thePhysics);
-    if (m_triangleMesh != nullptr)
-        return m_triangleMesh;
+    if (cooked.cookingFutures[Triangle].isValid()) {
+        const QByteArray data = cooked.cookingFutures[Triangle].result();
+        cooked.cookingFutures[Triangle] = QFuture<QByteArray>();
+        if (data.isEmpty())
+            return nullptr;
+        if (QCacheUtils::isSerializedCollection(data)) {
+            cooked.triangleMesh = QCacheUtils::readCookedTriangleMesh(m_meshPath, *thePhysics);
+            return cooked.triangleMesh;
+        }
+        physx::PxDefaultMemoryInputData input(
+                reinterpret_cast<physx::PxU8 *>(const_cast<char *>(data.constData())),
+                physx::PxU32(data.size()));
+        cooked.triangleMesh = thePhysics->createTriangleMesh(input);
+        qCDebug(lcQuick3dPhysics) << "Created triangle mesh" << cooked.triangleMesh << "for mesh"
+                                  << this;
+    } else if (m_meshGeometry) {
+        cooked.triangleMesh = triangleMeshGeometrySource(settings);
+    } else if (!m_meshPath.isEmpty()) {
+        cooked.triangleMesh = triangleMeshQmlSource(settings);
+    }
 
-    m_triangleMesh = QCacheUtils::readCookedTriangleMesh(m_meshPath, *thePhysics);
-    if (m_triangleMesh != nullptr)
-        return m_triangleMesh;
+    if (m_meshGeometry && cooked.triangleMesh)
+        cooked.triangleIndexData = m_meshGeometry->indexData();
+    return cooked.triangleMesh;
+}
 
-    loadSsgMesh();
-    if (!m_ssgMesh.isValid())
+physx::PxTriangleMesh *
+QQuick3DPhysicsMesh::refittableTriangleMesh(const QCookingParameters::Settings &settings,
+                                            const CookingSource &source) const
+{
+    // Only the BVH33 mid-phase structure can be refitted
+    if (!m_meshGeometry || settings.midPhase != QCookingParameters::MidPhase::BVH33)
         return nullptr;
 
-    auto vertexBuffer = m_ssgMesh.vertexBuffer().data;
+    const CookedMeshes *cooked = findCookedMeshes(settings);
+    if (!cooked || !cooked->triangleMesh || source.stride <= 0)
+        return nullptr;
 
-    const int posOffset = m_posOffset;
-    const auto stride =  m_ssgMesh.vertexBuffer().stride;
-    const auto numVertices = vertexBuffer.size() / stride;
+    // The topology has to be the same. Without mesh cleaning the cooked vertices map one to one
+    // to the vertices of the geometry.
+    const qsizetype vertexCount = source.vertexData.size() / source.stride;
+    if (qsizetype(cooked->triangleMesh->getNbVertices()) != vertexCount
+        || source.indexData != cooked->triangleIndexData) {
+        return nullptr;
+    }
+    return cooked->triangleMesh;
+}
 
-    physx::PxTriangleMeshDesc triangleDesc;
-    triangleDesc.points.count = numVertices;
-    triangleDesc.points.stride = stride;
-    triangleDesc.points.data = vertexBuffer.constData() + posOffset;
-
-    auto indexBuffer = m_ssgMesh.indexBuffer().data;
-    if (indexBuffer.size()) {
-        const bool u16IndexType =
-                m_ssgMesh.indexBuffer().componentType == QSSGMesh::Mesh::ComponentType::UnsignedInt16;
-
-        Q_ASSERT(m_ssgMesh.indexBuffer().componentType
-                         == QSSGMesh::Mesh::ComponentType::UnsignedInt16
-                 || m_ssgMesh.indexBuffer().componentType
-                         == QSSGMesh::Mesh::ComponentType::UnsignedInt32);
-
-        triangleDesc.triangles.data = indexBuffer.constData();
-        if (u16IndexType) {
-            triangleDesc.flags.set(physx::PxMeshFlag::e16_BIT_INDICES);
-            triangleDesc.triangles.stride = sizeof(quint16) * 3;
-        } else {
-            triangleDesc.triangles.stride = sizeof(quint32) * 3;
-        }
-        triangleDesc.triangles.count = indexBuffer.size() / triangleDesc.triangles.stride;
+bool QQuick3DPhysicsMesh::requestRefit(const QCookingParameters::Settings &settings)
+{
+    if (!refittableTriangleMesh(settings, geometryCookingSource()))
+        return false;
+
+    if (!m_pendingRefits.contains(settings))
+        m_pendingRefits.append(settings);
+    QQuick3DPhysicsMeshManager::pendingRefitMeshes.insert(this);
+    return true;
+}
+
+bool QQuick3DPhysicsMesh::applyPendingRefits()
+{
+    bool refitted = false;
+    const CookingSource source = geometryCookingSource();
+    for (const auto &settings : std::as_const(m_pendingRefits)) {
+        // The geometry may have changed again since the refit was requested
+        physx::PxTriangleMesh *triangleMesh = refittableTriangleMesh(settings, source);
+        if (!triangleMesh)
+            continue;
+
+        physx::PxVec3 *vertices = triangleMesh->getVerticesForModification();
+        const char *positions = source.vertexData.constData() + source.posOffset;
+        const qsizetype vertexCount = triangleMesh->getNbVertices();
+        for (qsizetype i = 0; i < vertexCount; ++i)
+            memcpy(&vertices[i], positions + i * source.stride, sizeof(physx::PxVec3));
+        triangleMesh->refitBVH();
+        refitted = true;
+
+        qCDebug(lcQuick3dPhysics) << "Refitted triangle mesh" << triangleMesh << "for mesh"
+                                  << this;
     }
+    m_pendingRefits.clear();
+    return refitted;
+}
+
+physx::PxConvexMesh *
+QQuick3DPhysicsMesh::convexMeshQmlSource(const QCookingParameters::Settings &settings)
+{
+    physx::PxPhysics *thePhysics = QPhysicsWorld::getPhysics();
+
+    physx::PxConvexMesh *convexMesh =
+            QCacheUtils::readCachedConvexMesh(m_meshPath, *thePhysics, settings);
+    if (convexMesh != nullptr)
+        return convexMesh;
+
+    convexMesh = QCacheUtils::readCookedConvexMesh(m_meshPath, *thePhysics);
+    if (convexMesh != nullptr)
+        return convexMesh;
+
+    loadMeshData();
+
+    if (!m_meshData.isValid())
+        return nullptr;
+
+    qCDebug(lcQuick3dPhysics) << "prepare cooking" << m_meshData.vertexCount() << "verts";
 
     physx::PxDefaultMemoryOutputStream buf;
-    physx::PxTriangleMeshCookingResult::Enum result;
-    const auto cooking = QPhysicsWorld::getCooking();
-    if (cooking && cooking->cookTriangleMesh(triangleDesc, buf, &result)) {
+    if (cookConvexMesh(meshDataCookingSource(m_meshData), settings, buf)) {
         auto size = buf.getSize();
         auto *data = buf.getData();
         physx::PxDefaultMemoryInputData input(data, size);
-        m_triangleMesh = thePhysics->createTriangleMesh(input);
-        qCDebug(lcQuick3dPhysics) << "Created triangle mesh" << m_triangleMesh << "for mesh"
-                                  << this;
-        QCacheUtils::writeCachedTriangleMesh(m_meshPath, buf);
+        convexMesh = thePhysics->createConvexMesh(input);
+        qCDebug(lcQuick3dPhysics) << "Created convex mesh" << convexMesh << "for mesh" << this;
+        QCacheUtils::writeCachedConvexMesh(m_meshPath, buf, settings);
     } else {
-        qCWarning(lcQuick3dPhysics) << "Could not create triangle mesh from" << m_meshPath;
+        qCWarning(lcQuick3dPhysics) << "Could not create convex mesh from" << m_meshPath;
     }
 
-    return m_triangleMesh;
+    return convexMesh;
 }
 
-physx::PxTriangleMesh *QQuick3DPhysicsMesh::triangleMeshGeometrySource()
+physx::PxConvexMesh *
+QQuick3DPhysicsMesh::convexMeshGeometrySource(const QCookingParameters::Settings &settings)
 {
-    auto vertexBuffer = m_meshGeometry->vertexData();
-
-    if (m_meshGeometry->primitiveType() != QQuick3DGeometry::PrimitiveType::Triangles) {
-        qWarning() << "QQuick3DPhysicsMesh: Invalid geometry primitive type, must be Triangles. ";
+    const CookingSource source = geometryCookingSource();
+    if (source.stride <= 0)
         return nullptr;
-    }
 
-    if (!vertexBuffer.size()) {
-        qWarning() << "QQuick3DPhysicsMesh: Invalid geometry, vertexData is empty. ";
-        return nullptr;
+    physx::PxConvexMesh *convexMesh = nullptr;
+    physx::PxDefaultMemoryOutputStream buf;
+    if (cookConvexMesh(source, settings, buf)) {
+        auto size = buf.getSize();
+        auto *data = buf.getData();
+        physx::PxDefaultMemoryInputData input(data, size);
+        convexMesh = QPhysicsWorld::getPhysics()->createConvexMesh(input);
+        qCDebug(lcQuick3dPhysics) << "Created convex mesh" << convexMesh << "for mesh" << this;
+    } else {
+        qCWarning(lcQuick3dPhysics) << "Could not create convex mesh for" << this;
     }
 
-    const auto vertexAttribute =
-            attributeBySemantic(m_meshGeometry, QQuick3DGeometry::Attribute::PositionSemantic);
-    Q_ASSERT(vertexAttribute.componentType == QQuick3DGeometry::Attribute::F32Type);
-
-    const int posOffset = vertexAttribute.offset;
-    const auto stride = m_meshGeometry->stride();
-    const auto numVertices = vertexBuffer.size() / stride;
+    return convexMesh;
+}
 
-    physx::PxTriangleMeshDesc triangleDesc;
-    triangleDesc.points.count = numVertices;
-    triangleDesc.points.stride = stride;
-    triangleDesc.points.data = vertexBuffer.constData() + posOffset;
+physx::PxTriangleMesh *
+QQuick3DPhysicsMesh::triangleMeshQmlSource(const QCookingParameters::Settings &settings)
+{
+    physx::PxPhysics *thePhysics = QPhysicsWorld::getPhysics();
 
-    auto indexBuffer = m_meshGeometry->indexData();
-    if (indexBuffer.size()) {
-        const auto indexAttribute =
-                attributeBySemantic(m_meshGeometry, QQuick3DGeometry::Attribute::IndexSemantic);
-        const bool u16IndexType =
-                indexAttribute.componentType == QQuick3DGeometry::Attribute::U16Type;
+    physx::PxTriangleMesh *triangleMesh =
+            QCacheUtils::readCachedTriangleMesh(m_meshPath, *thePhysics, settings);
+    if (triangleMesh != nullptr)
+        return triangleMesh;
 
-        Q_ASSERT(indexAttribute.componentType == QQuick3DGeometry::Attribute::U16Type
-                 || indexAttribute.componentType == QQuick3DGeometry::Attribute::U32Type);
+    triangleMesh = QCacheUtils::readCookedTriangleMesh(m_meshPath, *thePhysics);
+    if (triangleMesh != nullptr)
+        return triangleMesh;
 
-        triangleDesc.triangles.data = indexBuffer.constData();
-        if (u16IndexType) {
-            triangleDesc.flags.set(physx::PxMeshFlag::e16_BIT_INDICES);
-            triangleDesc.triangles.stride = sizeof(quint16) * 3;
-        } else {
-            triangleDesc.triangles.stride = sizeof(quint32) * 3;
-        }
-        triangleDesc.triangles.count = indexBuffer.size() / triangleDesc.triangles.stride;
-    }
+    loadMeshData();
+    if (!m_meshData.isValid())
+        return nullptr;
 
     physx::PxDefaultMemoryOutputStream buf;
-    physx::PxTriangleMeshCookingResult::Enum result;
-    const auto cooking = QPhysicsWorld::getCooking();
-    if (cooking && cooking->cookTriangleMesh(triangleDesc, buf, &result)) {
+    if (cookTriangleMesh(meshDataCookingSource(m_meshData), settings, buf)) {
         auto size = buf.getSize();
         auto *data = buf.getData();
         physx::PxDefaultMemoryInputData input(data, size);
-        m_triangleMesh = QPhysicsWorld::getPhysics()->createTriangleMesh(input);
-        qCDebug(lcQuick3dPhysics) << "Created triangle mesh" << m_triangleMesh << "for mesh"
+        triangleMesh = thePhysics->createTriangleMesh(input);
+        qCDebug(lcQuick3dPhysics) << "Created triangle mesh" << triangleMesh << "for mesh"
                                   << this;
+        QCacheUtils::writeCachedTriangleMesh(m_meshPath, buf, settings);
     } else {
-        qCWarning(lcQuick3dPhysics) << "Could not create triangle mesh for" << this;
+        qCWarning(lcQuick3dPhysics) << "Could not create triangle mesh from" << m_meshPath;
     }
 
-    return m_triangleMesh;
+    return triangleMesh;
 }
 
-void QQuick3DPhysicsMesh::loadSsgMesh()
+physx::PxTriangleMesh *
+QQuick3DPhysicsMesh::triangleMeshGeometrySource(const QCookingParameters::Settings &settings)
 {
-    if (m_ssgMesh.isValid())
-        return;
-
-    static const char *compTypes[] = { "Null",  "UnsignedInt8",  "Int8",    "UnsignedInt16",
-                                       "Int16", "UnsignedInt32", "Int32",   "UnsignedInt64",
-                                       "Int64", "Float16",       "Float32", "Float64" };
-
-    QFileInfo fileInfo = QFileInfo(m_meshPath);
-    if (fileInfo.exists()) {
-        QFile file(fileInfo.absoluteFilePath());
-        if (file.open(QFile::ReadOnly))
-            m_ssgMesh = QSSGMesh::Mesh::loadMesh(&file);
-    }
-    qCDebug(lcQuick3dPhysics) << "Loaded SSG mesh from" << m_meshPath << m_ssgMesh.isValid()
-                              << "draw" << int(m_ssgMesh.drawMode()) << "wind"
-                              << int(m_ssgMesh.winding()) << "subs" << m_ssgMesh.subsets().count()
-                              << "attrs" << m_ssgMesh.vertexBuffer().entries.count()
-                              << m_ssgMesh.vertexBuffer().data.size() << "stride"
-                              << m_ssgMesh.vertexBuffer().stride << "verts"
-                              << m_ssgMesh.vertexBuffer().data.size()
-                    / m_ssgMesh.vertexBuffer().stride;
-
-    for (auto &v : m_ssgMesh.vertexBuffer().entries) {
-        qCDebug(lcQuick3dPhysics) << "  attr" << v.name << compTypes[int(v.componentType)] << "cc"
-                                  << v.componentCount << "offs" << v.offset;
-        Q_ASSERT(v.componentType == QSSGMesh::Mesh::ComponentType::Float32);
-        if (v.name == "attr_pos")
-            m_posOffset = v.offset;
-    }
+    const CookingSource source = geometryCookingSource();
+    if (source.stride <= 0)
+        return nullptr;
 
-    if (m_ssgMesh.isValid()) {
-        auto sub = m_ssgMesh.subsets().constFirst();
-        qCDebug(lcQuick3dPhysics) << "..." << sub.name << "count" << sub.count << "bounds"
-                                  << sub.bounds.min << sub.bounds.max << "offset" << sub.offset;
+    physx::PxTriangleMesh *triangleMesh = nullptr;
+    physx::PxDefaultMemoryOutputStream buf;
+    if (cookTriangleMesh(source, settings, buf)) {
+        auto size = buf.getSize();
+        auto *data = buf.getData();
+        physx::PxDefaultMemoryInputData input(data, size);
+        triangleMesh = QPhysicsWorld::getPhysics()->createTriangleMesh(input);
+        qCDebug(lcQuick3dPhysics) << "Created triangle mesh" << triangleMesh << "for mesh"
+                                  << this;
+    } else {
+        qCWarning(lcQuick3dPhysics) << "Could not create triangle mesh for" << this;
     }
 
-#if 0 // EXTRA_DEBUG
-
-    int iStride = m_ssgMesh.indexBuffer().componentType == QSSGMesh::Mesh::ComponentType::UnsignedInt16 ? 2 : 4;
-    int vStride = m_ssgMesh.vertexBuffer().stride;
-    qDebug() << "IDX" << compTypes[int(m_ssgMesh.indexBuffer().componentType)] << m_ssgMesh.indexBuffer().data.size() / iStride;
-    const auto ib = m_ssgMesh.indexBuffer().data;
-    const auto vb = m_ssgMesh.vertexBuffer().data;
+    return triangleMesh;
+}
 
-    auto getPoint = [&vb, vStride, this](int idx) -> QVector3D {
-        auto *vp = vb.constData() + vStride * idx + m_posOffset;
-        return *reinterpret_cast<const QVector3D *>(vp);
-        return {};
-    };
+void QQuick3DPhysicsMesh::loadMeshData()
+{
+    if (m_meshData.isValid())
+        return;
 
-    if (iStride == 2) {
+    QFile file(m_meshPath);
+    if (file.open(QFile::ReadOnly))
+        m_meshData = QPhysicsMeshReader::readMesh(&file);
 
+    if (m_meshData.isValid()) {
+        qCDebug(lcQuick3dPhysics) << "Loaded mesh from" << m_meshPath << "verts"
+                                  << m_meshData.vertexCount() << "indices"
+                                  << m_meshData.indices.size() / (m_meshData.u16Indices ? 2 : 4)
+                                  << "bounds" << m_meshData.boundsMin << m_meshData.boundsMax;
     } else {
-        auto *ip = reinterpret_cast<const uint32_t *>(ib.data());
-        int n = ib.size() / iStride;
-        for (int i = 0; i < qMin(50,n); i += 3) {
-
-            qDebug() << "    " << ip [i] << ip[i+1] << ip[i+2] << " --- "
-                     << getPoint(ip[i]) << getPoint(ip[i+1]) << getPoint(ip[i+2]);
-        }
-    }
-#endif
-    if (!m_ssgMesh.isValid())
         qCWarning(lcQuick3dPhysics) << "Could not read mesh from" << m_meshPath;
+    }
 }
 
 QQuick3DPhysicsMesh *QQuick3DPhysicsMeshManager::getMesh(const QUrl &source,
@@ -389,12 +589,41 @@ QQuick3DPhysicsMesh *QQuick3DPhysicsMeshManager::getMesh(QQuick3DGeometry *sourc
     return mesh;
 }
 
+QFuture<QByteArray> QQuick3DPhysicsMeshManager::runCookingJob(std::function<QByteArray()> job)
+{
+    auto promise = std::make_shared<QPromise<QByteArray>>();
+    QFuture<QByteArray> future = promise->future();
+    cookingThreadPool->start([promise, job = std::move(job)] {
+        promise->start();
+        promise->addResult(job());
+        promise->finish();
+    });
+    return future;
+}
+
+void QQuick3DPhysicsMeshManager::waitForCooking()
+{
+    cookingThreadPool->waitForDone();
+}
+
+QSet<QQuick3DPhysicsMesh *> QQuick3DPhysicsMeshManager::applyPendingRefits()
+{
+    QSet<QQuick3DPhysicsMesh *> refittedMeshes;
+    for (auto *mesh : std::as_const(pendingRefitMeshes)) {
+        if (mesh->applyPendingRefits())
+            refittedMeshes.insert(mesh);
+    }
+    pendingRefitMeshes.clear();
+    return refittedMeshes;
+}
+
 void QQuick3DPhysicsMeshManager::releaseMesh(QQuick3DPhysicsMesh *mesh)
 {
     if (mesh == nullptr || mesh->deref() > 0)
         return;
 
     qCDebug(lcQuick3dPhysics()) << "deleting mesh" << mesh;
+    pendingRefitMeshes.remove(mesh);
     erase_if(sourceMeshHash, [mesh](std::pair<const QString &, QQuick3DPhysicsMesh *&> h) {
         return h.second == mesh;
     });
@@ -406,20 +635,26 @@ void QQuick3DPhysicsMeshManager::releaseMesh(QQuick3DPhysicsMesh *mesh)
 
 QHash<QString, QQuick3DPhysicsMesh *> QQuick3DPhysicsMeshManager::sourceMeshHash;
 QHash<QQuick3DGeometry *, QQuick3DPhysicsMesh *> QQuick3DPhysicsMeshManager::geometryMeshHash;
+QSet<QQuick3DPhysicsMesh *> QQuick3DPhysicsMeshManager::pendingRefitMeshes;
 
 /////////////////////////////////////////////////////////////////////////////
 
 QMeshShape::~QMeshShape()
 {
     delete m_convexGeometry;
-    if (m_mesh)
+    delete m_placeholderGeometry;
+    if (m_mesh) {
+        releaseMeshSettings();
         QQuick3DPhysicsMeshManager::releaseMesh(m_mesh);
+    }
 }
 
 physx::PxGeometry *QMeshShape::getPhysXGeometry()
 {
     if (m_dirtyPhysx || m_scaleDirty)
         updatePhysXGeometry();
+    if (m_placeholderGeometry)
+        return m_placeholderGeometry;
     if (shapeType() == MeshType::CONVEX)
         return m_convexGeometry;
     if (shapeType() == MeshType::TRIANGLE)
@@ -428,18 +663,69 @@ physx::PxGeometry *QMeshShape::getPhysXGeometry()
     Q_UNREACHABLE_RETURN(nullptr);
 }
 
+QFuture<QByteArray> QMeshShape::cookAsync()
+{
+    // Asynchronous shapes do not hold up the world, they use a placeholder instead
+    if (!m_mesh || m_asynchronous)
+        return QFuture<QByteArray>();
+
+    const auto type = shapeType() == MeshType::CONVEX ? QQuick3DPhysicsMesh::Convex
+                                                      : QQuick3DPhysicsMesh::Triangle;
+    const QCookingParameters::Settings settings = cookingSettings();
+    if (m_mesh->isCooked(type, settings))
+        return QFuture<QByteArray>();
+    return m_mesh->cookAsync(type, settings);
+}
+
 void QMeshShape::updatePhysXGeometry()
 {
     delete m_convexGeometry;
     delete m_triangleGeometry;
+    delete m_placeholderGeometry;
     m_convexGeometry = nullptr;
     m_triangleGeometry = nullptr;
+    m_placeholderGeometry = nullptr;
+    // Reference the new settings before the old ones so that meshes used by both are kept
+    const QCookingParameters::Settings settings = cookingSettings();
+    if (m_mesh)
+        m_mesh->refSettings(settings);
+    releaseMeshSettings();
+    m_meshSettingsReferenced = m_mesh != nullptr;
+    m_cookedSettings = settings;
 
-    if (!m_mesh)
+    if (!m_mesh) {
+        setReady(true);
         return;
+    }
 
-    auto *convexMesh = shapeType() == MeshType::CONVEX ? m_mesh->convexMesh() : nullptr;
-    auto *triangleMesh = shapeType() == MeshType::TRIANGLE ? m_mesh->triangleMesh() : nullptr;
+    if (m_asynchronous && startCooking()) {
+        setReady(false);
+        if (m_boundingBoxPlaceholder) {
+            QVector3D boundsMin;
+            QVector3D boundsMax;
+            if (m_geometry) {
+                boundsMin = m_geometry->boundsMin();
+                boundsMax = m_geometry->boundsMax();
+            } else {
+                const auto bounds = m_mesh->bounds();
+                boundsMin = bounds.first;
+                boundsMax = bounds.second;
+            }
+            const QVector3D halfExtents = (boundsMax - boundsMin) * sceneScale() * 0.5f;
+            if (halfExtents.x() > 0 && halfExtents.y() > 0 && halfExtents.z() > 0) {
+                m_placeholderGeometry = new physx::PxBoxGeometry(
+                        halfExtents.x(), halfExtents.y(), halfExtents.z());
+            }
+        }
+        m_dirtyPhysx = false;
+        return;
+    }
+    setReady(true);
+
+    auto *convexMesh =
+            shapeType() == MeshType::CONVEX ? m_mesh->convexMesh(m_cookedSettings) : nullptr;
+    auto *triangleMesh =
+            shapeType() == MeshType::TRIANGLE ? m_mesh->triangleMesh(m_cookedSettings) : nullptr;
     if (!convexMesh && !triangleMesh)
         return;
 
@@ -455,6 +741,47 @@ void QMeshShape::updatePhysXGeometry()
     m_dirtyPhysx = false;
 }
 
+void QMeshShape::releaseMeshSettings()
+{
+    if (m_meshSettingsReferenced)
+        m_mesh->derefSettings(m_cookedSettings);
+    m_meshSettingsReferenced = false;
+}
+
+// Returns true while the mesh of this shape is being cooked in the background
+bool QMeshShape::startCooking()
+{
+    const auto type = shapeType() == MeshType::CONVEX ? QQuick3DPhysicsMesh::Convex
+                                                      : QQuick3DPhysicsMesh::Triangle;
+    if (m_mesh->isCooked(type, m_cookedSettings))
+        return false;
+    if (m_cookingMesh == m_mesh)
+        return true;
+
+    // Cooking needs the PhysX objects created by the first physics world
+    if (StaticPhysXObjects::getReference().cooking == nullptr)
+        return false;
+
+    QQuick3DPhysicsMesh *mesh = m_mesh;
+    m_cookingMesh = mesh;
+    m_mesh->cookAsync(type, m_cookedSettings).then(this, [this, mesh](const QByteArray & /*data*/) {
+        if (m_cookingMesh != mesh)
+            return;
+        m_cookingMesh = nullptr;
+        m_dirtyPhysx = true;
+        emit needsRebuild(this);
+    });
+    return true;
+}
+
+void QMeshShape::setReady(bool ready)
+{
+    if (m_ready == ready)
+        return;
+    m_ready = ready;
+    emit readyChanged();
+}
+
 const QUrl &QMeshShape::source() const
 {
     return m_meshSource;
@@ -469,6 +796,7 @@ void QMeshShape::setSource(const QUrl &newSource)
     // If we get a new source and our mesh was from the old source
     // (meaning it was NOT from a geometry) we deref
     if (m_geometry == nullptr) {
+        releaseMeshSettings();
         QQuick3DPhysicsMeshManager::releaseMesh(m_mesh);
         m_mesh = nullptr;
     }
@@ -505,6 +833,7 @@ void QMeshShape::setGeometry(QQuick3DGeometry *newGeometry)
     }
 
     // New geometry means we get a new mesh so deref the old one
+    releaseMeshSettings();
     QQuick3DPhysicsMeshManager::releaseMesh(m_mesh);
     m_mesh = nullptr;
     if (m_geometry != nullptr)
@@ -518,6 +847,108 @@ void QMeshShape::setGeometry(QQuick3DGeometry *newGeometry)
     emit geometryChanged();
 }
 
+bool QMeshShape::asynchronous() const
+{
+    return m_asynchronous;
+}
+
+void QMeshShape::setAsynchronous(bool newAsynchronous)
+{
+    if (m_asynchronous == newAsynchronous)
+        return;
+    m_asynchronous = newAsynchronous;
+    emit asynchronousChanged();
+}
+
+bool QMeshShape::boundingBoxPlaceholder() const
+{
+    return m_boundingBoxPlaceholder;
+}
+
+void QMeshShape::setBoundingBoxPlaceholder(bool newBoundingBoxPlaceholder)
+{
+    if (m_boundingBoxPlaceholder == newBoundingBoxPlaceholder)
+        return;
+    m_boundingBoxPlaceholder = newBoundingBoxPlaceholder;
+
+    if (!m_ready) {
+        m_dirtyPhysx = true;
+        emit needsRebuild(this);
+    }
+    emit boundingBoxPlaceholderChanged();
+}
+
+bool QMeshShape::isReady() const
+{
+    return m_ready;
+}
+
+QCookingParameters *QMeshShape::cookingParameters() const
+{
+    return m_cookingParameters;
+}
+
+void QMeshShape::setCookingParameters(QCookingParameters *newCookingParameters)
+{
+    if (m_cookingParameters == newCookingParameters)
+        return;
+    if (m_cookingParameters)
+        m_cookingParameters->disconnect(this);
+
+    m_cookingParameters = newCookingParameters;
+
+    if (m_cookingParameters != nullptr) {
+        connect(m_cookingParameters, &QObject::destroyed, this,
+                &QMeshShape::cookingParametersDestroyed);
+        connect(m_cookingParameters, &QCookingParameters::settingsChanged, this,
+                &QMeshShape::updateCookingSettings);
+    }
+
+    updateCookingSettings();
+    emit cookingParametersChanged();
+}
+
+QCookingParameters::Settings QMeshShape::cookingSettings() const
+{
+    QCookingParameters::Settings settings;
+    if (m_cookingParameters) {
+        settings = m_cookingParameters->settings();
+    } else if (auto *world = QPhysicsWorld::getWorld(const_cast<QMeshShape *>(this))) {
+        // Note: const_cast since getWorld only walks up the parents
+        if (auto *worldParameters = world->cookingParameters())
+            settings = worldParameters->settings();
+    }
+
+    if (m_refitGeometry && shapeType() == MeshType::TRIANGLE) {
+        // Refitting needs the BVH33 structure and vertices that map one to one to the geometry
+        settings.midPhase = QCookingParameters::MidPhase::BVH33;
+        settings.cleanMesh = false;
+        settings.weldTolerance = 0.f;
+    }
+    return settings;
+}
+
+void QMeshShape::updateCookingSettings()
+{
+    if (cookingSettings() == m_cookedSettings)
+        return;
+    // The old cooking result is of no interest anymore
+    m_cookingMesh = nullptr;
+    m_dirtyPhysx = true;
+    emit needsRebuild(this);
+}
+
+QQuick3DPhysicsMesh *QMeshShape::physicsMesh() const
+{
+    return m_mesh;
+}
+
+void QMeshShape::cookingParametersDestroyed(QObject *cookingParameters)
+{
+    Q_ASSERT(m_cookingParameters == cookingParameters);
+    setCookingParameters(nullptr);
+}
+
 void QMeshShape::geometryDestroyed(QObject *geometry)
 {
     Q_ASSERT(m_geometry == geometry);
@@ -528,6 +959,15 @@ void QMeshShape::geometryDestroyed(QObject *geometry)
 void QMeshShape::geometryContentChanged()
 {
     Q_ASSERT(m_geometry != nullptr);
+
+    // The mesh is refitted by the physics world between two frames, which then updates the
+    // shapes of all bodies using it
+    if (m_refitGeometry && m_triangleGeometry && !m_dirtyPhysx && m_mesh
+        && m_mesh->requestRefit(m_cookedSettings)) {
+        return;
+    }
+
+    releaseMeshSettings();
     QQuick3DPhysicsMeshManager::releaseMesh(m_mesh);
     m_mesh = QQuick3DPhysicsMeshManager::getMesh(m_geometry);
 
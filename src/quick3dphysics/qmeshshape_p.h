@@ -17,6 +17,7 @@
 
 #include <QtQuick3DPhysics/qtquick3dphysicsglobal.h>
 #include <QtQuick3DPhysics/private/qabstractcollisionshape_p.h>
+#include <QtQuick3DPhysics/private/qcookingparameters_p.h>
 #include <QtCore/QObject>
 #include <QtGui/QVector3D>
 #include <QtQml/QQmlEngine>
@@ -39,6 +40,14 @@ class Q_QUICK3DPHYSICS_EXPORT QMeshShape : public QAbstractCollisionShape
     Q_PROPERTY(QUrl source READ source WRITE setSource NOTIFY sourceChanged REVISION(6, 5))
     Q_PROPERTY(QQuick3DGeometry *geometry READ geometry WRITE setGeometry NOTIFY geometryChanged
                        REVISION(6, 7))
+    Q_PROPERTY(bool asynchronous READ asynchronous WRITE setAsynchronous NOTIFY
+                       asynchronousChanged REVISION(6, 9))
+    Q_PROPERTY(bool boundingBoxPlaceholder READ boundingBoxPlaceholder WRITE
+                       setBoundingBoxPlaceholder NOTIFY boundingBoxPlaceholderChanged
+                       REVISION(6, 9))
+    Q_PROPERTY(bool ready READ isReady NOTIFY readyChanged REVISION(6, 9))
+    Q_PROPERTY(QCookingParameters *cookingParameters READ cookingParameters WRITE
+                       setCookingParameters NOTIFY cookingParametersChanged REVISION(6, 9))
     QML_NAMED_ELEMENT(MeshShape)
     QML_UNCREATABLE("abstract interface")
 
@@ -49,29 +58,68 @@ public:
     virtual MeshType shapeType() const = 0;
 
     physx::PxGeometry *getPhysXGeometry() override;
+    QFuture<QByteArray> cookAsync() override;
 
     Q_REVISION(6, 5) const QUrl &source() const;
     Q_REVISION(6, 5) void setSource(const QUrl &newSource);
     Q_REVISION(6, 7) QQuick3DGeometry *geometry() const;
     Q_REVISION(6, 7) void setGeometry(QQuick3DGeometry *newGeometry);
+    Q_REVISION(6, 9) bool asynchronous() const;
+    Q_REVISION(6, 9) void setAsynchronous(bool newAsynchronous);
+    Q_REVISION(6, 9) bool boundingBoxPlaceholder() const;
+    Q_REVISION(6, 9) void setBoundingBoxPlaceholder(bool newBoundingBoxPlaceholder);
+    Q_REVISION(6, 9) bool isReady() const;
+    Q_REVISION(6, 9) QCookingParameters *cookingParameters() const;
+    Q_REVISION(6, 9) void setCookingParameters(QCookingParameters *newCookingParameters);
+
+    // The settings the mesh is cooked with: the parameters of the shape, or else the ones of the
+    // physics world
+    QCookingParameters::Settings cookingSettings() const;
+    // Called by the physics world when the cooking parameters of the world changed
+    void updateCookingSettings();
+    // The shared mesh the geometry of the shape is created from
+    QQuick3DPhysicsMesh *physicsMesh() const;
 
 signals:
     Q_REVISION(6, 5) void sourceChanged();
     Q_REVISION(6, 7) void geometryChanged();
+    Q_REVISION(6, 9) void asynchronousChanged();
+    Q_REVISION(6, 9) void boundingBoxPlaceholderChanged();
+    Q_REVISION(6, 9) void readyChanged();
+    Q_REVISION(6, 9) void cookingParametersChanged();
+
+protected:
+    // Set by TriangleMeshShape when changed geometries are refitted instead of cooked again
+    bool m_refitGeometry = false;
 
 private slots:
     void geometryDestroyed(QObject *geometry);
     void geometryContentChanged();
+    void cookingParametersDestroyed(QObject *cookingParameters);
 
 private:
     void updatePhysXGeometry();
+    bool startCooking();
+    void setReady(bool ready);
+    void releaseMeshSettings();
 
     bool m_dirtyPhysx = false;
     physx::PxConvexMeshGeometry *m_convexGeometry = nullptr;
     physx::PxTriangleMeshGeometry *m_triangleGeometry = nullptr;
+    physx::PxBoxGeometry *m_placeholderGeometry = nullptr;
+    // The mesh that is being cooked in the background for this shape
+    QQuick3DPhysicsMesh *m_cookingMesh = nullptr;
+    bool m_asynchronous = false;
+    bool m_boundingBoxPlaceholder = false;
+    bool m_ready = true;
     QUrl m_meshSource;
     QQuick3DPhysicsMesh *m_mesh = nullptr;
     QQuick3DGeometry *m_geometry = nullptr;
+    QCookingParameters *m_cookingParameters = nullptr;
+    // The settings the current geometry was cooked with
+    QCookingParameters::Settings m_cookedSettings;
+    // Whether m_mesh holds a reference to m_cookedSettings
+    bool m_meshSettingsReferenced = false;
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,307 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "qphysicsbodypool_p.h"
+
+#include "PxMaterial.h"
+#include "PxPhysics.h"
+#include "PxRigidDynamic.h"
+#include "PxScene.h"
+#include "PxShape.h"
+#include "extensions/PxRigidBodyExt.h"
+
+#include "physxnode/qphysxactorbody_p.h"
+#include "physxnode/qphysxworld_p.h"
+#include "qabstractcollisionshape_p.h"
+#include "qphysicsutils_p.h"
+#include "qphysicsworld_p.h"
+#include "qstaticphysxobjects_p.h"
+
+#include <QtCore/QVarLengthArray>
+
+QT_BEGIN_NAMESPACE
+
+QPhysicsBodyPool::QPhysicsBodyPool(QPhysicsWorld *world) : m_world(world)
+{
+    if (m_world)
+        m_world->registerBodyPool(this);
+}
+
+QPhysicsBodyPool::~QPhysicsBodyPool()
+{
+    releaseActors();
+    if (m_world)
+        m_world->deregisterBodyPool(this);
+}
+
+QPhysicsWorld *QPhysicsBodyPool::world() const
+{
+    return m_world;
+}
+
+void QPhysicsBodyPool::setWorld(QPhysicsWorld *world)
+{
+    if (m_world == world)
+        return;
+
+    // The bodies are recreated in the new world from their current state
+    if (m_world) {
+        releaseActors();
+        m_world->deregisterBodyPool(this);
+    }
+
+    m_world = world;
+
+    if (m_world)
+        m_world->registerBodyPool(this);
+}
+
+QAbstractCollisionShape *QPhysicsBodyPool::collisionShape() const
+{
+    return m_collisionShape;
+}
+
+void QPhysicsBodyPool::setCollisionShape(QAbstractCollisionShape *collisionShape)
+{
+    if (m_collisionShape == collisionShape)
+        return;
+
+    if (collisionShape && collisionShape->isStaticShape()) {
+        qWarning() << "Cannot use trimesh/heightfield/plane shapes for pooled bodies, ignoring.";
+        collisionShape = nullptr;
+    }
+
+    // When the shape is removed the current PhysX shape is kept
+    m_collisionShape = collisionShape;
+    m_shapeDirty = m_collisionShape != nullptr;
+}
+
+void QPhysicsBodyPool::markShapeDirty()
+{
+    m_shapeDirty = true;
+}
+
+void QPhysicsBodyPool::setMaterial(float staticFriction, float dynamicFriction, float restitution)
+{
+    m_staticFriction = staticFriction;
+    m_dynamicFriction = dynamicFriction;
+    m_restitution = restitution;
+    m_materialDirty = true;
+}
+
+float QPhysicsBodyPool::density() const
+{
+    return m_density;
+}
+
+void QPhysicsBodyPool::setDensity(float density)
+{
+    if (qFuzzyCompare(m_density, density))
+        return;
+    m_density = density;
+    m_massDirty = true;
+}
+
+qsizetype QPhysicsBodyPool::spawn(const QVector3D &position, const QQuaternion &rotation,
+                                  const QVector3D &linearVelocity, quint64 userId)
+{
+    // The actor is created on the next sync since the simulation might be running
+    m_actors.append(nullptr);
+    m_positions.append(position);
+    m_rotations.append(rotation.normalized());
+    m_linearVelocities.append(linearVelocity);
+    m_userIds.append(userId);
+    m_velocityDirty.append(false);
+    m_changed = true;
+    return m_positions.size() - 1;
+}
+
+void QPhysicsBodyPool::despawn(qsizetype index)
+{
+    Q_ASSERT(index >= 0 && index < size());
+
+    if (m_actors[index] && m_world)
+        m_world->releaseLater(m_actors[index]);
+
+    // Move the last body into the free slot so all arrays stay contiguous
+    const qsizetype last = size() - 1;
+    if (index != last) {
+        m_actors[index] = m_actors[last];
+        m_positions[index] = m_positions[last];
+        m_rotations[index] = m_rotations[last];
+        m_linearVelocities[index] = m_linearVelocities[last];
+        m_userIds[index] = m_userIds[last];
+        m_velocityDirty[index] = m_velocityDirty[last];
+    }
+    m_actors.removeLast();
+    m_positions.removeLast();
+    m_rotations.removeLast();
+    m_linearVelocities.removeLast();
+    m_userIds.removeLast();
+    m_velocityDirty.removeLast();
+    m_changed = true;
+}
+
+void QPhysicsBodyPool::clear()
+{
+    if (m_positions.isEmpty())
+        return;
+
+    if (m_world) {
+        for (auto *actor : std::as_const(m_actors)) {
+            if (actor)
+                m_world->releaseLater(actor);
+        }
+    }
+
+    m_actors.clear();
+    m_positions.clear();
+    m_rotations.clear();
+    m_linearVelocities.clear();
+    m_userIds.clear();
+    m_velocityDirty.clear();
+    m_changed = true;
+}
+
+void QPhysicsBodyPool::reserve(qsizetype size)
+{
+    m_actors.reserve(size);
+    m_positions.reserve(size);
+    m_rotations.reserve(size);
+    m_linearVelocities.reserve(size);
+    m_userIds.reserve(size);
+    m_velocityDirty.reserve(size);
+}
+
+void QPhysicsBodyPool::setLinearVelocity(qsizetype index, const QVector3D &linearVelocity)
+{
+    Q_ASSERT(index >= 0 && index < size());
+    m_linearVelocities[index] = linearVelocity;
+    m_velocityDirty[index] = true;
+}
+
+bool QPhysicsBodyPool::takeChanged()
+{
+    const bool changed = m_changed;
+    m_changed = false;
+    return changed;
+}
+
+void QPhysicsBodyPool::sync(QPhysXWorld *physX)
+{
+    if (m_materialDirty && m_material) {
+        m_material->setStaticFriction(m_staticFriction);
+        m_material->setDynamicFriction(m_dynamicFriction);
+        m_material->setRestitution(m_restitution);
+    }
+    m_materialDirty = false;
+
+    if (m_shapeDirty && m_collisionShape)
+        rebuildShape();
+
+    if (!m_shape)
+        return;
+
+    const bool enableCCD = m_world && m_world->enableCCD();
+    const bool updateMass = m_massDirty;
+    m_massDirty = false;
+
+    QVarLengthArray<physx::PxActor *, 64> newActors;
+    const qsizetype count = size();
+
+    for (qsizetype i = 0; i < count; i++) {
+        physx::PxRigidDynamic *actor = m_actors[i];
+
+        if (!actor) {
+            actor = QPhysXActorBody::createRigidDynamic(
+                    QPhysicsUtils::toPhysXTransform(m_positions[i], m_rotations[i]));
+            actor->attachShape(*m_shape);
+            physx::PxRigidBodyExt::updateMassAndInertia(*actor, m_density);
+            if (enableCCD)
+                actor->setRigidBodyFlag(physx::PxRigidBodyFlag::eENABLE_CCD, true);
+            actor->setLinearVelocity(QPhysicsUtils::toPhysXType(m_linearVelocities[i]));
+            m_velocityDirty[i] = false;
+            m_actors[i] = actor;
+            newActors.append(actor);
+            continue;
+        }
+
+        if (updateMass)
+            physx::PxRigidBodyExt::updateMassAndInertia(*actor, m_density);
+
+        if (m_velocityDirty[i]) {
+            actor->setLinearVelocity(QPhysicsUtils::toPhysXType(m_linearVelocities[i]));
+            m_velocityDirty[i] = false;
+            continue;
+        }
+
+        // Sleeping actors have not moved since the last frame
+        if (actor->isSleeping())
+            continue;
+
+        const physx::PxTransform pose = actor->getGlobalPose();
+        m_positions[i] = QPhysicsUtils::toQtType(pose.p);
+        m_rotations[i] = QPhysicsUtils::toQtType(pose.q);
+        m_linearVelocities[i] = QPhysicsUtils::toQtType(actor->getLinearVelocity());
+        m_changed = true;
+    }
+
+    if (!newActors.isEmpty())
+        physX->scene->addActors(newActors.data(), physx::PxU32(newActors.size()));
+}
+
+void QPhysicsBodyPool::releaseActors()
+{
+    if (!m_world)
+        return;
+
+    for (auto &actor : m_actors) {
+        if (actor) {
+            m_world->releaseLater(actor);
+            actor = nullptr;
+        }
+    }
+
+    if (m_shape) {
+        m_world->releaseLater(m_shape);
+        m_shape = nullptr;
+    }
+    if (m_material) {
+        m_world->releaseLater(m_material);
+        m_material = nullptr;
+    }
+    m_shapeDirty = m_collisionShape != nullptr;
+}
+
+void QPhysicsBodyPool::rebuildShape()
+{
+    Q_ASSERT(m_collisionShape);
+
+    auto &s_physx = StaticPhysXObjects::getReference();
+    if (!m_material) {
+        m_material =
+                s_physx.physics->createMaterial(m_staticFriction, m_dynamicFriction, m_restitution);
+    }
+
+    // One non-exclusive shape is shared by all the actors
+    auto *shape = QPhysXActorBody::createShape(m_collisionShape, m_material, false, 0, 0);
+    if (!shape)
+        return;
+
+    for (auto *actor : std::as_const(m_actors)) {
+        if (!actor)
+            continue;
+        if (m_shape)
+            actor->detachShape(*m_shape);
+        actor->attachShape(*shape);
+        physx::PxRigidBodyExt::updateMassAndInertia(*actor, m_density);
+    }
+
+    if (m_shape)
+        m_shape->release();
+    m_shape = shape;
+    m_shapeDirty = false;
+    m_massDirty = false;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,112 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#ifndef PHYSICSBODYPOOL_H
+#define PHYSICSBODYPOOL_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuick3DPhysics/qtquick3dphysicsglobal.h>
+#include <QtQuick3DPhysics/private/qphysicsmaterial_p.h>
+#include <QtCore/QList>
+#include <QtCore/QPointer>
+#include <QtGui/QQuaternion>
+#include <QtGui/QVector3D>
+
+namespace physx {
+class PxMaterial;
+class PxRigidDynamic;
+class PxShape;
+}
+
+QT_BEGIN_NAMESPACE
+
+class QAbstractCollisionShape;
+class QPhysicsWorld;
+class QPhysXWorld;
+
+// A pool of dynamic bodies that share one collision shape and material. The bodies have no
+// QObject of their own; instead all per-body state is kept in parallel arrays indexed by the
+// body index. Despawning moves the last body into the freed slot, so indices are not stable
+// and userIds() should be used to identify bodies.
+class Q_QUICK3DPHYSICS_EXPORT QPhysicsBodyPool
+{
+    Q_DISABLE_COPY(QPhysicsBodyPool)
+
+public:
+    explicit QPhysicsBodyPool(QPhysicsWorld *world);
+    ~QPhysicsBodyPool();
+
+    QPhysicsWorld *world() const;
+    void setWorld(QPhysicsWorld *world);
+
+    QAbstractCollisionShape *collisionShape() const;
+    void setCollisionShape(QAbstractCollisionShape *collisionShape);
+    void markShapeDirty();
+
+    void setMaterial(float staticFriction, float dynamicFriction, float restitution);
+
+    float density() const;
+    void setDensity(float density);
+
+    qsizetype spawn(const QVector3D &position, const QQuaternion &rotation = QQuaternion(),
+                    const QVector3D &linearVelocity = QVector3D(), quint64 userId = 0);
+    void despawn(qsizetype index);
+    void clear();
+    void reserve(qsizetype size);
+
+    qsizetype size() const { return m_positions.size(); }
+
+    const QList<QVector3D> &positions() const { return m_positions; }
+    const QList<QQuaternion> &rotations() const { return m_rotations; }
+    const QList<QVector3D> &linearVelocities() const { return m_linearVelocities; }
+    const QList<quint64> &userIds() const { return m_userIds; }
+
+    void setLinearVelocity(qsizetype index, const QVector3D &linearVelocity);
+
+    // Returns true if any body was spawned, despawned or moved since the last call
+    bool takeChanged();
+
+    // Internal
+    void sync(QPhysXWorld *physX);
+    void releaseActors();
+
+private:
+    void rebuildShape();
+
+    QPointer<QPhysicsWorld> m_world;
+    QAbstractCollisionShape *m_collisionShape = nullptr;
+    float m_staticFriction = QPhysicsMaterial::defaultStaticFriction;
+    float m_dynamicFriction = QPhysicsMaterial::defaultDynamicFriction;
+    float m_restitution = QPhysicsMaterial::defaultRestitution;
+    float m_density = 0.001f;
+
+    // An actor is nullptr until it has been created by the next sync
+    QList<physx::PxRigidDynamic *> m_actors;
+    QList<QVector3D> m_positions;
+    QList<QQuaternion> m_rotations;
+    QList<QVector3D> m_linearVelocities;
+    QList<quint64> m_userIds;
+    // Set when the velocity was changed from the outside and needs to be applied on the next sync
+    QList<bool> m_velocityDirty;
+
+    physx::PxShape *m_shape = nullptr;
+    physx::PxMaterial *m_material = nullptr;
+    bool m_shapeDirty = true;
+    bool m_materialDirty = false;
+    bool m_massDirty = false;
+    bool m_changed = false;
+};
+
+QT_END_NAMESPACE
+
+#endif // PHYSICSBODYPOOL_H
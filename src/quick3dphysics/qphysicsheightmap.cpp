@@ -0,0 +1,170 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "qphysicsheightmap_p.h"
+
+#include <QtCore/QList>
+#include <QtGui/QImage>
+
+#include "geometry/PxHeightFieldSample.h"
+
+QT_BEGIN_NAMESPACE
+
+// The height of a pixel is the HSV value (the largest of the red, green and blue channels)
+// mapped from [0, 1] to the qint16 range. The pixels are converted one scanline at a time with
+// loops that have no branches or function calls so that the compiler can vectorize them.
+namespace {
+
+// Number of scanlines converted before they are transposed into the samples
+constexpr int blockRows = 64;
+
+using RowConverter = void (*)(const uchar *line, int width, qint16 *heights);
+
+// Same as qint16(0xffff * (value / 65535.0f - 0.5f)), which rounds towards zero on both sides
+// of the middle value
+inline qint16 heightFrom16Bit(int value)
+{
+    return qint16(value - 32767 - (value >= 32768 ? 1 : 0));
+}
+
+inline qint16 heightFromFloat(float value)
+{
+    return qint16(0xffff * (qBound(0.f, value, 1.f) - 0.5f));
+}
+
+void convertGrayscale8(const uchar *line, int width, qint16 *heights)
+{
+    for (int x = 0; x < width; ++x)
+        heights[x] = heightFrom16Bit(int(line[x]) * 257);
+}
+
+void convertGrayscale16(const uchar *line, int width, qint16 *heights)
+{
+    const auto *pixels = reinterpret_cast<const quint16 *>(line);
+    for (int x = 0; x < width; ++x)
+        heights[x] = heightFrom16Bit(pixels[x]);
+}
+
+// Format_RGB32 and Format_ARGB32, stored as 0xAARRGGBB
+void convertRgb32(const uchar *line, int width, qint16 *heights)
+{
+    const auto *pixels = reinterpret_cast<const quint32 *>(line);
+    for (int x = 0; x < width; ++x) {
+        const quint32 pixel = pixels[x];
+        const int value = qMax(qMax((pixel >> 16) & 0xff, (pixel >> 8) & 0xff), pixel & 0xff);
+        heights[x] = heightFrom16Bit(value * 257);
+    }
+}
+
+// Format_RGBX8888 and Format_RGBA8888, stored as bytes in RGBA order
+void convertRgba8888(const uchar *line, int width, qint16 *heights)
+{
+    for (int x = 0; x < width; ++x) {
+        const uchar *pixel = line + 4 * x;
+        const int value = qMax(qMax(pixel[0], pixel[1]), pixel[2]);
+        heights[x] = heightFrom16Bit(value * 257);
+    }
+}
+
+// Format_RGBX64 and Format_RGBA64
+void convertRgba64(const uchar *line, int width, qint16 *heights)
+{
+    const auto *pixels = reinterpret_cast<const quint16 *>(line);
+    for (int x = 0; x < width; ++x) {
+        const quint16 *pixel = pixels + 4 * x;
+        heights[x] = heightFrom16Bit(qMax(qMax(pixel[0], pixel[1]), pixel[2]));
+    }
+}
+
+// Format_RGBX32FPx4 and Format_RGBA32FPx4
+void convertRgba32F(const uchar *line, int width, qint16 *heights)
+{
+    const auto *pixels = reinterpret_cast<const float *>(line);
+    for (int x = 0; x < width; ++x) {
+        const float *pixel = pixels + 4 * x;
+        heights[x] = heightFromFloat(qMax(qMax(pixel[0], pixel[1]), pixel[2]));
+    }
+}
+
+// Returns the converter for the image, converting the image to a format that has one if needed
+RowConverter rowConverter(QImage &image)
+{
+    switch (image.format()) {
+    case QImage::Format_Grayscale8:
+        return convertGrayscale8;
+    case QImage::Format_Grayscale16:
+        return convertGrayscale16;
+    case QImage::Format_RGB32:
+    case QImage::Format_ARGB32:
+        return convertRgb32;
+    case QImage::Format_RGBX8888:
+    case QImage::Format_RGBA8888:
+        return convertRgba8888;
+    case QImage::Format_RGBX64:
+    case QImage::Format_RGBA64:
+        return convertRgba64;
+    case QImage::Format_RGBX32FPx4:
+    case QImage::Format_RGBA32FPx4:
+        return convertRgba32F;
+    case QImage::Format_RGBX16FPx4:
+    case QImage::Format_RGBA16FPx4:
+    case QImage::Format_RGBA16FPx4_Premultiplied:
+    case QImage::Format_RGBA32FPx4_Premultiplied:
+        image.convertTo(QImage::Format_RGBA32FPx4);
+        return convertRgba32F;
+    default:
+        break;
+    }
+
+    // Keep the precision of formats with more than eight bits per channel
+    if (image.pixelFormat().redSize() > 8) {
+        image.convertTo(QImage::Format_RGBA64);
+        return convertRgba64;
+    }
+    image.convertTo(QImage::Format_ARGB32);
+    return convertRgb32;
+}
+
+}
+
+namespace QPhysicsHeightMap {
+
+void fillSamples(const QImage &heightMap, physx::PxHeightFieldSample *samples)
+{
+    const int width = heightMap.width();
+    const int height = heightMap.height();
+    if (width <= 0 || height <= 0)
+        return;
+
+    QImage image = heightMap;
+    const RowConverter convert = rowConverter(image);
+
+    // The image is read row by row but the samples are stored column by column, so convert a
+    // block of rows and then write each column of the block in one go
+    QList<qint16> heights(qsizetype(width) * qMin(blockRows, height));
+    for (int firstRow = 0; firstRow < height; firstRow += blockRows) {
+        const int rows = qMin(blockRows, height - firstRow);
+        for (int row = 0; row < rows; ++row)
+            convert(image.constScanLine(firstRow + row), width,
+                    heights.data() + qsizetype(row) * width);
+
+        for (int x = 0; x < width; ++x) {
+            physx::PxHeightFieldSample *column = samples + qsizetype(x) * height + firstRow;
+            for (int row = 0; row < rows; ++row)
+                column[row] = { heights.at(qsizetype(row) * width + x), 0, 0 };
+        }
+    }
+}
+
+void fillSamples(const float *heights, int width, int height, physx::PxHeightFieldSample *samples)
+{
+    for (int x = 0; x < width; ++x) {
+        physx::PxHeightFieldSample *column = samples + qsizetype(x) * height;
+        for (int y = 0; y < height; ++y)
+            column[y] = { heightFromFloat(heights[qsizetype(y) * width + x]), 0, 0 };
+    }
+}
+
+}
+
+QT_END_NAMESPACE
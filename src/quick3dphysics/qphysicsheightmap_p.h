@@ -0,0 +1,47 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#ifndef QPHYSICSHEIGHTMAP_P_H
+#define QPHYSICSHEIGHTMAP_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuick3DPhysics/qtquick3dphysicsglobal.h>
+
+namespace physx {
+struct PxHeightFieldSample;
+}
+
+QT_BEGIN_NAMESPACE
+
+class QImage;
+
+namespace QPhysicsHeightMap {
+
+// Converts the HSV value of the pixels in the height map to height field samples. The samples
+// are stored column by column: the sample of pixel (x, y) is at index x * height + y. The
+// samples array has to hold width * height samples.
+//
+// Grayscale16, RGBA64 and floating point images are read at full precision, 8-bit images are
+// scaled to the same 16-bit range.
+Q_QUICK3DPHYSICS_EXPORT void fillSamples(const QImage &heightMap,
+                                         physx::PxHeightFieldSample *samples);
+
+// Same as above for heights given row by row in the range [0, 1]
+Q_QUICK3DPHYSICS_EXPORT void fillSamples(const float *heights, int width, int height,
+                                         physx::PxHeightFieldSample *samples);
+
+}
+
+QT_END_NAMESPACE
+
+#endif // QPHYSICSHEIGHTMAP_P_H
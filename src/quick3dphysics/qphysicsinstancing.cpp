@@ -0,0 +1,338 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "qphysicsinstancing_p.h"
+
+#include "qabstractcollisionshape_p.h"
+#include "qphysicsmaterial_p.h"
+#include "qphysicsworld_p.h"
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \qmltype PhysicsInstancing
+    \inherits Instancing
+    \inqmlmodule QtQuick3D.Physics
+    \since 6.9
+    \brief Simulates a large number of identical dynamic bodies and renders them instanced.
+
+    This type simulates a set of dynamic bodies that all share the same collision shape and
+    material. Unlike \l DynamicRigidBody, the individual bodies are not objects in the scene.
+    Instead, their simulated positions and rotations are written into the instance table every
+    frame, so that a single instanced \l Model can render all of them in one draw call.
+
+    This makes it possible to simulate tens of thousands of simple objects, such as debris or
+    projectiles, without the overhead of one scene node per body.
+
+    The instances are placed in scene coordinates, so the \l Model using this instancing should not
+    have any transform. The collision shape is not part of the scene either, and only its
+    geometry and local position and rotation are used.
+
+    \qml
+    PhysicsInstancing {
+        id: debris
+        physicsWorld: world
+        collisionShape: BoxShape {}
+    }
+
+    Model {
+        source: "#Cube"
+        instancing: debris
+        materials: PrincipledMaterial {}
+    }
+    \endqml
+
+    Bodies simulated by PhysicsInstancing do not send contact, trigger, or sleep reports.
+
+    \note Only shapes that can be used by a non-kinematic \l DynamicRigidBody are supported.
+*/
+
+/*!
+    \qmlproperty PhysicsWorld PhysicsInstancing::physicsWorld
+
+    This property holds the physics world the instances are simulated in.
+*/
+
+/*!
+    \qmlproperty CollisionShape PhysicsInstancing::collisionShape
+
+    This property holds the collision shape shared by all instances.
+*/
+
+/*!
+    \qmlproperty PhysicsMaterial PhysicsInstancing::physicsMaterial
+
+    This property holds the physics material shared by all instances. If not set, the default
+    friction and restitution values are used.
+*/
+
+/*!
+    \qmlproperty float PhysicsInstancing::density
+
+    This property holds the density used to calculate the mass of each instance.
+
+    Default value: \c 0.001
+*/
+
+/*!
+    \qmlproperty int PhysicsInstancing::count
+    \readonly
+
+    This property holds the number of instances.
+*/
+
+/*!
+    \qmlmethod int PhysicsInstancing::addInstance(vector3d position, vector3d eulerRotation,
+                                                    vector3d linearVelocity)
+
+    Adds a new instance at \a position with the rotation \a eulerRotation and the initial velocity
+    \a linearVelocity. Returns the index of the new instance.
+
+    The body is added to the simulation at the start of the next simulation frame.
+*/
+
+/*!
+    \qmlmethod PhysicsInstancing::removeInstance(int index)
+
+    Removes the instance at \a index. To keep removal cheap, the last instance is moved to \a
+    index.
+*/
+
+/*!
+    \qmlmethod PhysicsInstancing::clear()
+
+    Removes all instances.
+*/
+
+/*!
+    \qmlmethod vector3d PhysicsInstancing::instancePosition(int index)
+
+    Returns the simulated position of the instance at \a index.
+*/
+
+/*!
+    \qmlmethod quaternion PhysicsInstancing::instanceRotation(int index)
+
+    Returns the simulated rotation of the instance at \a index.
+*/
+
+QPhysicsInstancing::QPhysicsInstancing(QQuick3DObject *parent)
+    : QQuick3DInstancing(parent), m_bodyPool(nullptr)
+{
+}
+
+QPhysicsInstancing::~QPhysicsInstancing() = default;
+
+QPhysicsWorld *QPhysicsInstancing::physicsWorld() const
+{
+    return m_bodyPool.world();
+}
+
+void QPhysicsInstancing::setPhysicsWorld(QPhysicsWorld *physicsWorld)
+{
+    QPhysicsWorld *oldWorld = m_bodyPool.world();
+    if (oldWorld == physicsWorld)
+        return;
+
+    if (oldWorld)
+        disconnect(oldWorld, &QPhysicsWorld::frameDone, this, &QPhysicsInstancing::onFrameDone);
+
+    m_bodyPool.setWorld(physicsWorld);
+
+    if (physicsWorld)
+        connect(physicsWorld, &QPhysicsWorld::frameDone, this, &QPhysicsInstancing::onFrameDone);
+
+    emit physicsWorldChanged();
+}
+
+QAbstractCollisionShape *QPhysicsInstancing::collisionShape() const
+{
+    return m_collisionShape;
+}
+
+void QPhysicsInstancing::setCollisionShape(QAbstractCollisionShape *collisionShape)
+{
+    if (m_collisionShape == collisionShape)
+        return;
+
+    if (m_collisionShape)
+        m_collisionShape->disconnect(this);
+
+    m_bodyPool.setCollisionShape(collisionShape);
+    m_collisionShape = m_bodyPool.collisionShape();
+
+    if (m_collisionShape) {
+        connect(m_collisionShape, &QObject::destroyed, this,
+                &QPhysicsInstancing::onShapeDestroyed);
+        connect(m_collisionShape, &QAbstractCollisionShape::needsRebuild, this,
+                &QPhysicsInstancing::onShapeNeedsRebuild);
+        connect(m_collisionShape, &QAbstractCollisionShape::needsGeometryUpdate, this,
+                &QPhysicsInstancing::onShapeNeedsRebuild);
+    }
+
+    emit collisionShapeChanged();
+}
+
+QPhysicsMaterial *QPhysicsInstancing::physicsMaterial() const
+{
+    return m_physicsMaterial;
+}
+
+void QPhysicsInstancing::setPhysicsMaterial(QPhysicsMaterial *physicsMaterial)
+{
+    if (m_physicsMaterial == physicsMaterial)
+        return;
+
+    if (m_physicsMaterial)
+        m_physicsMaterial->disconnect(this);
+
+    m_physicsMaterial = physicsMaterial;
+    if (m_physicsMaterial) {
+        connect(m_physicsMaterial, &QPhysicsMaterial::staticFrictionChanged, this,
+                &QPhysicsInstancing::updateMaterial);
+        connect(m_physicsMaterial, &QPhysicsMaterial::dynamicFrictionChanged, this,
+                &QPhysicsInstancing::updateMaterial);
+        connect(m_physicsMaterial, &QPhysicsMaterial::restitutionChanged, this,
+                &QPhysicsInstancing::updateMaterial);
+        connect(m_physicsMaterial, &QObject::destroyed, this, [this] {
+            m_physicsMaterial = nullptr;
+            updateMaterial();
+        });
+    }
+
+    updateMaterial();
+    emit physicsMaterialChanged();
+}
+
+float QPhysicsInstancing::density() const
+{
+    return m_bodyPool.density();
+}
+
+void QPhysicsInstancing::setDensity(float density)
+{
+    if (qFuzzyCompare(m_bodyPool.density(), density))
+        return;
+
+    m_bodyPool.setDensity(density);
+    emit densityChanged();
+}
+
+int QPhysicsInstancing::count() const
+{
+    return int(m_bodyPool.size());
+}
+
+int QPhysicsInstancing::addInstance(const QVector3D &position, const QVector3D &eulerRotation,
+                                    const QVector3D &linearVelocity)
+{
+    const qsizetype index = m_bodyPool.spawn(
+            position, QQuaternion::fromEulerAngles(eulerRotation), linearVelocity);
+
+    m_instanceDataDirty = true;
+    markDirty();
+    emit countChanged();
+    return int(index);
+}
+
+void QPhysicsInstancing::removeInstance(int index)
+{
+    if (index < 0 || index >= m_bodyPool.size()) {
+        qWarning() << "PhysicsInstancing: index" << index << "out of range";
+        return;
+    }
+
+    m_bodyPool.despawn(index);
+
+    m_instanceDataDirty = true;
+    markDirty();
+    emit countChanged();
+}
+
+void QPhysicsInstancing::clear()
+{
+    if (m_bodyPool.size() == 0)
+        return;
+
+    m_bodyPool.clear();
+
+    m_instanceDataDirty = true;
+    markDirty();
+    emit countChanged();
+}
+
+QVector3D QPhysicsInstancing::instancePosition(int index) const
+{
+    if (index < 0 || index >= m_bodyPool.size()) {
+        qWarning() << "PhysicsInstancing: index" << index << "out of range";
+        return QVector3D();
+    }
+    return m_bodyPool.positions()[index];
+}
+
+QQuaternion QPhysicsInstancing::instanceRotation(int index) const
+{
+    if (index < 0 || index >= m_bodyPool.size()) {
+        qWarning() << "PhysicsInstancing: index" << index << "out of range";
+        return QQuaternion();
+    }
+    return m_bodyPool.rotations()[index];
+}
+
+QByteArray QPhysicsInstancing::getInstanceBuffer(int *instanceCount)
+{
+    const qsizetype count = m_bodyPool.size();
+
+    if (m_instanceDataDirty) {
+        const QList<QVector3D> &positions = m_bodyPool.positions();
+        const QList<QQuaternion> &rotations = m_bodyPool.rotations();
+        m_instanceData.resize(count * sizeof(InstanceTableEntry));
+        auto *entries = reinterpret_cast<InstanceTableEntry *>(m_instanceData.data());
+        const QVector3D scale(1, 1, 1);
+        for (qsizetype i = 0; i < count; i++) {
+            entries[i] =
+                    calculateTableEntryFromQuaternion(positions[i], scale, rotations[i], Qt::white);
+        }
+        m_instanceDataDirty = false;
+    }
+
+    if (instanceCount)
+        *instanceCount = int(count);
+
+    return m_instanceData;
+}
+
+void QPhysicsInstancing::onShapeDestroyed(QObject * /*object*/)
+{
+    // The pool keeps simulating with the current PhysX shape
+    m_collisionShape = nullptr;
+    m_bodyPool.setCollisionShape(nullptr);
+}
+
+void QPhysicsInstancing::onShapeNeedsRebuild(QObject * /*object*/)
+{
+    m_bodyPool.markShapeDirty();
+}
+
+void QPhysicsInstancing::onFrameDone()
+{
+    if (m_bodyPool.takeChanged()) {
+        m_instanceDataDirty = true;
+        markDirty();
+    }
+}
+
+void QPhysicsInstancing::updateMaterial()
+{
+    if (m_physicsMaterial) {
+        m_bodyPool.setMaterial(m_physicsMaterial->staticFriction(),
+                               m_physicsMaterial->dynamicFriction(),
+                               m_physicsMaterial->restitution());
+    } else {
+        m_bodyPool.setMaterial(QPhysicsMaterial::defaultStaticFriction,
+                               QPhysicsMaterial::defaultDynamicFriction,
+                               QPhysicsMaterial::defaultRestitution);
+    }
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,98 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#ifndef PHYSICSINSTANCING_H
+#define PHYSICSINSTANCING_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuick3DPhysics/qtquick3dphysicsglobal.h>
+#include <QtQuick3DPhysics/private/qphysicsbodypool_p.h>
+#include <QtQuick3D/qquick3dinstancing.h>
+#include <QtQml/QQmlEngine>
+#include <QtGui/QQuaternion>
+#include <QtGui/QVector3D>
+
+QT_BEGIN_NAMESPACE
+
+class QAbstractCollisionShape;
+class QPhysicsMaterial;
+class QPhysicsWorld;
+
+class Q_QUICK3DPHYSICS_EXPORT QPhysicsInstancing : public QQuick3DInstancing
+{
+    Q_OBJECT
+    Q_PROPERTY(QPhysicsWorld *physicsWorld READ physicsWorld WRITE setPhysicsWorld NOTIFY
+                       physicsWorldChanged)
+    Q_PROPERTY(QAbstractCollisionShape *collisionShape READ collisionShape WRITE setCollisionShape
+                       NOTIFY collisionShapeChanged)
+    Q_PROPERTY(QPhysicsMaterial *physicsMaterial READ physicsMaterial WRITE setPhysicsMaterial
+                       NOTIFY physicsMaterialChanged)
+    Q_PROPERTY(float density READ density WRITE setDensity NOTIFY densityChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    QML_NAMED_ELEMENT(PhysicsInstancing)
+    QML_ADDED_IN_VERSION(6, 9)
+
+public:
+    explicit QPhysicsInstancing(QQuick3DObject *parent = nullptr);
+    ~QPhysicsInstancing() override;
+
+    QPhysicsWorld *physicsWorld() const;
+    void setPhysicsWorld(QPhysicsWorld *physicsWorld);
+
+    QAbstractCollisionShape *collisionShape() const;
+    void setCollisionShape(QAbstractCollisionShape *collisionShape);
+
+    QPhysicsMaterial *physicsMaterial() const;
+    void setPhysicsMaterial(QPhysicsMaterial *physicsMaterial);
+
+    float density() const;
+    void setDensity(float density);
+
+    int count() const;
+
+    Q_INVOKABLE int addInstance(const QVector3D &position,
+                                const QVector3D &eulerRotation = QVector3D(),
+                                const QVector3D &linearVelocity = QVector3D());
+    Q_INVOKABLE void removeInstance(int index);
+    Q_INVOKABLE void clear();
+    Q_INVOKABLE QVector3D instancePosition(int index) const;
+    Q_INVOKABLE QQuaternion instanceRotation(int index) const;
+
+Q_SIGNALS:
+    void physicsWorldChanged();
+    void collisionShapeChanged();
+    void physicsMaterialChanged();
+    void densityChanged();
+    void countChanged();
+
+protected:
+    QByteArray getInstanceBuffer(int *instanceCount) override;
+
+private Q_SLOTS:
+    void onShapeDestroyed(QObject *object);
+    void onShapeNeedsRebuild(QObject *object);
+    void onFrameDone();
+
+private:
+    void updateMaterial();
+
+    QPhysicsBodyPool m_bodyPool;
+    QAbstractCollisionShape *m_collisionShape = nullptr;
+    QPhysicsMaterial *m_physicsMaterial = nullptr;
+    QByteArray m_instanceData;
+    bool m_instanceDataDirty = true;
+};
+
+QT_END_NAMESPACE
+
+#endif // PHYSICSINSTANCING_H
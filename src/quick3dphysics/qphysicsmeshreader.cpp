@@ -0,0 +1,298 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "qphysicsmeshreader_p.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QIODevice>
+#include <QtQuick3DUtils/private/qssgmesh_p.h>
+
+#include "qphysicsworld_p.h"
+
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+// The layout of the mesh files written by QSSGMesh::Mesh::save(). The file ends with a table of
+// the meshes it contains. Each mesh starts with a header and the offsets and sizes of its
+// buffers, followed by the vertex buffer entries, their names, the vertex data and the index
+// data. Everything after that (subsets, joints, LODs) is not needed for collision meshes.
+namespace {
+constexpr quint32 multiMeshFileId = 555777497;
+constexpr quint32 multiMeshFileVersion = 1;
+constexpr qint64 multiHeaderSize = 16;
+constexpr qint64 multiEntrySize = 16;
+
+constexpr quint32 meshFileId = 3365961549;
+constexpr quint16 minMeshFileVersion = 3;
+constexpr qint64 meshHeaderSize = 12;
+constexpr qint64 meshStructSize = 56;
+constexpr qint64 vertexEntrySize = 16;
+// Blocks in the mesh data are padded to four bytes
+constexpr qint64 meshAlignment = 4;
+
+// Number of bytes of vertex data that are read at a time
+constexpr qint64 vertexChunkSize = 256 * 1024;
+
+struct VertexEntry
+{
+    quint32 componentType = 0;
+    quint32 componentCount = 0;
+    quint32 offset = 0;
+};
+
+qint64 alignedSize(qint64 size)
+{
+    return (size + meshAlignment - 1) / meshAlignment * meshAlignment;
+}
+
+quint32 componentType(QSSGMesh::Mesh::ComponentType type)
+{
+    return quint32(type);
+}
+
+// Returns the offset of the mesh with the id, or -1
+qint64 findMesh(QIODevice *device, QDataStream &stream, quint32 id)
+{
+    const qint64 fileSize = device->size();
+    if (fileSize < multiHeaderSize || !device->seek(fileSize - multiHeaderSize))
+        return -1;
+
+    quint32 fileId = 0;
+    quint32 fileVersion = 0;
+    quint32 entriesOffset = 0; // Not reliable, the entries are found from the end of the file
+    quint32 meshCount = 0;
+    stream >> fileId >> fileVersion >> entriesOffset >> meshCount;
+    if (stream.status() != QDataStream::Ok || fileId != multiMeshFileId
+        || fileVersion != multiMeshFileVersion || meshCount == 0
+        || qint64(meshCount) * multiEntrySize > fileSize - multiHeaderSize) {
+        return -1;
+    }
+
+    const qint64 entriesStart = fileSize - multiHeaderSize - qint64(meshCount) * multiEntrySize;
+    if (!device->seek(entriesStart))
+        return -1;
+
+    // Like QSSGMesh::Mesh::loadMesh(), id 0 means the mesh with the lowest id
+    qint64 meshOffset = -1;
+    quint32 lowestId = std::numeric_limits<quint32>::max();
+    qint64 lowestIdOffset = -1;
+    for (quint32 i = 0; i < meshCount; ++i) {
+        quint64 offset = 0;
+        quint32 entryId = 0;
+        quint32 padding = 0;
+        stream >> offset >> entryId >> padding;
+        if (stream.status() != QDataStream::Ok)
+            return -1;
+        if (entryId == id)
+            meshOffset = qint64(offset);
+        if (entryId <= lowestId) {
+            lowestId = entryId;
+            lowestIdOffset = qint64(offset);
+        }
+    }
+
+    if (meshOffset < 0 && id == 0)
+        meshOffset = lowestIdOffset;
+    if (meshOffset < 0 || meshOffset > entriesStart - meshHeaderSize)
+        return -1;
+    return meshOffset;
+}
+
+// Reads the positions and indices straight from the file. Returns false if the file does not
+// have the expected layout.
+bool streamMesh(QIODevice *device, quint32 id, QPhysicsMeshReader::MeshData *data)
+{
+    QDataStream stream(device);
+    stream.setByteOrder(QDataStream::LittleEndian);
+
+    const qint64 offset = findMesh(device, stream, id);
+    if (offset < 0 || !device->seek(offset))
+        return false;
+
+    quint32 fileId = 0;
+    quint16 fileVersion = 0;
+    quint16 flags = 0;
+    quint32 sizeInBytes = 0;
+    stream >> fileId >> fileVersion >> flags >> sizeInBytes;
+    if (stream.status() != QDataStream::Ok || fileId != meshFileId
+        || fileVersion < minMeshFileVersion) {
+        return false;
+    }
+
+    // All offsets below are relative to the end of the header
+    const qint64 start = offset + meshHeaderSize;
+    const qint64 end = start + qint64(sizeInBytes);
+    if (end > device->size())
+        return false;
+
+    quint32 vertexEntriesOffset = 0;
+    quint32 vertexEntryCount = 0;
+    quint32 vertexStride = 0;
+    quint32 vertexDataOffset = 0;
+    quint32 vertexDataSize = 0;
+    quint32 indexComponentType = 0;
+    quint32 indexDataOffset = 0;
+    quint32 indexDataSize = 0;
+    stream >> vertexEntriesOffset >> vertexEntryCount >> vertexStride >> vertexDataOffset
+            >> vertexDataSize >> indexComponentType >> indexDataOffset >> indexDataSize;
+    if (stream.status() != QDataStream::Ok)
+        return false;
+
+    // Vertex buffer entries
+    qint64 pos = start + meshStructSize;
+    if (vertexEntryCount == 0 || pos + qint64(vertexEntryCount) * vertexEntrySize > end
+        || !device->seek(pos)) {
+        return false;
+    }
+    QList<VertexEntry> entries(vertexEntryCount);
+    for (VertexEntry &entry : entries) {
+        quint32 nameOffset = 0;
+        stream >> nameOffset >> entry.componentType >> entry.componentCount >> entry.offset;
+    }
+    if (stream.status() != QDataStream::Ok)
+        return false;
+    pos += qint64(vertexEntryCount) * vertexEntrySize;
+
+    // Their names, each a length followed by a zero terminated string
+    const VertexEntry *positionEntry = nullptr;
+    for (const VertexEntry &entry : std::as_const(entries)) {
+        quint32 nameLength = 0;
+        stream >> nameLength;
+        pos += sizeof(quint32);
+        if (stream.status() != QDataStream::Ok || pos + qint64(nameLength) > end)
+            return false;
+        const QByteArray name = device->read(nameLength);
+        if (name.size() != qsizetype(nameLength))
+            return false;
+        if (qstrcmp(name.constData(), "attr_pos") == 0)
+            positionEntry = &entry;
+        pos += alignedSize(nameLength);
+        if (!device->seek(pos))
+            return false;
+    }
+
+    if (!positionEntry
+        || positionEntry->componentType != componentType(QSSGMesh::Mesh::ComponentType::Float32)
+        || positionEntry->componentCount != 3
+        || qint64(positionEntry->offset) + qint64(sizeof(QVector3D)) > qint64(vertexStride)
+        || vertexDataSize % vertexStride != 0 || pos + qint64(vertexDataSize) > end) {
+        return false;
+    }
+
+    // Vertex data, read in chunks and only keeping the positions
+    const qint64 vertexCount = vertexDataSize / vertexStride;
+    data->positions.resize(vertexCount * qint64(sizeof(QVector3D)));
+    auto *positions = reinterpret_cast<QVector3D *>(data->positions.data());
+    const qint64 chunkVertices = qMax(qint64(1), vertexChunkSize / vertexStride);
+    QByteArray chunk;
+    QVector3D boundsMin(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+                        std::numeric_limits<float>::max());
+    QVector3D boundsMax = -boundsMin;
+    for (qint64 first = 0; first < vertexCount; first += chunkVertices) {
+        const qint64 count = qMin(chunkVertices, vertexCount - first);
+        chunk.resize(count * vertexStride);
+        if (device->read(chunk.data(), chunk.size()) != chunk.size())
+            return false;
+        for (qint64 i = 0; i < count; ++i) {
+            QVector3D &position = positions[first + i];
+            memcpy(&position, chunk.constData() + i * vertexStride + positionEntry->offset,
+                   sizeof(QVector3D));
+            boundsMin = QVector3D(qMin(boundsMin.x(), position.x()),
+                                  qMin(boundsMin.y(), position.y()),
+                                  qMin(boundsMin.z(), position.z()));
+            boundsMax = QVector3D(qMax(boundsMax.x(), position.x()),
+                                  qMax(boundsMax.y(), position.y()),
+                                  qMax(boundsMax.z(), position.z()));
+        }
+    }
+    data->boundsMin = boundsMin;
+    data->boundsMax = boundsMax;
+    pos += alignedSize(vertexDataSize);
+
+    // Index data
+    data->u16Indices =
+            indexComponentType == componentType(QSSGMesh::Mesh::ComponentType::UnsignedInt16);
+    if (!data->u16Indices
+        && indexComponentType != componentType(QSSGMesh::Mesh::ComponentType::UnsignedInt32)) {
+        return false;
+    }
+    const int indexSize = data->u16Indices ? sizeof(quint16) : sizeof(quint32);
+    if (indexDataSize % (3 * indexSize) != 0 || pos + qint64(indexDataSize) > end
+        || !device->seek(pos)) {
+        return false;
+    }
+    data->indices = device->read(indexDataSize);
+    if (data->indices.size() != qsizetype(indexDataSize))
+        return false;
+
+    // A wrong layout would show up as indices out of range
+    const qsizetype indexCount = data->indices.size() / indexSize;
+    for (qsizetype i = 0; i < indexCount; ++i) {
+        const quint32 index = data->u16Indices
+                ? reinterpret_cast<const quint16 *>(data->indices.constData())[i]
+                : reinterpret_cast<const quint32 *>(data->indices.constData())[i];
+        if (qint64(index) >= vertexCount)
+            return false;
+    }
+
+    return true;
+}
+
+QPhysicsMeshReader::MeshData fromSsgMesh(const QSSGMesh::Mesh &mesh)
+{
+    QPhysicsMeshReader::MeshData data;
+    const auto &vertexBuffer = mesh.vertexBuffer();
+    int posOffset = -1;
+    for (const auto &entry : vertexBuffer.entries) {
+        if (entry.name == "attr_pos"
+            && entry.componentType == QSSGMesh::Mesh::ComponentType::Float32)
+            posOffset = entry.offset;
+    }
+    if (posOffset < 0 || vertexBuffer.stride == 0)
+        return data;
+
+    const qsizetype vertexCount = vertexBuffer.data.size() / vertexBuffer.stride;
+    data.positions.resize(vertexCount * qsizetype(sizeof(QVector3D)));
+    auto *positions = reinterpret_cast<QVector3D *>(data.positions.data());
+    for (qsizetype i = 0; i < vertexCount; ++i) {
+        memcpy(&positions[i], vertexBuffer.data.constData() + i * vertexBuffer.stride + posOffset,
+               sizeof(QVector3D));
+    }
+
+    if (!mesh.subsets().isEmpty()) {
+        data.boundsMin = mesh.subsets().constFirst().bounds.min;
+        data.boundsMax = mesh.subsets().constFirst().bounds.max;
+    }
+    data.indices = mesh.indexBuffer().data;
+    data.u16Indices =
+            mesh.indexBuffer().componentType == QSSGMesh::Mesh::ComponentType::UnsignedInt16;
+    return data;
+}
+}
+
+namespace QPhysicsMeshReader {
+
+MeshData readMesh(QIODevice *device, quint32 id)
+{
+    MeshData data;
+    if (!device || device->isSequential())
+        return data;
+
+    if (streamMesh(device, id, &data))
+        return data;
+
+    // Files with a layout the streaming reader does not know are loaded completely
+    qCDebug(lcQuick3dPhysics) << "Could not stream mesh, loading all of it";
+    data = MeshData();
+    if (!device->seek(0))
+        return data;
+    const QSSGMesh::Mesh mesh = QSSGMesh::Mesh::loadMesh(device, id);
+    if (mesh.isValid())
+        data = fromSsgMesh(mesh);
+    return data;
+}
+
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,51 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#ifndef QPHYSICSMESHREADER_P_H
+#define QPHYSICSMESHREADER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuick3DPhysics/qtquick3dphysicsglobal.h>
+#include <QtCore/QByteArray>
+#include <QtGui/QVector3D>
+
+QT_BEGIN_NAMESPACE
+
+class QIODevice;
+
+namespace QPhysicsMeshReader {
+
+// The parts of a mesh needed to cook collision meshes
+struct MeshData
+{
+    // Three floats per vertex
+    QByteArray positions;
+    QByteArray indices;
+    bool u16Indices = false;
+    QVector3D boundsMin;
+    QVector3D boundsMax;
+
+    bool isValid() const { return !positions.isEmpty(); }
+    qsizetype vertexCount() const { return positions.size() / qsizetype(sizeof(QVector3D)); }
+};
+
+// Reads the positions and indices of the mesh with the id from a .mesh file without loading the
+// other vertex attributes and the subsets. An id of 0 reads the first mesh in the file. The
+// device has to be random access.
+Q_QUICK3DPHYSICS_EXPORT MeshData readMesh(QIODevice *device, quint32 id = 0);
+
+}
+
+QT_END_NAMESPACE
+
+#endif // QPHYSICSMESHREADER_P_H
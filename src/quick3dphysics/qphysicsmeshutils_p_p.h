@@ -16,8 +16,13 @@
 //
 
 #include <QtQuick3DPhysics/qtquick3dphysicsglobal.h>
+#include <QtQuick3DPhysics/private/qcookingparameters_p.h>
+#include <QtQuick3DPhysics/private/qphysicsmeshreader_p.h>
+#include <QtCore/QFuture>
+#include <QtCore/QSet>
 #include <QtGui/QVector3D>
-#include <QtQuick3DUtils/private/qssgmesh_p.h>
+
+#include <functional>
 
 namespace physx {
 class PxBoxGeometry;
@@ -35,42 +40,94 @@ class QQuick3DPhysicsMesh
 public:
     QQuick3DPhysicsMesh(const QString &qmlSource) : m_meshPath(qmlSource) { }
     QQuick3DPhysicsMesh(const QQuick3DGeometry *geometrySource) : m_meshGeometry(geometrySource) { }
-    ~QQuick3DPhysicsMesh() { }
+    ~QQuick3DPhysicsMesh();
 
     QList<QVector3D> positions();
 
     QPair<QVector3D, QVector3D> bounds()
     {
-        loadSsgMesh();
-        if (m_ssgMesh.isValid()) {
-            auto b = m_ssgMesh.subsets().constFirst().bounds;
-            return { b.min, b.max };
-        }
+        loadMeshData();
+        if (m_meshData.isValid())
+            return { m_meshData.boundsMin, m_meshData.boundsMax };
         return {};
     }
 
     void ref() { ++refCount; }
     int deref() { return --refCount; }
 
-    physx::PxConvexMesh *convexMesh();
-    physx::PxTriangleMesh *triangleMesh();
+    // Shapes using the meshes cooked with the settings reference them, the meshes of settings no
+    // shape uses any more are released
+    void refSettings(const QCookingParameters::Settings &settings);
+    void derefSettings(const QCookingParameters::Settings &settings);
+
+    // Returns the mesh cooked with the settings, cooking it on the calling thread or waiting for
+    // background cooking
+    physx::PxConvexMesh *convexMesh(const QCookingParameters::Settings &settings = {});
+    physx::PxTriangleMesh *triangleMesh(const QCookingParameters::Settings &settings = {});
 
     enum MeshType { Convex, Triangle };
 
+    // Starts cooking the mesh on the cooking thread pool unless it is already cooking. The
+    // future finishes with the cooked data, which convexMesh() or triangleMesh() then turn into
+    // the mesh without blocking.
+    QFuture<QByteArray> cookAsync(MeshType type,
+                                  const QCookingParameters::Settings &settings = {});
+    // True if the mesh exists or calling convexMesh() or triangleMesh() will not block
+    bool isCooked(MeshType type, const QCookingParameters::Settings &settings = {}) const;
+
+    // Queues copying the vertex positions of the geometry into the existing triangle mesh and
+    // refitting its BVH. Returns false if the mesh has to be cooked again instead.
+    bool requestRefit(const QCookingParameters::Settings &settings);
+    // Refits the queued triangle meshes. Must only be called while no physics world is simulating.
+    // Returns true if any mesh was changed.
+    bool applyPendingRefits();
+
+    // The data needed to cook a mesh, copied so it can be used from a worker thread
+    struct CookingSource
+    {
+        QString meshPath;
+        QByteArray vertexData;
+        QByteArray indexData;
+        int stride = 0;
+        int posOffset = 0;
+        bool u16Indices = false;
+    };
+
 private:
-    void loadSsgMesh();
-    physx::PxConvexMesh *convexMeshQmlSource();
-    physx::PxConvexMesh *convexMeshGeometrySource();
-    physx::PxTriangleMesh *triangleMeshQmlSource();
-    physx::PxTriangleMesh *triangleMeshGeometrySource();
+    // The meshes cooked with one set of cooking settings
+    struct CookedMeshes
+    {
+        QCookingParameters::Settings settings;
+        physx::PxConvexMesh *convexMesh = nullptr;
+        physx::PxTriangleMesh *triangleMesh = nullptr;
+        QFuture<QByteArray> cookingFutures[2];
+        // The index data of the geometry the triangle mesh was created from
+        QByteArray triangleIndexData;
+        // The number of shapes using the settings
+        int users = 0;
+    };
+
+    void loadMeshData();
+    void releaseMeshes(CookedMeshes &cooked);
+    CookingSource geometryCookingSource() const;
+    CookedMeshes &cookedMeshes(const QCookingParameters::Settings &settings);
+    physx::PxTriangleMesh *refittableTriangleMesh(const QCookingParameters::Settings &settings,
+                                                  const CookingSource &source) const;
+    const CookedMeshes *findCookedMeshes(const QCookingParameters::Settings &settings) const;
+    physx::PxConvexMesh *convexMeshQmlSource(const QCookingParameters::Settings &settings);
+    physx::PxConvexMesh *convexMeshGeometrySource(const QCookingParameters::Settings &settings);
+    physx::PxTriangleMesh *triangleMeshQmlSource(const QCookingParameters::Settings &settings);
+    physx::PxTriangleMesh *
+    triangleMeshGeometrySource(const QCookingParameters::Settings &settings);
 
     QString m_meshPath;
     const QQuick3DGeometry *m_meshGeometry = nullptr;
-    QSSGMesh::Mesh m_ssgMesh;
-    int m_posOffset = 0;
+    // Only the positions and indices of the mesh file
+    QPhysicsMeshReader::MeshData m_meshData;
 
-    physx::PxConvexMesh *m_convexMesh = nullptr;
-    physx::PxTriangleMesh *m_triangleMesh = nullptr;
+    QList<CookedMeshes> m_cookedMeshes;
+    // The settings of the triangle meshes waiting to be refitted
+    QList<QCookingParameters::Settings> m_pendingRefits;
     int refCount = 0;
 };
 
@@ -80,10 +137,20 @@ public:
     static QQuick3DPhysicsMesh *getMesh(const QUrl &source, const QObject *contextObject);
     static QQuick3DPhysicsMesh *getMesh(QQuick3DGeometry *source);
     static void releaseMesh(QQuick3DPhysicsMesh *mesh);
+    // Runs a cooking job on the cooking thread pool
+    static QFuture<QByteArray> runCookingJob(std::function<QByteArray()> job);
+    // Blocks until all background cooking has finished
+    static void waitForCooking();
+    static bool hasPendingRefits() { return !pendingRefitMeshes.isEmpty(); }
+    // Refits the triangle meshes whose geometry changed and returns the meshes that changed. The
+    // meshes are shared by all physics worlds, so none of them may be simulating.
+    static QSet<QQuick3DPhysicsMesh *> applyPendingRefits();
 
 private:
+    friend class QQuick3DPhysicsMesh;
     static QHash<QString, QQuick3DPhysicsMesh *> sourceMeshHash;
     static QHash<QQuick3DGeometry *, QQuick3DPhysicsMesh *> geometryMeshHash;
+    static QSet<QQuick3DPhysicsMesh *> pendingRefitMeshes;
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,264 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "qphysicsstatistics_p.h"
+
+#include "physxnode/qphysxworld_p.h"
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \qmltype PhysicsStatistics
+    \inqmlmodule QtQuick3D.Physics
+    \since 6.9
+    \brief Reports where the time of a simulated frame goes.
+
+    The statistics of a \l PhysicsWorld are available from its
+    \l{PhysicsWorld::statistics}{statistics} property. They are updated once for every simulated
+    frame, just before \l{PhysicsWorld::frameDone}{frameDone} is emitted, and describe the frame
+    that just finished. This makes it possible to see what a frame costs on a device without
+    attaching a profiler:
+
+    \qml
+    Text {
+        text: "step %1 ms, sync %2 ms, %3 awake bodies"
+              .arg(world.statistics.fetchTime.toFixed(2))
+              .arg(world.statistics.syncTime.toFixed(2))
+              .arg(world.statistics.activeActorCount)
+    }
+    \endqml
+
+    All times are in milliseconds. The simulation step runs on a separate thread and is split
+    into \l simulateTime and \l fetchTime. The other times are spent on the GUI thread.
+
+    PhysicsStatistics cannot be created in QML.
+*/
+
+/*!
+    \qmlproperty real PhysicsStatistics::simulateTime
+    \readonly
+
+    This property holds the time it took to start the simulation step. PhysX then runs the step
+    on its own threads.
+*/
+
+/*!
+    \qmlproperty real PhysicsStatistics::fetchTime
+    \readonly
+
+    This property holds the time spent waiting for the simulation step to finish and for its
+    results to be applied. This is usually where most of the step goes.
+*/
+
+/*!
+    \qmlproperty real PhysicsStatistics::syncTime
+    \readonly
+
+    This property holds the time spent synchronizing the bodies of the world with the scene,
+    including rebuilding changed collision shapes and executing queued commands.
+
+    \sa commandTime
+*/
+
+/*!
+    \qmlproperty real PhysicsStatistics::commandTime
+    \readonly
+
+    This property holds the part of \l syncTime that was spent executing the commands queued on
+    dynamic bodies, like \l{DynamicRigidBody::applyForce}{applyForce} and
+    \l{DynamicRigidBody::reset}{reset}.
+*/
+
+/*!
+    \qmlproperty real PhysicsStatistics::contactCallbackTime
+    \readonly
+
+    This property holds the time spent emitting the contact and sleep state signals of the frame,
+    including the time spent in their handlers.
+*/
+
+/*!
+    \qmlproperty real PhysicsStatistics::debugDrawTime
+    \readonly
+
+    This property holds the time spent updating the debug drawing of the collision shapes and the
+    \l{PhysicsWorld::debugVisualization}{debug visualization}.
+*/
+
+/*!
+    \qmlproperty int PhysicsStatistics::activeActorCount
+    \readonly
+
+    This property holds the number of dynamic and kinematic bodies that were simulated in the
+    frame.
+*/
+
+/*!
+    \qmlproperty int PhysicsStatistics::sleepingActorCount
+    \readonly
+
+    This property holds the number of dynamic and kinematic bodies that were asleep in the frame.
+*/
+
+/*!
+    \qmlproperty int PhysicsStatistics::staticActorCount
+    \readonly
+
+    This property holds the number of static bodies in the world.
+*/
+
+/*!
+    \qmlproperty int PhysicsStatistics::contactPairCount
+    \readonly
+
+    This property holds the number of shape pairs whose contacts were computed in the frame.
+    These are the pairs with overlapping bounds.
+*/
+
+/*!
+    \qmlproperty int PhysicsStatistics::touchingPairCount
+    \readonly
+
+    This property holds the number of shape pairs that were touching in the frame.
+*/
+
+/*!
+    \qmlproperty int PhysicsStatistics::broadPhaseNewPairCount
+    \readonly
+
+    This property holds the number of shape pairs whose bounds started to overlap in the frame.
+*/
+
+/*!
+    \qmlproperty int PhysicsStatistics::broadPhaseLostPairCount
+    \readonly
+
+    This property holds the number of shape pairs whose bounds stopped overlapping in the frame.
+*/
+
+/*!
+    \qmlproperty int PhysicsStatistics::shapeRebuildCount
+    \readonly
+
+    This property holds the number of bodies whose collision shapes were created again in the
+    frame, for example because a shape was added or its size changed.
+*/
+
+/*!
+    \qmlproperty int PhysicsStatistics::shapeGeometryUpdateCount
+    \readonly
+
+    This property holds the number of bodies whose collision shapes kept their PhysX shapes but
+    had their meshes or height fields changed in place in the frame.
+*/
+
+/*!
+    \qmlsignal PhysicsStatistics::updated()
+
+    This signal is emitted after the statistics of a frame have been updated.
+*/
+
+QPhysicsStatistics::QPhysicsStatistics(QObject *parent) : QObject(parent) { }
+
+float QPhysicsStatistics::simulateTime() const
+{
+    return m_simulateTime;
+}
+
+float QPhysicsStatistics::fetchTime() const
+{
+    return m_fetchTime;
+}
+
+float QPhysicsStatistics::syncTime() const
+{
+    return m_syncTime;
+}
+
+float QPhysicsStatistics::commandTime() const
+{
+    return m_commandTime;
+}
+
+float QPhysicsStatistics::contactCallbackTime() const
+{
+    return m_contactCallbackTime;
+}
+
+float QPhysicsStatistics::debugDrawTime() const
+{
+    return m_debugDrawTime;
+}
+
+int QPhysicsStatistics::activeActorCount() const
+{
+    return m_activeActorCount;
+}
+
+int QPhysicsStatistics::sleepingActorCount() const
+{
+    return m_sleepingActorCount;
+}
+
+int QPhysicsStatistics::staticActorCount() const
+{
+    return m_staticActorCount;
+}
+
+int QPhysicsStatistics::contactPairCount() const
+{
+    return m_contactPairCount;
+}
+
+int QPhysicsStatistics::touchingPairCount() const
+{
+    return m_touchingPairCount;
+}
+
+int QPhysicsStatistics::broadPhaseNewPairCount() const
+{
+    return m_broadPhaseNewPairCount;
+}
+
+int QPhysicsStatistics::broadPhaseLostPairCount() const
+{
+    return m_broadPhaseLostPairCount;
+}
+
+int QPhysicsStatistics::shapeRebuildCount() const
+{
+    return m_shapeRebuildCount;
+}
+
+int QPhysicsStatistics::shapeGeometryUpdateCount() const
+{
+    return m_shapeGeometryUpdateCount;
+}
+
+void QPhysicsStatistics::update(const QPhysXFrameStatistics &frame)
+{
+    constexpr float nsecsToMsecs = 0.000001f;
+    m_simulateTime = frame.simulateNsecs * nsecsToMsecs;
+    m_fetchTime = frame.fetchNsecs * nsecsToMsecs;
+    m_syncTime = frame.syncNsecs * nsecsToMsecs;
+    m_commandTime = frame.commandNsecs * nsecsToMsecs;
+    m_contactCallbackTime = frame.contactCallbackNsecs * nsecsToMsecs;
+    m_debugDrawTime = frame.debugDrawNsecs * nsecsToMsecs;
+
+    const physx::PxSimulationStatistics &simulation = frame.simulation;
+    const int activeCount = simulation.nbActiveDynamicBodies + simulation.nbActiveKinematicBodies;
+    m_activeActorCount = activeCount;
+    m_sleepingActorCount =
+            qMax(0, int(simulation.nbDynamicBodies + simulation.nbKinematicBodies) - activeCount);
+    m_staticActorCount = simulation.nbStaticBodies;
+    m_contactPairCount = simulation.nbDiscreteContactPairsTotal;
+    m_touchingPairCount = simulation.nbDiscreteContactPairsWithContacts;
+    m_broadPhaseNewPairCount = simulation.nbNewPairs;
+    m_broadPhaseLostPairCount = simulation.nbLostPairs;
+    m_shapeRebuildCount = frame.shapeRebuildCount;
+    m_shapeGeometryUpdateCount = frame.shapeGeometryUpdateCount;
+
+    emit updated();
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,95 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#ifndef QPHYSICSSTATISTICS_P_H
+#define QPHYSICSSTATISTICS_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuick3DPhysics/qtquick3dphysicsglobal.h>
+#include <QtCore/QObject>
+#include <QtQml/QQmlEngine>
+
+QT_BEGIN_NAMESPACE
+
+struct QPhysXFrameStatistics;
+
+class Q_QUICK3DPHYSICS_EXPORT QPhysicsStatistics : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(float simulateTime READ simulateTime NOTIFY updated FINAL)
+    Q_PROPERTY(float fetchTime READ fetchTime NOTIFY updated FINAL)
+    Q_PROPERTY(float syncTime READ syncTime NOTIFY updated FINAL)
+    Q_PROPERTY(float commandTime READ commandTime NOTIFY updated FINAL)
+    Q_PROPERTY(float contactCallbackTime READ contactCallbackTime NOTIFY updated FINAL)
+    Q_PROPERTY(float debugDrawTime READ debugDrawTime NOTIFY updated FINAL)
+    Q_PROPERTY(int activeActorCount READ activeActorCount NOTIFY updated FINAL)
+    Q_PROPERTY(int sleepingActorCount READ sleepingActorCount NOTIFY updated FINAL)
+    Q_PROPERTY(int staticActorCount READ staticActorCount NOTIFY updated FINAL)
+    Q_PROPERTY(int contactPairCount READ contactPairCount NOTIFY updated FINAL)
+    Q_PROPERTY(int touchingPairCount READ touchingPairCount NOTIFY updated FINAL)
+    Q_PROPERTY(int broadPhaseNewPairCount READ broadPhaseNewPairCount NOTIFY updated FINAL)
+    Q_PROPERTY(int broadPhaseLostPairCount READ broadPhaseLostPairCount NOTIFY updated FINAL)
+    Q_PROPERTY(int shapeRebuildCount READ shapeRebuildCount NOTIFY updated FINAL)
+    Q_PROPERTY(int shapeGeometryUpdateCount READ shapeGeometryUpdateCount NOTIFY updated FINAL)
+    QML_NAMED_ELEMENT(PhysicsStatistics)
+    QML_UNCREATABLE("PhysicsStatistics is only available from PhysicsWorld.statistics")
+    QML_ADDED_IN_VERSION(6, 9)
+
+public:
+    explicit QPhysicsStatistics(QObject *parent = nullptr);
+
+    float simulateTime() const;
+    float fetchTime() const;
+    float syncTime() const;
+    float commandTime() const;
+    float contactCallbackTime() const;
+    float debugDrawTime() const;
+
+    int activeActorCount() const;
+    int sleepingActorCount() const;
+    int staticActorCount() const;
+    int contactPairCount() const;
+    int touchingPairCount() const;
+    int broadPhaseNewPairCount() const;
+    int broadPhaseLostPairCount() const;
+    int shapeRebuildCount() const;
+    int shapeGeometryUpdateCount() const;
+
+    // Takes the values of a finished frame and emits updated()
+    void update(const QPhysXFrameStatistics &frame);
+
+signals:
+    void updated();
+
+private:
+    float m_simulateTime = 0.f;
+    float m_fetchTime = 0.f;
+    float m_syncTime = 0.f;
+    float m_commandTime = 0.f;
+    float m_contactCallbackTime = 0.f;
+    float m_debugDrawTime = 0.f;
+
+    int m_activeActorCount = 0;
+    int m_sleepingActorCount = 0;
+    int m_staticActorCount = 0;
+    int m_contactPairCount = 0;
+    int m_touchingPairCount = 0;
+    int m_broadPhaseNewPairCount = 0;
+    int m_broadPhaseLostPairCount = 0;
+    int m_shapeRebuildCount = 0;
+    int m_shapeGeometryUpdateCount = 0;
+};
+
+QT_END_NAMESPACE
+
+#endif // QPHYSICSSTATISTICS_P_H
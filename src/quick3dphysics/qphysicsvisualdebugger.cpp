@@ -0,0 +1,155 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "qphysicsvisualdebugger_p.h"
+
+#include "PxFoundation.h"
+#include "PxScene.h"
+#include "pvd/PxPvd.h"
+#include "pvd/PxPvdSceneClient.h"
+#include "pvd/PxPvdTransport.h"
+
+#include "qphysicsworld_p.h"
+
+#include <QtCore/QFile>
+#include <QtEnvironmentVariables>
+
+QT_BEGIN_NAMESPACE
+
+namespace QPhysicsVisualDebugger {
+
+// QT_PHYSICS_PVD is either "host", "host:port" or "file:<file name>".
+// QT_PHYSICS_PVD_INSTRUMENTATION is a comma separated list of "debug", "profile", "memory" and
+// "all", which is the default.
+static Settings settingsFromEnvironment()
+{
+    Settings settings;
+    const QString target = qEnvironmentVariable("QT_PHYSICS_PVD");
+    if (target.isEmpty())
+        return settings;
+
+    if (target.startsWith(QLatin1String("file:"))) {
+        settings.transport = Transport::File;
+        settings.fileName = target.mid(5);
+    } else {
+        settings.transport = Transport::Socket;
+        const qsizetype colon = target.lastIndexOf(QLatin1Char(':'));
+        if (colon < 0) {
+            settings.host = target;
+        } else {
+            settings.host = target.left(colon);
+            bool ok = false;
+            const int port = target.mid(colon + 1).toInt(&ok);
+            if (ok && port > 0 && port <= 0xffff)
+                settings.port = port;
+            else
+                qCWarning(lcQuick3dPhysics) << "Invalid PhysX Visual Debugger port in" << target;
+        }
+    }
+
+    const QString instrumentation = qEnvironmentVariable("QT_PHYSICS_PVD_INSTRUMENTATION");
+    if (!instrumentation.isEmpty()) {
+        settings.instrumentation = {};
+        for (QStringView flag : QStringView(instrumentation).split(u',', Qt::SkipEmptyParts)) {
+            flag = flag.trimmed();
+            if (flag == u"debug")
+                settings.instrumentation |= Instrumentation::Debug;
+            else if (flag == u"profile")
+                settings.instrumentation |= Instrumentation::Profile;
+            else if (flag == u"memory")
+                settings.instrumentation |= Instrumentation::Memory;
+            else if (flag == u"all")
+                settings.instrumentation |= Instrumentation::All;
+            else
+                qCWarning(lcQuick3dPhysics) << "Unknown PhysX Visual Debugger instrumentation"
+                                            << flag;
+        }
+    }
+
+    return settings;
+}
+
+static Settings &currentSettings()
+{
+    static Settings settings = settingsFromEnvironment();
+    return settings;
+}
+
+Settings settings()
+{
+    return currentSettings();
+}
+
+void setSettings(const Settings &settings)
+{
+    currentSettings() = settings;
+}
+
+physx::PxPvd *connect(physx::PxFoundation &foundation, physx::PxPvdTransport *&transport)
+{
+    const Settings &settings = currentSettings();
+    if (settings.transport == Transport::None)
+        return nullptr;
+
+#ifdef QT_QUICK3DPHYSICS_PVD
+    if (settings.transport == Transport::File) {
+        const QByteArray fileName = QFile::encodeName(settings.fileName);
+        transport = physx::PxDefaultPvdFileTransportCreate(fileName.constData());
+    } else {
+        const QByteArray host = settings.host.toUtf8();
+        transport = physx::PxDefaultPvdSocketTransportCreate(host.constData(), settings.port,
+                                                             settings.timeout);
+    }
+    if (!transport) {
+        qCWarning(lcQuick3dPhysics) << "Could not create the PhysX Visual Debugger transport";
+        return nullptr;
+    }
+
+    physx::PxPvdInstrumentationFlags flags;
+    if (settings.instrumentation.testFlag(Instrumentation::Debug))
+        flags |= physx::PxPvdInstrumentationFlag::eDEBUG;
+    if (settings.instrumentation.testFlag(Instrumentation::Profile))
+        flags |= physx::PxPvdInstrumentationFlag::ePROFILE;
+    if (settings.instrumentation.testFlag(Instrumentation::Memory))
+        flags |= physx::PxPvdInstrumentationFlag::eMEMORY;
+
+    physx::PxPvd *pvd = physx::PxCreatePvd(foundation);
+    if (!pvd || !pvd->connect(*transport, flags)) {
+        if (settings.transport == Transport::File)
+            qCWarning(lcQuick3dPhysics) << "Could not write the PhysX Visual Debugger capture to"
+                                        << settings.fileName;
+        else
+            qCWarning(lcQuick3dPhysics) << "Could not connect to the PhysX Visual Debugger at"
+                                        << settings.host << "port" << settings.port;
+        if (pvd)
+            pvd->release();
+        transport->release();
+        transport = nullptr;
+        return nullptr;
+    }
+
+    qCDebug(lcQuick3dPhysics) << "Connected to the PhysX Visual Debugger";
+    return pvd;
+#else
+    Q_UNUSED(foundation);
+    Q_UNUSED(transport);
+    qCWarning(lcQuick3dPhysics) << "Not connecting to the PhysX Visual Debugger since this build "
+                                   "does not support it, see the quick3dphysics-pvd feature";
+    return nullptr;
+#endif
+}
+
+void setupScene(physx::PxScene *scene)
+{
+    // The client only exists when PhysX is built with PVD support
+    physx::PxPvdSceneClient *client = scene ? scene->getScenePvdClient() : nullptr;
+    if (!client)
+        return;
+    client->setScenePvdFlag(physx::PxPvdSceneFlag::eTRANSMIT_CONSTRAINTS, true);
+    client->setScenePvdFlag(physx::PxPvdSceneFlag::eTRANSMIT_CONTACTS, true);
+    client->setScenePvdFlag(physx::PxPvdSceneFlag::eTRANSMIT_SCENEQUERIES, true);
+}
+
+}
+
+QT_END_NAMESPACE
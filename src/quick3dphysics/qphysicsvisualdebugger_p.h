@@ -0,0 +1,76 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#ifndef QPHYSICSVISUALDEBUGGER_P_H
+#define QPHYSICSVISUALDEBUGGER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuick3DPhysics/qtquick3dphysicsglobal.h>
+#include <QtCore/QFlags>
+#include <QtCore/QString>
+
+namespace physx {
+class PxFoundation;
+class PxPvd;
+class PxPvdTransport;
+class PxScene;
+}
+
+QT_BEGIN_NAMESPACE
+
+// The connection to the PhysX Visual Debugger (PVD). It is off unless it is configured with the
+// QT_PHYSICS_PVD environment variable or setSettings(), and it can only be turned on when the
+// module is built with the quick3dphysics-pvd feature.
+namespace QPhysicsVisualDebugger {
+
+enum class Transport { None, Socket, File };
+
+enum class Instrumentation {
+    Debug = 0x1, // Scenes, bodies, shapes and contacts
+    Profile = 0x2, // Timings of the simulation
+    Memory = 0x4, // Memory allocations
+    All = Debug | Profile | Memory
+};
+Q_DECLARE_FLAGS(Instrumentations, Instrumentation)
+
+struct Settings
+{
+    Transport transport = Transport::None;
+    QString host = QStringLiteral("127.0.0.1");
+    int port = 5425;
+    // How long connecting to the host may take, in milliseconds
+    int timeout = 10;
+    // The file the capture is written to when the transport is File
+    QString fileName;
+    Instrumentations instrumentation = Instrumentation::All;
+};
+
+// The settings are used when PhysX is initialized, which is when the first PhysicsWorld is
+// created or when one is created after all previous ones were destroyed. They default to the
+// values of the environment variables.
+Q_QUICK3DPHYSICS_EXPORT Settings settings();
+Q_QUICK3DPHYSICS_EXPORT void setSettings(const Settings &settings);
+
+// Creates the PVD and the transport and connects them, or returns nullptr when the PVD is off or
+// the connection failed
+physx::PxPvd *connect(physx::PxFoundation &foundation, physx::PxPvdTransport *&transport);
+// Makes the scene send its contacts, constraints and scene queries to a connected PVD
+void setupScene(physx::PxScene *scene);
+
+}
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(QPhysicsVisualDebugger::Instrumentations)
+
+QT_END_NAMESPACE
+
+#endif // QPHYSICSVISUALDEBUGGER_P_H
@@ -7,6 +7,7 @@
 #include "physxnode/qphysxworld_p.h"
 #include "qabstractphysicsnode_p.h"
 #include "qdebugdrawhelper_p.h"
+#include "qcollisiondebugmeshbuilder_p.h"
 #include "qphysicsutils_p.h"
 #include "qstaticphysxobjects_p.h"
 #include "qboxshape_p.h"
@@ -14,9 +15,15 @@
 #include "qconvexmeshshape_p.h"
 #include "qtrianglemeshshape_p.h"
 #include "qcharactercontroller_p.h"
+#include "qdynamicrigidbody_p.h"
 #include "qcapsuleshape_p.h"
 #include "qplaneshape_p.h"
 #include "qheightfieldshape_p.h"
+#include "qphysicsbodypool_p.h"
+#include "qcookingparameters_p.h"
+#include "qcacheutils_p.h"
+#include "qphysicsmeshutils_p_p.h"
+#include "qtquick3dphysics_tracepoints_p.h"
 
 #include "PxPhysicsAPI.h"
 #include "cooking/PxCooking.h"
@@ -27,9 +34,11 @@
 #include <QtQuick3D/private/qquick3ddefaultmaterial_p.h>
 #include <QtQuick3DUtils/private/qssgutils_p.h>
 
+#include <QtCore/QPointer>
+
 #include <QtEnvironmentVariables>
 
-#define PHYSX_ENABLE_PVD 0
+#include <cfloat>
 
 QT_BEGIN_NAMESPACE
 
@@ -147,6 +156,26 @@ QT_BEGIN_NAMESPACE
     parameter is how long in milliseconds the timestep was in the simulation.
 */
 
+/*!
+    \qmlsignal PhysicsWorld::bodiesWoke(list<PhysicsNode> bodies)
+    \since 6.9
+
+    This signal is emitted once per simulated frame if any dynamic bodies woke up during that frame.
+    The \a bodies parameter contains all the bodies that woke up.
+
+    \sa bodiesSlept, DynamicRigidBody::isSleeping
+*/
+
+/*!
+    \qmlsignal PhysicsWorld::bodiesSlept(list<PhysicsNode> bodies)
+    \since 6.9
+
+    This signal is emitted once per simulated frame if any dynamic bodies fell asleep during that
+    frame. The \a bodies parameter contains all the bodies that fell asleep.
+
+    \sa bodiesWoke, DynamicRigidBody::isSleeping
+*/
+
 /*!
     \qmlproperty int PhysicsWorld::numThreads
     \since 6.7
@@ -210,6 +239,149 @@ QT_BEGIN_NAMESPACE
     \sa PhysicsNode::bodyContact
 */
 
+/*!
+    \qmlproperty bool PhysicsWorld::directTransformUpdates
+    \since 6.9
+
+    This property controls how the simulated transforms are written back to the physics nodes.
+
+    When \c{false}, the position and rotation of every simulated body is updated through the
+    \l{Node::}{position} and \l{Node::}{rotation} properties, which emits their change signals and
+    re-evaluates any bindings depending on them.
+
+    When \c{true}, the transforms of all bodies are written directly into the nodes in one pass
+    and the change signals are then only emitted for nodes that have something connected to them.
+    A handler of one body therefore already sees the transforms of all other bodies from the same
+    frame. This reduces the per-frame cost for scenes with a large number of bodies.
+
+    The default value is \c{false}.
+*/
+
+/*!
+    \qmlproperty bool PhysicsWorld::preparing
+    \since 6.9
+    \readonly
+
+    This property is \c true while the world is preparing the collision shapes of the bodies
+    present when the simulation starts.
+
+    Before the initial bodies are added to the simulation, the meshes and height fields of all
+    their collision shapes that still need \l{Qt Quick 3D Physics Cooking}{cooking} are cooked in
+    parallel on background threads. The simulation does not advance until the preparation has
+    finished, but the application stays responsive. Shapes with
+    \l{ConvexMeshShape::}{asynchronous} set are not waited for.
+
+    Bodies created after the first frame do not stop the simulation. Their shapes are cooked in
+    the background and each body is added to the simulation as soon as its own shapes are ready.
+
+    \sa preparationProgress
+*/
+
+/*!
+    \qmlproperty real PhysicsWorld::preparationProgress
+    \since 6.9
+    \readonly
+
+    This property holds the progress of the current preparation phase, from \c 0 to \c 1. It is
+    \c 1 when the world is not \l{preparing}.
+
+    \sa preparing
+*/
+
+/*!
+    \qmlproperty CookingParameters PhysicsWorld::cookingParameters
+    \since 6.9
+
+    This property holds the default parameters for cooking the meshes of the
+    \l{ConvexMeshShape}{convex} and \l{TriangleMeshShape}{triangle} mesh shapes in this world.
+    Shapes that set their own \l{ConvexMeshShape::}{cookingParameters} use those instead.
+
+    Default value: \c null
+*/
+
+/*!
+    \qmlproperty bool PhysicsWorld::batchDebugDraw
+    \since 6.9
+
+    This property controls how the \l{forceDebugDraw}{debug drawing} of the collision shapes is
+    done.
+
+    When \c{false}, every drawn collision shape gets its own model in the scene.
+
+    When \c{true}, the wireframes of all shapes drawn in the same color are written into a single
+    geometry, so the number of models does not grow with the number of shapes. The wireframes of
+    shapes that did not move are kept from the previous frame, and a geometry is only updated when
+    one of its shapes moved or changed. This makes debug drawing of scenes with many bodies, most of
+    them static, considerably cheaper.
+
+    The default value is \c{false}.
+*/
+
+/*!
+    \qmlproperty enumeration PhysicsWorld::debugVisualization
+    \since 6.9
+
+    This property holds what the physics engine itself draws for debugging. It is either
+    \c PhysicsWorld.None or an OR combination of the following values:
+
+    \value PhysicsWorld.CollisionShapes
+        The collision shapes of all bodies.
+    \value PhysicsWorld.ContactPoints
+        The points where bodies touch, drawn as small crosses.
+    \value PhysicsWorld.ContactNormals
+        The normals of the contacts between bodies.
+    \value PhysicsWorld.BoundingBoxes
+        The axis-aligned bounding boxes the collision detection uses for the collision shapes.
+    \value PhysicsWorld.BodyAxes
+        The local coordinate axes of all bodies.
+
+    Unlike \l{forceDebugDraw}, the lines are generated by the physics engine during the
+    simulation and copied into a single geometry on the simulation thread, so this does not
+    add work on the GUI thread for every shape. The lines show the state of the previous simulation
+    step, and the size of normals, axes and contact points is derived from \l{typicalLength}.
+
+    The default value is \c{PhysicsWorld.None}.
+*/
+
+/*!
+    \qmlproperty Camera PhysicsWorld::debugDrawCamera
+    \since 6.9
+
+    This property holds the camera used to cull the \l{forceDebugDraw}{debug drawing} of the
+    collision shapes.
+
+    When set, only bodies whose bounds are inside the view of the camera, and not further away from
+    it than \l{debugDrawDistance}, are drawn. The debug models of bodies out of view are hidden and
+    not updated until the bodies come into view again. This keeps the cost of debug drawing low in
+    large scenes where only a small part is visible at a time.
+
+    The default value is \c{null}, which draws all bodies.
+
+    \sa debugDrawDistance
+*/
+
+/*!
+    \qmlproperty real PhysicsWorld::debugDrawDistance
+    \since 6.9
+
+    This property holds the largest distance from the \l{debugDrawCamera} at which the collision
+    shapes of a body are drawn for debugging. It has no effect if \l{debugDrawCamera} is not set.
+
+    The default value is \c{0}, which means that there is no limit.
+
+    \sa debugDrawCamera
+*/
+
+/*!
+    \qmlproperty PhysicsStatistics PhysicsWorld::statistics
+    \since 6.9
+    \readonly
+
+    This property holds the statistics of the last simulated frame: the time spent in each part of
+    the frame and counts of the bodies and collision pairs that were simulated. They are updated
+    before \l frameDone is emitted.
+*/
+
 Q_LOGGING_CATEGORY(lcQuick3dPhysics, "qt.quick3d.physics");
 
 /////////////////////////////////////////////////////////////////////////////
@@ -242,8 +414,30 @@ public slots:
         m_timer.restart();
 
         auto deltaSecs = qMin(float(deltaMS), maxTimestep) * 0.001f;
+        Q_TRACE_SCOPE(QPhysicsWorld_simulateFrame, deltaSecs * 1000);
+        QPhysXFrameStatistics &statistics = m_physx->statistics;
+        QElapsedTimer stepTimer;
+        stepTimer.start();
         m_physx->scene->simulate(deltaSecs);
+        statistics.simulateNsecs = stepTimer.nsecsElapsed();
+        stepTimer.start();
+        Q_TRACE(QPhysicsWorld_fetchResults_entry);
         m_physx->scene->fetchResults(true);
+        Q_TRACE(QPhysicsWorld_fetchResults_exit);
+        statistics.fetchNsecs = stepTimer.nsecsElapsed();
+        m_physx->scene->getSimulationStatistics(statistics.simulation);
+
+        // The render buffer is only valid until the next simulation step
+        const float visualizationScale = m_physx->scene->getVisualizationParameter(
+                physx::PxVisualizationParameter::eSCALE);
+        if (visualizationScale > 0.f) {
+            QDebugDrawHelper::writeVisualizationVertices(
+                    m_physx->scene->getRenderBuffer(), 0.1f * visualizationScale,
+                    m_physx->visualizationVertices, m_physx->visualizationBoundsMin,
+                    m_physx->visualizationBoundsMax);
+        } else if (!m_physx->visualizationVertices.isEmpty()) {
+            m_physx->visualizationVertices.clear();
+        }
 
         emit frameDone(deltaSecs);
     }
@@ -405,11 +599,21 @@ void QPhysicsWorld::registerContact(QAbstractPhysicsNode *sender, QAbstractPhysi
     m_registeredContacts.push_back(contact);
 }
 
+void QPhysicsWorld::registerSleepStateChange(QAbstractPhysicsNode *node, bool isSleeping)
+{
+    // Called from the physx simulation thread, see registerContact
+    if (isSleeping)
+        m_sleptNodes.push_back(node);
+    else
+        m_wokenNodes.push_back(node);
+}
+
 QPhysicsWorld::QPhysicsWorld(QObject *parent) : QObject(parent)
 {
     m_inDesignStudio = !qEnvironmentVariableIsEmpty("QML_PUPPET_MODE");
     m_physx = new QPhysXWorld;
     m_physx->createWorld();
+    m_statistics = new QPhysicsStatistics(this);
 
     worldManager.worlds.push_back(this);
     matchOrphanNodes();
@@ -423,9 +627,21 @@ QPhysicsWorld::~QPhysicsWorld()
         body->cleanup(m_physx);
         delete body;
     }
+    for (auto *bodyPool : std::as_const(m_bodyPools))
+        bodyPool->releaseActors();
+    releasePendingObjects();
     m_physx->deleteWorld();
     delete m_physx;
     worldManager.worlds.removeAll(this);
+
+    // Worlds waiting for this one to finish its step apply the geometry changes in their next frame
+    for (QPhysicsWorld *world : std::as_const(worldManager.worlds)) {
+        if (!world->m_waitingForGeometryChanges)
+            continue;
+        world->m_waitingForGeometryChanges = false;
+        if (world->m_running)
+            world->simulateNextFrame();
+    }
 }
 
 void QPhysicsWorld::classBegin() {}
@@ -435,7 +651,7 @@ void QPhysicsWorld::componentComplete()
     if ((!m_running && !m_inDesignStudio) || m_physicsInitialized)
         return;
     initPhysics();
-    emit simulateFrame(m_minTimestep, m_maxTimestep);
+    simulateNextFrame();
 }
 
 QVector3D QPhysicsWorld::gravity() const
@@ -494,8 +710,11 @@ void QPhysicsWorld::setRunning(bool running)
     if (!m_inDesignStudio) {
         if (m_running && !m_physicsInitialized)
             initPhysics();
-        if (m_running)
-            emit simulateFrame(m_minTimestep, m_maxTimestep);
+        if (m_running) {
+            m_waitingForPreparation = false;
+            m_waitingForGeometryChanges = false;
+            simulateNextFrame();
+        }
     }
     emit runningChanged(m_running);
 }
@@ -535,11 +754,8 @@ void QPhysicsWorld::setViewport(QQuick3DNode *viewport)
         delete material;
     m_debugMaterials.clear();
 
-    for (auto &holder : m_collisionShapeDebugModels) {
-        holder.releaseMeshPointer();
-        delete holder.model;
-    }
-    m_collisionShapeDebugModels.clear();
+    clearDebugModels();
+    releaseDebugVisualization();
 
     emit viewportChanged(m_viewport);
 }
@@ -609,11 +825,7 @@ void QPhysicsWorld::updateDebugDraw()
 {
     if (!(m_forceDebugDraw || m_hasIndividualDebugDraw)) {
         // Nothing to draw, trash all previous models (if any) and return
-        for (auto &holder : m_collisionShapeDebugModels) {
-            holder.releaseMeshPointer();
-            delete holder.model;
-        }
-        m_collisionShapeDebugModels.clear();
+        clearDebugModels();
         return;
     }
 
@@ -626,6 +838,11 @@ void QPhysicsWorld::updateDebugDraw()
     setupDebugMaterials(sceneNode);
     m_hasIndividualDebugDraw = false;
 
+    if (m_batchDebugDraw) {
+        updateBatchedDebugDraw(sceneNode);
+        return;
+    }
+
     // Store the collision shapes we have now so we can clear out the removed ones
     QSet<QPair<QAbstractCollisionShape *, QAbstractPhysXNode *>> currentCollisionShapes;
     currentCollisionShapes.reserve(m_collisionShapeDebugModels.size());
@@ -637,21 +854,34 @@ void QPhysicsWorld::updateDebugDraw()
         const auto &collisionShapes = node->frontendNode->getCollisionShapesList();
         const int materialIdx = static_cast<int>(node->getDebugDrawBodyType());
         const int length = collisionShapes.length();
+        const bool visible = isDebugDrawVisible(node);
         for (int idx = 0; idx < length; idx++) {
             const auto collisionShape = collisionShapes[idx];
 
             if (!m_forceDebugDraw && !collisionShape->enableDebugDraw())
                 continue;
 
-            DebugModelHolder &holder =
-                m_collisionShapeDebugModels[std::make_pair(collisionShape, node)];
-            auto &model = holder.model;
-
-            currentCollisionShapes.insert(std::make_pair(collisionShape, node));
-
             m_hasIndividualDebugDraw =
                     m_hasIndividualDebugDraw || collisionShape->enableDebugDraw();
 
+            const auto key = std::make_pair(collisionShape, node);
+
+            // Models of shapes out of view are kept as they are, but hidden
+            if (!visible) {
+                if (auto it = m_collisionShapeDebugModels.find(key);
+                    it != m_collisionShapeDebugModels.end()) {
+                    currentCollisionShapes.insert(key);
+                    if (it->model)
+                        it->model->setVisible(false);
+                }
+                continue;
+            }
+
+            DebugModelHolder &holder = m_collisionShapeDebugModels[key];
+            auto &model = holder.model;
+
+            currentCollisionShapes.insert(key);
+
             // Create/Update debug view infrastructure
             if (!model) {
                 model = new QQuick3DModel();
@@ -673,218 +903,588 @@ void QPhysicsWorld::updateDebugDraw()
                 }
             }
 
-            // Special handling of CharacterController since it has collision shapes,
-            // but not PhysX shapes
-            if (qobject_cast<QCharacterController *>(node->frontendNode)) {
-                QCapsuleShape *capsuleShape = qobject_cast<QCapsuleShape *>(collisionShape);
-                if (!capsuleShape)
-                    continue;
-
-                const float radius = capsuleShape->diameter() * 0.5;
-                const float halfHeight = capsuleShape->height() * 0.5;
-
-                if (!qFuzzyCompare(radius, holder.radius())
-                    || !qFuzzyCompare(halfHeight, holder.halfHeight())) {
-                    auto geom = QDebugDrawHelper::generateCapsuleGeometry(radius, halfHeight);
-                    geom->setParent(model);
-                    model->setGeometry(geom);
-                    holder.setRadius(radius);
-                    holder.setHalfHeight(halfHeight);
+            bool geometryChanged = false;
+            physx::PxTransform pose;
+            QVector3D scale(1, 1, 1);
+            if (!updateDebugGeometry(holder, node, idx, geometryChanged, pose, scale))
+                continue;
+
+            if (geometryChanged)
+                model->setGeometry(holder.geometry);
+
+            model->setScale(scale);
+            model->setRotation(QPhysicsUtils::toQtType(pose.q));
+            model->setPosition(QPhysicsUtils::toQtType(pose.p));
+        }
+    }
+
+    // Remove old collision shapes
+    m_collisionShapeDebugModels.removeIf(
+            [&](QHash<QPair<QAbstractCollisionShape *, QAbstractPhysXNode *>,
+                      DebugModelHolder>::iterator it) {
+                if (!currentCollisionShapes.contains(it.key())) {
+                    releaseDebugModel(*it);
+                    return true;
                 }
+                return false;
+            });
+}
 
-                model->setPosition(node->frontendNode->scenePosition());
-                model->setRotation(node->frontendNode->sceneRotation()
-                                   * QQuaternion::fromEulerAngles(0, 0, 90));
+// Writes the debug geometry of all shapes drawn with the same material into one model. The
+// vertices of a shape are only transformed again when the shape moved or changed, and the
+// geometry of a batch is only uploaded again when one of its shapes did.
+void QPhysicsWorld::updateBatchedDebugDraw(QQuick3DNode *sceneNode)
+{
+    using ShapeKey = QPair<QAbstractCollisionShape *, QAbstractPhysXNode *>;
+
+    const int batchCount = m_debugMaterials.size();
+    m_debugDrawBatches.resize(batchCount);
+
+    // The shapes drawn by each batch in this frame, in drawing order
+    QList<QList<ShapeKey>> batchShapes(batchCount);
+    QList<bool> batchChanged(batchCount, false);
+    QSet<ShapeKey> currentCollisionShapes;
+    currentCollisionShapes.reserve(m_collisionShapeDebugModels.size());
+
+    for (QAbstractPhysXNode *node : std::as_const(m_physXBodies)) {
+        if (!node->debugGeometryCapability())
+            continue;
+
+        const auto &collisionShapes = node->frontendNode->getCollisionShapesList();
+        const int batchIdx = static_cast<int>(node->getDebugDrawBodyType());
+        const int length = collisionShapes.length();
+        const bool visible = isDebugDrawVisible(node);
+        for (int idx = 0; idx < length; idx++) {
+            const auto collisionShape = collisionShapes[idx];
+
+            if (!m_forceDebugDraw && !collisionShape->enableDebugDraw())
+                continue;
+
+            m_hasIndividualDebugDraw =
+                    m_hasIndividualDebugDraw || collisionShape->enableDebugDraw();
+
+            const ShapeKey key(collisionShape, node);
+
+            // Shapes out of view keep their vertices but are left out of the batch
+            if (!visible) {
+                if (m_collisionShapeDebugModels.contains(key))
+                    currentCollisionShapes.insert(key);
                 continue;
             }
 
-            if (node->shapes.length() < length)
+            DebugModelHolder &holder = m_collisionShapeDebugModels[key];
+
+            // The geometry only holds the vertices of the shape and is never shown itself
+            bool geometryChanged = false;
+            physx::PxTransform pose;
+            QVector3D scale(1, 1, 1);
+            if (!updateDebugGeometry(holder, node, idx, geometryChanged, pose, scale)
+                || !holder.geometry)
                 continue;
 
-            const auto physXShape = node->shapes[idx];
-            auto localPose = physXShape->getLocalPose();
+            QMatrix4x4 transform;
+            transform.translate(QPhysicsUtils::toQtType(pose.p));
+            transform.rotate(QPhysicsUtils::toQtType(pose.q));
+            transform.scale(scale);
+
+            if (geometryChanged || holder.batch != batchIdx || transform != holder.transform) {
+                holder.vertices.clear();
+                holder.boundsMin = QVector3D(FLT_MAX, FLT_MAX, FLT_MAX);
+                holder.boundsMax = QVector3D(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+                QCollisionDebugMeshBuilder::appendTransformed(holder.vertices,
+                                                              holder.geometry->vertexData(),
+                                                              transform, holder.boundsMin,
+                                                              holder.boundsMax);
+                holder.transform = transform;
+                holder.batch = batchIdx;
+                batchChanged[batchIdx] = true;
+            }
+
+            batchShapes[batchIdx].append(key);
+            currentCollisionShapes.insert(key);
+        }
+    }
 
-            switch (physXShape->getGeometryType()) {
-            case physx::PxGeometryType::eBOX: {
-                physx::PxBoxGeometry boxGeometry;
-                physXShape->getBoxGeometry(boxGeometry);
-                const auto &halfExtentsOld = holder.halfExtents();
-                const auto halfExtents = QPhysicsUtils::toQtType(boxGeometry.halfExtents);
-                if (!qFuzzyCompare(halfExtentsOld, halfExtents)) {
-                    auto geom = QDebugDrawHelper::generateBoxGeometry(halfExtents);
-                    geom->setParent(model);
-                    model->setGeometry(geom);
-                    holder.setHalfExtents(halfExtents);
+    // Remove old collision shapes, the batches they were in have different shape lists now
+    m_collisionShapeDebugModels.removeIf(
+            [&](QHash<ShapeKey, DebugModelHolder>::iterator it) {
+                if (!currentCollisionShapes.contains(it.key())) {
+                    releaseDebugModel(*it);
+                    return true;
                 }
+                return false;
+            });
+
+    for (int batchIdx = 0; batchIdx < batchCount; batchIdx++) {
+        DebugDrawBatch &batch = m_debugDrawBatches[batchIdx];
+        if (!batchChanged[batchIdx] && batch.shapes == batchShapes[batchIdx])
+            continue;
+
+        batch.shapes = std::move(batchShapes[batchIdx]);
+
+        if (!batch.model) {
+            batch.model = new QQuick3DModel();
+            batch.model->setParentItem(sceneNode);
+            batch.model->setParent(sceneNode);
+            batch.model->setCastsShadows(false);
+            batch.model->setReceivesShadows(false);
+            batch.model->setCastsReflections(false);
+            QQmlListReference materialsRef(batch.model, "materials");
+            materialsRef.append(m_debugMaterials[batchIdx]);
+
+            batch.geometry = QDebugDrawHelper::generateBatchGeometry();
+            batch.geometry->setParent(batch.model);
+            batch.model->setGeometry(batch.geometry);
+        }
+
+        qsizetype size = 0;
+        for (const ShapeKey &key : std::as_const(batch.shapes))
+            size += m_collisionShapeDebugModels.constFind(key)->vertices.size();
+
+        QByteArray vertices;
+        vertices.reserve(size);
+        QVector3D boundsMin(FLT_MAX, FLT_MAX, FLT_MAX);
+        QVector3D boundsMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+        for (const ShapeKey &key : std::as_const(batch.shapes)) {
+            const DebugModelHolder &holder = *m_collisionShapeDebugModels.constFind(key);
+            vertices.append(holder.vertices);
+            boundsMin = QVector3D(qMin(boundsMin.x(), holder.boundsMin.x()),
+                                  qMin(boundsMin.y(), holder.boundsMin.y()),
+                                  qMin(boundsMin.z(), holder.boundsMin.z()));
+            boundsMax = QVector3D(qMax(boundsMax.x(), holder.boundsMax.x()),
+                                  qMax(boundsMax.y(), holder.boundsMax.y()),
+                                  qMax(boundsMax.z(), holder.boundsMax.z()));
+        }
+
+        batch.model->setVisible(!vertices.isEmpty());
+        if (!vertices.isEmpty())
+            batch.geometry->setBounds(boundsMin, boundsMax);
+        batch.geometry->setVertexData(vertices);
+        batch.geometry->update();
+    }
+}
+
+// Updates the debug geometry of a collision shape in the holder and returns false if it cannot be
+// drawn. geometryChanged is set if the holder got a different geometry. The pose and scale of the
+// geometry in the scene are returned in pose and scale.
+bool QPhysicsWorld::updateDebugGeometry(DebugModelHolder &holder, QAbstractPhysXNode *node, int idx,
+                                        bool &geometryChanged, physx::PxTransform &pose,
+                                        QVector3D &scale)
+{
+    const auto &collisionShapes = node->frontendNode->getCollisionShapesList();
+    const auto collisionShape = collisionShapes[idx];
+    const bool hasGeometry = holder.geometry != nullptr;
+    geometryChanged = false;
+
+    // Special handling of CharacterController since it has collision shapes,
+    // but not PhysX shapes
+    if (qobject_cast<QCharacterController *>(node->frontendNode)) {
+        QCapsuleShape *capsuleShape = qobject_cast<QCapsuleShape *>(collisionShape);
+        if (!capsuleShape)
+            return false;
+
+        const float radius = capsuleShape->diameter() * 0.5;
+        const float halfHeight = capsuleShape->height() * 0.5;
+
+        if (!qFuzzyCompare(radius, holder.radius())
+            || !qFuzzyCompare(halfHeight, holder.halfHeight()) || !hasGeometry) {
+            setDebugGeometry(holder, QDebugDrawHelper::generateCapsuleGeometry(radius, halfHeight));
+            geometryChanged = true;
+            holder.setRadius(radius);
+            holder.setHalfHeight(halfHeight);
+        }
 
+        pose = QPhysicsUtils::toPhysXTransform(node->frontendNode->scenePosition(),
+                                               node->frontendNode->sceneRotation()
+                                                       * QQuaternion::fromEulerAngles(0, 0, 90));
+        return true;
+    }
+
+    if (node->shapes.length() < collisionShapes.length())
+        return false;
+
+    const auto physXShape = node->shapes[idx];
+    auto localPose = physXShape->getLocalPose();
+
+    switch (physXShape->getGeometryType()) {
+    case physx::PxGeometryType::eBOX: {
+        physx::PxBoxGeometry boxGeometry;
+        physXShape->getBoxGeometry(boxGeometry);
+        const auto &halfExtentsOld = holder.halfExtents();
+        const auto halfExtents = QPhysicsUtils::toQtType(boxGeometry.halfExtents);
+        if (!qFuzzyCompare(halfExtentsOld, halfExtents) || !hasGeometry) {
+            setDebugGeometry(holder, QDebugDrawHelper::generateBoxGeometry(halfExtents));
+            geometryChanged = true;
+            holder.setHalfExtents(halfExtents);
+        }
+    }
+        break;
+
+    case physx::PxGeometryType::eSPHERE: {
+        physx::PxSphereGeometry sphereGeometry;
+        physXShape->getSphereGeometry(sphereGeometry);
+        const float radius = holder.radius();
+        if (!qFuzzyCompare(sphereGeometry.radius, radius) || !hasGeometry) {
+            setDebugGeometry(holder,
+                             QDebugDrawHelper::generateSphereGeometry(sphereGeometry.radius));
+            geometryChanged = true;
+            holder.setRadius(sphereGeometry.radius);
+        }
+    }
+        break;
+
+    case physx::PxGeometryType::eCAPSULE: {
+        physx::PxCapsuleGeometry capsuleGeometry;
+        physXShape->getCapsuleGeometry(capsuleGeometry);
+        const float radius = holder.radius();
+        const float halfHeight = holder.halfHeight();
+
+        if (!qFuzzyCompare(capsuleGeometry.radius, radius)
+            || !qFuzzyCompare(capsuleGeometry.halfHeight, halfHeight) || !hasGeometry) {
+            setDebugGeometry(holder,
+                             QDebugDrawHelper::generateCapsuleGeometry(
+                                     capsuleGeometry.radius, capsuleGeometry.halfHeight));
+            geometryChanged = true;
+            holder.setRadius(capsuleGeometry.radius);
+            holder.setHalfHeight(capsuleGeometry.halfHeight);
+        }
+    }
+        break;
+
+    case physx::PxGeometryType::ePLANE:{
+        physx::PxPlaneGeometry planeGeometry;
+        physXShape->getPlaneGeometry(planeGeometry);
+        // Special rotation
+        const QQuaternion rotation =
+                QPhysicsUtils::kMinus90YawRotation * QPhysicsUtils::toQtType(localPose.q);
+        localPose = physx::PxTransform(localPose.p, QPhysicsUtils::toPhysXType(rotation));
+
+        if (!hasGeometry) {
+            setDebugGeometry(holder, QDebugDrawHelper::generatePlaneGeometry());
+            geometryChanged = true;
+        }
+    }
+        break;
+
+    // For heightfield, convex mesh and triangle mesh we increase its reference count
+    // to make sure it does not get dereferenced and deleted so that the new mesh will
+    // have another memory address so we know when it has changed.
+    case physx::PxGeometryType::eHEIGHTFIELD: {
+        physx::PxHeightFieldGeometry heightFieldGeometry;
+        bool success = physXShape->getHeightFieldGeometry(heightFieldGeometry);
+        Q_ASSERT(success);
+        const float heightScale = holder.heightScale();
+        const float rowScale = holder.rowScale();
+        const float columnScale = holder.columnScale();
+
+        if (auto heightField = holder.getHeightField();
+            heightField && heightField != heightFieldGeometry.heightField) {
+            heightField->release();
+            holder.setHeightField(nullptr);
+        }
+
+        if (!qFuzzyCompare(heightFieldGeometry.heightScale, heightScale)
+            || !qFuzzyCompare(heightFieldGeometry.rowScale, rowScale)
+            || !qFuzzyCompare(heightFieldGeometry.columnScale, columnScale)
+            || !holder.getHeightField() || !hasGeometry) {
+            if (!holder.getHeightField()) {
+                heightFieldGeometry.heightField->acquireReference();
+                holder.setHeightField(heightFieldGeometry.heightField);
             }
-                break;
-
-            case physx::PxGeometryType::eSPHERE: {
-                physx::PxSphereGeometry sphereGeometry;
-                physXShape->getSphereGeometry(sphereGeometry);
-                const float radius = holder.radius();
-                if (!qFuzzyCompare(sphereGeometry.radius, radius)) {
-                    auto geom = QDebugDrawHelper::generateSphereGeometry(sphereGeometry.radius);
-                    geom->setParent(model);
-                    model->setGeometry(geom);
-                    holder.setRadius(sphereGeometry.radius);
-                }
+            const DebugGeometryKey key { heightFieldGeometry.heightField,
+                                         QVector3D(heightFieldGeometry.rowScale,
+                                                   heightFieldGeometry.heightScale,
+                                                   heightFieldGeometry.columnScale) };
+            QQuick3DGeometry *geometry = sharedDebugGeometry(key);
+            if (!geometry) {
+                geometry = QDebugDrawHelper::generateHeightFieldGeometry(
+                        heightFieldGeometry.heightField, heightFieldGeometry.heightScale,
+                        heightFieldGeometry.rowScale, heightFieldGeometry.columnScale);
             }
-                break;
-
-            case physx::PxGeometryType::eCAPSULE: {
-                physx::PxCapsuleGeometry capsuleGeometry;
-                physXShape->getCapsuleGeometry(capsuleGeometry);
-                const float radius = holder.radius();
-                const float halfHeight = holder.halfHeight();
-
-                if (!qFuzzyCompare(capsuleGeometry.radius, radius)
-                    || !qFuzzyCompare(capsuleGeometry.halfHeight, halfHeight)) {
-                    auto geom = QDebugDrawHelper::generateCapsuleGeometry(
-                            capsuleGeometry.radius, capsuleGeometry.halfHeight);
-                    geom->setParent(model);
-                    model->setGeometry(geom);
-                    holder.setRadius(capsuleGeometry.radius);
-                    holder.setHalfHeight(capsuleGeometry.halfHeight);
-                }
+            setSharedDebugGeometry(holder, key, geometry);
+            geometryChanged = true;
+            holder.setHeightScale(heightFieldGeometry.heightScale);
+            holder.setRowScale(heightFieldGeometry.rowScale);
+            holder.setColumnScale(heightFieldGeometry.columnScale);
+        }
+    }
+        break;
+
+    case physx::PxGeometryType::eCONVEXMESH: {
+        physx::PxConvexMeshGeometry convexMeshGeometry;
+        const bool success = physXShape->getConvexMeshGeometry(convexMeshGeometry);
+        Q_ASSERT(success);
+        const auto rotation = convexMeshGeometry.scale.rotation * localPose.q;
+        localPose = physx::PxTransform(localPose.p, rotation);
+        scale = QPhysicsUtils::toQtType(convexMeshGeometry.scale.scale);
+
+        if (auto convexMesh = holder.getConvexMesh();
+            convexMesh && convexMesh != convexMeshGeometry.convexMesh) {
+            convexMesh->release();
+            holder.setConvexMesh(nullptr);
+        }
+
+        if (!hasGeometry || !holder.getConvexMesh()) {
+            if (!holder.getConvexMesh()) {
+                convexMeshGeometry.convexMesh->acquireReference();
+                holder.setConvexMesh(convexMeshGeometry.convexMesh);
             }
-                break;
-
-            case physx::PxGeometryType::ePLANE:{
-                physx::PxPlaneGeometry planeGeometry;
-                physXShape->getPlaneGeometry(planeGeometry);
-                // Special rotation
-                const QQuaternion rotation =
-                        QPhysicsUtils::kMinus90YawRotation * QPhysicsUtils::toQtType(localPose.q);
-                localPose = physx::PxTransform(localPose.p, QPhysicsUtils::toPhysXType(rotation));
-
-                if (model->geometry() == nullptr) {
-                    auto geom = QDebugDrawHelper::generatePlaneGeometry();
-                    geom->setParent(model);
-                    model->setGeometry(geom);
-                }
+            const DebugGeometryKey key { convexMeshGeometry.convexMesh, QVector3D() };
+            QQuick3DGeometry *geometry = sharedDebugGeometry(key);
+            if (!geometry) {
+                geometry = QDebugDrawHelper::generateConvexMeshGeometry(
+                        convexMeshGeometry.convexMesh);
             }
-                break;
-
-            // For heightfield, convex mesh and triangle mesh we increase its reference count
-            // to make sure it does not get dereferenced and deleted so that the new mesh will
-            // have another memory address so we know when it has changed.
-            case physx::PxGeometryType::eHEIGHTFIELD: {
-                physx::PxHeightFieldGeometry heightFieldGeometry;
-                bool success = physXShape->getHeightFieldGeometry(heightFieldGeometry);
-                Q_ASSERT(success);
-                const float heightScale = holder.heightScale();
-                const float rowScale = holder.rowScale();
-                const float columnScale = holder.columnScale();
-
-                if (auto heightField = holder.getHeightField();
-                    heightField && heightField != heightFieldGeometry.heightField) {
-                    heightField->release();
-                    holder.setHeightField(nullptr);
-                }
+            setSharedDebugGeometry(holder, key, geometry);
+            geometryChanged = true;
+        }
+    }
+        break;
+
+    case physx::PxGeometryType::eTRIANGLEMESH: {
+        physx::PxTriangleMeshGeometry triangleMeshGeometry;
+        const bool success = physXShape->getTriangleMeshGeometry(triangleMeshGeometry);
+        Q_ASSERT(success);
+        const auto rotation = triangleMeshGeometry.scale.rotation * localPose.q;
+        localPose = physx::PxTransform(localPose.p, rotation);
+        scale = QPhysicsUtils::toQtType(triangleMeshGeometry.scale.scale);
+
+        if (auto triangleMesh = holder.getTriangleMesh();
+            triangleMesh && triangleMesh != triangleMeshGeometry.triangleMesh) {
+            triangleMesh->release();
+            holder.setTriangleMesh(nullptr);
+        }
 
-                if (!qFuzzyCompare(heightFieldGeometry.heightScale, heightScale)
-                    || !qFuzzyCompare(heightFieldGeometry.rowScale, rowScale)
-                    || !qFuzzyCompare(heightFieldGeometry.columnScale, columnScale)
-                    || !holder.getHeightField()) {
-                    if (!holder.getHeightField()) {
-                        heightFieldGeometry.heightField->acquireReference();
-                        holder.setHeightField(heightFieldGeometry.heightField);
-                    }
-                    auto geom = QDebugDrawHelper::generateHeightFieldGeometry(
-                            heightFieldGeometry.heightField, heightFieldGeometry.heightScale,
-                            heightFieldGeometry.rowScale, heightFieldGeometry.columnScale);
-                    geom->setParent(model);
-                    model->setGeometry(geom);
-                    holder.setHeightScale(heightFieldGeometry.heightScale);
-                    holder.setRowScale(heightFieldGeometry.rowScale);
-                    holder.setColumnScale(heightFieldGeometry.columnScale);
-                }
+        if (!hasGeometry || !holder.getTriangleMesh()) {
+            if (!holder.getTriangleMesh()) {
+                triangleMeshGeometry.triangleMesh->acquireReference();
+                holder.setTriangleMesh(triangleMeshGeometry.triangleMesh);
             }
-                break;
-
-            case physx::PxGeometryType::eCONVEXMESH: {
-                physx::PxConvexMeshGeometry convexMeshGeometry;
-                const bool success = physXShape->getConvexMeshGeometry(convexMeshGeometry);
-                Q_ASSERT(success);
-                const auto rotation = convexMeshGeometry.scale.rotation * localPose.q;
-                localPose = physx::PxTransform(localPose.p, rotation);
-                model->setScale(QPhysicsUtils::toQtType(convexMeshGeometry.scale.scale));
-
-                if (auto convexMesh = holder.getConvexMesh();
-                    convexMesh && convexMesh != convexMeshGeometry.convexMesh) {
-                    convexMesh->release();
-                    holder.setConvexMesh(nullptr);
-                }
-
-                if (!model->geometry() || !holder.getConvexMesh()) {
-                    if (!holder.getConvexMesh()) {
-                        convexMeshGeometry.convexMesh->acquireReference();
-                        holder.setConvexMesh(convexMeshGeometry.convexMesh);
-                    }
-                    auto geom = QDebugDrawHelper::generateConvexMeshGeometry(
-                            convexMeshGeometry.convexMesh);
-                    geom->setParent(model);
-                    model->setGeometry(geom);
-                }
+            const DebugGeometryKey key { triangleMeshGeometry.triangleMesh, QVector3D() };
+            QQuick3DGeometry *geometry = sharedDebugGeometry(key);
+            if (!geometry) {
+                geometry = QDebugDrawHelper::generateTriangleMeshGeometry(
+                        triangleMeshGeometry.triangleMesh);
             }
-                break;
-
-            case physx::PxGeometryType::eTRIANGLEMESH: {
-                physx::PxTriangleMeshGeometry triangleMeshGeometry;
-                const bool success = physXShape->getTriangleMeshGeometry(triangleMeshGeometry);
-                Q_ASSERT(success);
-                const auto rotation = triangleMeshGeometry.scale.rotation * localPose.q;
-                localPose = physx::PxTransform(localPose.p, rotation);
-                model->setScale(QPhysicsUtils::toQtType(triangleMeshGeometry.scale.scale));
-
-                if (auto triangleMesh = holder.getTriangleMesh();
-                    triangleMesh && triangleMesh != triangleMeshGeometry.triangleMesh) {
-                    triangleMesh->release();
-                    holder.setTriangleMesh(nullptr);
-                }
+            setSharedDebugGeometry(holder, key, geometry);
+            geometryChanged = true;
+        }
+    }
+        break;
 
-                if (!model->geometry() || !holder.getTriangleMesh()) {
-                    if (!holder.getTriangleMesh()) {
-                        triangleMeshGeometry.triangleMesh->acquireReference();
-                        holder.setTriangleMesh(triangleMeshGeometry.triangleMesh);
-                    }
-                    auto geom = QDebugDrawHelper::generateTriangleMeshGeometry(
-                            triangleMeshGeometry.triangleMesh);
-                    geom->setParent(model);
-                    model->setGeometry(geom);
-                }
-            }
-                break;
+    case physx::PxGeometryType::eINVALID:
+    case physx::PxGeometryType::eGEOMETRY_COUNT:
+        // should not happen
+        Q_UNREACHABLE();
+    }
 
-            case physx::PxGeometryType::eINVALID:
-            case physx::PxGeometryType::eGEOMETRY_COUNT:
-                // should not happen
-                Q_UNREACHABLE();
-            }
+    pose = node->getGlobalPose().transform(localPose);
+    return true;
+}
 
-            auto globalPose = node->getGlobalPose();
-            auto finalPose = globalPose.transform(localPose);
+// Mesh and height field debug geometries are shared by all shapes using the same PhysX object.
+// Since the holders keep a reference to that object, its address is not reused while the shared
+// geometry exists.
+QQuick3DGeometry *QPhysicsWorld::sharedDebugGeometry(const DebugGeometryKey &key) const
+{
+    const auto it = m_sharedDebugGeometries.constFind(key);
+    return it != m_sharedDebugGeometries.cend() ? it->geometry : nullptr;
+}
+
+void QPhysicsWorld::setSharedDebugGeometry(DebugModelHolder &holder, const DebugGeometryKey &key,
+                                           QQuick3DGeometry *geometry)
+{
+    if (!geometry) {
+        setDebugGeometry(holder, nullptr);
+        return;
+    }
+
+    // Take the new reference first in case the holder already uses the geometry
+    SharedDebugGeometry &shared = m_sharedDebugGeometries[key];
+    if (!shared.geometry)
+        shared.geometry = geometry;
+    Q_ASSERT(shared.geometry == geometry);
+    shared.refCount++;
 
-            model->setRotation(QPhysicsUtils::toQtType(finalPose.q));
-            model->setPosition(QPhysicsUtils::toQtType(finalPose.p));
+    releaseDebugGeometry(holder);
+    holder.geometry = geometry;
+    holder.geometryKey = key;
+    holder.sharedGeometry = true;
+}
+
+void QPhysicsWorld::setDebugGeometry(DebugModelHolder &holder, QQuick3DGeometry *geometry)
+{
+    releaseDebugGeometry(holder);
+    holder.geometry = geometry;
+}
+
+void QPhysicsWorld::releaseDebugGeometry(DebugModelHolder &holder)
+{
+    if (holder.sharedGeometry) {
+        const auto it = m_sharedDebugGeometries.find(holder.geometryKey);
+        Q_ASSERT(it != m_sharedDebugGeometries.end());
+        if (--it->refCount == 0) {
+            delete it->geometry;
+            m_sharedDebugGeometries.erase(it);
         }
+    } else {
+        delete holder.geometry;
     }
+    holder.geometry = nullptr;
+    holder.sharedGeometry = false;
+}
 
-    // Remove old collision shapes
-    m_collisionShapeDebugModels.removeIf(
-            [&](QHash<QPair<QAbstractCollisionShape *, QAbstractPhysXNode *>,
-                      DebugModelHolder>::iterator it) {
-                if (!currentCollisionShapes.contains(it.key())) {
-                    auto holder = it.value();
-                    holder.releaseMeshPointer();
-                    if (holder.model)
-                        delete holder.model;
-                    return true;
-                }
-                return false;
-            });
+void QPhysicsWorld::releaseDebugModel(DebugModelHolder &holder)
+{
+    delete holder.model;
+    holder.model = nullptr;
+    releaseDebugGeometry(holder);
+    holder.releaseMeshPointer();
+}
+
+void QPhysicsWorld::clearDebugModels()
+{
+    for (auto &holder : m_collisionShapeDebugModels)
+        releaseDebugModel(holder);
+    m_collisionShapeDebugModels.clear();
+
+    // The batch geometries are children of the models
+    for (auto &batch : m_debugDrawBatches)
+        delete batch.model;
+    m_debugDrawBatches.clear();
+}
+
+// Returns false if the body is certainly outside the view of the debug draw camera or further away
+// from it than the debug draw distance
+bool QPhysicsWorld::isDebugDrawVisible(QAbstractPhysXNode *node) const
+{
+    if (!m_debugDrawCamera)
+        return true;
+
+    const physx::PxBounds3 bounds = node->getWorldBounds();
+    // Planes have practically infinite bounds
+    constexpr float maxExtents = 1e9f;
+    if (bounds.isEmpty() || !bounds.isFinite() || bounds.getExtents().maxElement() > maxExtents)
+        return true;
+
+    const QVector3D boundsMin = QPhysicsUtils::toQtType(bounds.minimum);
+    const QVector3D boundsMax = QPhysicsUtils::toQtType(bounds.maximum);
+
+    if (m_debugDrawDistance > 0.f) {
+        const QVector3D cameraPosition = m_debugDrawCamera->scenePosition();
+        const QVector3D closest(qBound(boundsMin.x(), cameraPosition.x(), boundsMax.x()),
+                                qBound(boundsMin.y(), cameraPosition.y(), boundsMax.y()),
+                                qBound(boundsMin.z(), cameraPosition.z(), boundsMax.z()));
+        if ((closest - cameraPosition).lengthSquared() > m_debugDrawDistance * m_debugDrawDistance)
+            return false;
+    }
+
+    // The bounds are outside the frustum if all corners are behind the camera, or if all are in
+    // front of it and outside the same edge of the view
+    int behind = 0;
+    int left = 0;
+    int right = 0;
+    int above = 0;
+    int below = 0;
+    for (int i = 0; i < 8; i++) {
+        const QVector3D corner(i & 1 ? boundsMax.x() : boundsMin.x(),
+                               i & 2 ? boundsMax.y() : boundsMin.y(),
+                               i & 4 ? boundsMax.z() : boundsMin.z());
+        const QVector3D position = m_debugDrawCamera->mapToViewport(corner);
+        if (position.z() < 0.f) {
+            behind++;
+            continue;
+        }
+        left += position.x() < 0.f;
+        right += position.x() > 1.f;
+        above += position.y() < 0.f;
+        below += position.y() > 1.f;
+    }
+
+    if (behind == 8)
+        return false;
+    return behind > 0 || (left < 8 && right < 8 && above < 8 && below < 8);
+}
+
+// Applies the debug visualization settings to the scene and shows the lines PhysX generated for
+// the last frame
+void QPhysicsWorld::updateDebugVisualization()
+{
+    if (m_debugVisualizationDirty && m_physx->scene) {
+        using physx::PxVisualizationParameter;
+        auto *scene = m_physx->scene;
+        auto setParameter = [&](PxVisualizationParameter::Enum parameter, DebugVisualization flag) {
+            scene->setVisualizationParameter(parameter,
+                                             m_debugVisualization.testFlag(flag) ? 1.f : 0.f);
+        };
+
+        // The scale is the length of the normals and axes, and ten times the size of the points.
+        // Nothing is generated when it is zero.
+        const bool enabled = m_debugVisualization != DebugVisualization::None;
+        scene->setVisualizationParameter(PxVisualizationParameter::eSCALE,
+                                         enabled ? 0.5f * m_typicalLength : 0.f);
+        setParameter(PxVisualizationParameter::eCOLLISION_SHAPES,
+                     DebugVisualization::CollisionShapes);
+        setParameter(PxVisualizationParameter::eCONTACT_POINT, DebugVisualization::ContactPoints);
+        setParameter(PxVisualizationParameter::eCONTACT_NORMAL, DebugVisualization::ContactNormals);
+        setParameter(PxVisualizationParameter::eCOLLISION_AABBS, DebugVisualization::BoundingBoxes);
+        setParameter(PxVisualizationParameter::eACTOR_AXES, DebugVisualization::BodyAxes);
+        m_debugVisualizationDirty = false;
+    }
+
+    if (m_debugVisualization == DebugVisualization::None) {
+        releaseDebugVisualization();
+        return;
+    }
+
+    // Use scene node if no viewport has been specified
+    auto sceneNode = m_viewport ? m_viewport : m_scene;
+
+    if (sceneNode == nullptr)
+        return;
+
+    if (!m_debugVisualizationModel) {
+        m_debugVisualizationModel = new QQuick3DModel();
+        m_debugVisualizationModel->setParentItem(sceneNode);
+        m_debugVisualizationModel->setParent(sceneNode);
+        m_debugVisualizationModel->setCastsShadows(false);
+        m_debugVisualizationModel->setReceivesShadows(false);
+        m_debugVisualizationModel->setCastsReflections(false);
+
+        // The lines have the colors PhysX gave them
+        m_debugVisualizationMaterial = new QQuick3DDefaultMaterial();
+        m_debugVisualizationMaterial->setLineWidth(3);
+        m_debugVisualizationMaterial->setParentItem(sceneNode);
+        m_debugVisualizationMaterial->setParent(m_debugVisualizationModel);
+        m_debugVisualizationMaterial->setVertexColorsEnabled(true);
+        m_debugVisualizationMaterial->setLighting(QQuick3DDefaultMaterial::NoLighting);
+        m_debugVisualizationMaterial->setCullMode(QQuick3DMaterial::NoCulling);
+        QQmlListReference materialsRef(m_debugVisualizationModel, "materials");
+        materialsRef.append(m_debugVisualizationMaterial);
+
+        m_debugVisualizationGeometry = QDebugDrawHelper::generateVisualizationGeometry();
+        m_debugVisualizationGeometry->setParent(m_debugVisualizationModel);
+        m_debugVisualizationModel->setGeometry(m_debugVisualizationGeometry);
+    }
+
+    // The simulation thread writes to a copy of the shared data in the next frame
+    const QByteArray &vertices = m_physx->visualizationVertices;
+    m_debugVisualizationModel->setVisible(!vertices.isEmpty());
+    if (!vertices.isEmpty()) {
+        m_debugVisualizationGeometry->setBounds(m_physx->visualizationBoundsMin,
+                                                m_physx->visualizationBoundsMax);
+    }
+    m_debugVisualizationGeometry->setVertexData(vertices);
+    m_debugVisualizationGeometry->update();
+}
+
+void QPhysicsWorld::releaseDebugVisualization()
+{
+    // The material and geometry are children of the model
+    delete m_debugVisualizationModel;
+    m_debugVisualizationModel = nullptr;
+    m_debugVisualizationMaterial = nullptr;
+    m_debugVisualizationGeometry = nullptr;
 }
 
 static void collectPhysicsNodes(QQuick3DObject *node, QList<QAbstractPhysicsNode *> &nodes)
@@ -1072,6 +1672,28 @@ void QPhysicsWorld::updateDebugDrawDesignStudio()
             });
 }
 
+void QPhysicsWorld::releaseDebugModels(QAbstractPhysXNode *body)
+{
+    // The meshes of the body were changed in place, so the shapes of other bodies sharing their
+    // debug geometries have to be drawn again as well
+    QSet<DebugGeometryKey> changedGeometries;
+    for (auto it = m_collisionShapeDebugModels.cbegin(); it != m_collisionShapeDebugModels.cend();
+         ++it) {
+        if (it.key().second == body && it->sharedGeometry)
+            changedGeometries.insert(it->geometryKey);
+    }
+
+    m_collisionShapeDebugModels.removeIf(
+            [&](QHash<QPair<QAbstractCollisionShape *, QAbstractPhysXNode *>,
+                      DebugModelHolder>::iterator it) {
+                if (it.key().second != body
+                    && !(it->sharedGeometry && changedGeometries.contains(it->geometryKey)))
+                    return false;
+                releaseDebugModel(*it);
+                return true;
+            });
+}
+
 void QPhysicsWorld::disableDebugDraw()
 {
     m_hasIndividualDebugDraw = false;
@@ -1208,37 +1830,280 @@ void QPhysicsWorld::initPhysics()
 
 void QPhysicsWorld::frameFinished(float deltaTime)
 {
+    Q_TRACE_SCOPE(QPhysicsWorld_frameFinished, deltaTime * 1000);
+    m_simulating = false;
+    QPhysXFrameStatistics &statistics = m_physx->statistics;
+    statistics.commandNsecs = 0;
+    statistics.shapeRebuildCount = 0;
+    statistics.shapeGeometryUpdateCount = 0;
+
     matchOrphanNodes();
+
+    QElapsedTimer timer;
+    timer.start();
     emitContactCallbacks();
+    emitSleepStateCallbacks();
+    statistics.contactCallbackNsecs = timer.nsecsElapsed();
+
     cleanupRemovedNodes();
-    for (auto *node : std::as_const(m_newPhysicsNodes)) {
-        auto *body = node->createPhysXBackend();
-        body->init(this, m_physx);
-        m_physXBodies.push_back(body);
+    releasePendingObjects();
+
+    // The initial nodes wait until all their shapes have been cooked, later nodes are added one
+    // by one as soon as their own shapes are ready while the simulation keeps running
+    const bool preparing = !m_initialPreparationDone && prepareNewNodes();
+    if (!preparing) {
+        addCookedNodes();
+        m_initialPreparationDone = true;
     }
-    m_newPhysicsNodes.clear();
 
     QHash<QQuick3DNode *, QMatrix4x4> transformCache;
 
+    timer.start();
+    const bool geometryChangesApplied = applyGeometryChanges();
+    Q_TRACE(QPhysicsWorld_syncBodies_entry, int(m_physXBodies.size()));
     // TODO: Use dirty flag/dirty list to avoid redoing things that didn't change
     for (auto *physXBody : std::as_const(m_physXBodies)) {
         physXBody->markDirtyShapes();
+        const bool shapesDirty = physXBody->shapesDirty();
         physXBody->rebuildDirtyShapes(this, m_physx);
+        if (shapesDirty && !physXBody->shapesDirty())
+            statistics.shapeRebuildCount++;
         physXBody->updateFilters();
+        if (physXBody->shapeGeometriesDirty()) {
+            statistics.shapeGeometryUpdateCount++;
+            physXBody->updateShapeGeometries();
+            // The debug geometry of meshes changed in place is generated again
+            releaseDebugModels(physXBody);
+        }
 
         // Sync the physics world and the scene
         physXBody->sync(deltaTime, transformCache);
     }
+    m_shapeGeometriesChanged = false;
+    if (m_directTransformUpdates)
+        writeDirectTransforms();
 
-    updateDebugDraw();
+    for (auto *bodyPool : std::as_const(m_bodyPools))
+        bodyPool->sync(m_physx);
+    Q_TRACE(QPhysicsWorld_syncBodies_exit);
+    statistics.syncNsecs = timer.nsecsElapsed();
 
-    if (m_running)
-        emit simulateFrame(m_minTimestep, m_maxTimestep);
+    timer.start();
+    Q_TRACE(QPhysicsWorld_updateDebugDraw_entry);
+    updateDebugDraw();
+    updateDebugVisualization();
+    Q_TRACE(QPhysicsWorld_updateDebugDraw_exit);
+    statistics.debugDrawNsecs = timer.nsecsElapsed();
+
+    m_statistics->update(statistics);
+
+    if (m_running) {
+        // The simulation is resumed by finishPreparationJob() or by the world that applies the
+        // geometry changes
+        if (preparing)
+            m_waitingForPreparation = true;
+        else if (!geometryChangesApplied)
+            m_waitingForGeometryChanges = true;
+        else
+            simulateNextFrame();
+    }
     emit frameDone(deltaTime * 1000);
 }
 
+// Starts cooking the shapes of all new nodes in parallel, instead of cooking them one by one on
+// the GUI thread when the nodes are initialized. Returns true while the new nodes are waiting for
+// cooking to finish.
+bool QPhysicsWorld::prepareNewNodes()
+{
+    if (m_preparationJobs > 0)
+        return true;
+
+    QList<QFuture<QByteArray>> jobs;
+    for (auto *node : std::as_const(m_newPhysicsNodes)) {
+        for (auto *shape : node->getCollisionShapesList()) {
+            QFuture<QByteArray> job = shape->cookAsync();
+            if (job.isValid() && !job.isFinished())
+                jobs.append(job);
+        }
+    }
+
+    if (jobs.isEmpty())
+        return false;
+
+    m_preparationJobs = jobs.size();
+    m_finishedPreparationJobs = 0;
+    for (auto &job : jobs)
+        job.then(this, [this](const QByteArray & /*data*/) { finishPreparationJob(); });
+
+    qCDebug(lcQuick3dPhysics) << "Preparing" << m_preparationJobs << "collision shapes";
+    emit preparingChanged();
+    emit preparationProgressChanged();
+    return true;
+}
+
+// Starts cooking the shapes of the node if needed and returns true when all of them are ready
+static bool isNodeCooked(QAbstractPhysicsNode *node)
+{
+    bool cooked = true;
+    for (auto *shape : node->getCollisionShapesList()) {
+        QFuture<QByteArray> job = shape->cookAsync();
+        if (job.isValid() && !job.isFinished())
+            cooked = false;
+    }
+    return cooked;
+}
+
+// Creates the backends of the new nodes whose shapes have been cooked. The remaining nodes stay
+// in the list and are checked again in the next frame.
+void QPhysicsWorld::addCookedNodes()
+{
+    qsizetype pending = 0;
+    for (auto *node : std::as_const(m_newPhysicsNodes)) {
+        if (!isNodeCooked(node)) {
+            m_newPhysicsNodes[pending++] = node;
+            continue;
+        }
+        node->m_directTransformUpdates = m_directTransformUpdates;
+        auto *body = node->createPhysXBackend();
+        body->init(this, m_physx);
+        m_physXBodies.push_back(body);
+    }
+    m_newPhysicsNodes.resize(pending);
+}
+
+// Writes the transforms the sync pass read back from the simulation into all nodes in one pass and
+// only then emits the change signals for the nodes that have something connected to them, so
+// that the handlers see the transforms of all bodies from this frame
+void QPhysicsWorld::writeDirectTransforms()
+{
+    QList<QPointer<QAbstractPhysicsNode>> changedNodes;
+    for (auto *physXBody : std::as_const(m_physXBodies)) {
+        QAbstractPhysicsNode *node = physXBody->frontendNode;
+        if (node && node->m_hasPendingTransform && node->writePendingTransform())
+            changedNodes.append(node);
+    }
+
+    // The handlers can delete other nodes
+    for (const auto &node : std::as_const(changedNodes)) {
+        if (node)
+            node->emitTransformChanged();
+    }
+}
+
+// Applies the changes of meshes and height fields that were modified in place. They are shared by
+// all worlds, so the PhysX objects can only be changed while none of the worlds is simulating.
+// Returns false if the changes have to wait until the other worlds have finished their step.
+bool QPhysicsWorld::applyGeometryChanges()
+{
+    if (!QQuick3DPhysicsMeshManager::hasPendingRefits()
+        && !QHeightFieldShape::hasPendingModifications())
+        return true;
+
+    for (QPhysicsWorld *world : std::as_const(worldManager.worlds)) {
+        if (world->m_simulating)
+            return false;
+    }
+
+    const QSet<QQuick3DPhysicsMesh *> refittedMeshes =
+            QQuick3DPhysicsMeshManager::applyPendingRefits();
+    const QSet<QQuick3DPhysicsHeightField *> modifiedHeightFields =
+            QHeightFieldShape::applyPendingModifications();
+
+    for (QPhysicsWorld *world : std::as_const(worldManager.worlds))
+        world->notifyGeometryChanges(refittedMeshes, modifiedHeightFields);
+
+    // The worlds that stopped for the changes continue with their next step
+    for (QPhysicsWorld *world : std::as_const(worldManager.worlds)) {
+        if (!world->m_waitingForGeometryChanges)
+            continue;
+        world->m_waitingForGeometryChanges = false;
+        if (world->m_running)
+            world->simulateNextFrame();
+    }
+    return true;
+}
+
+void QPhysicsWorld::notifyGeometryChanges(
+        const QSet<QQuick3DPhysicsMesh *> &refittedMeshes,
+        const QSet<QQuick3DPhysicsHeightField *> &modifiedHeightFields)
+{
+    if (refittedMeshes.isEmpty() && modifiedHeightFields.isEmpty())
+        return;
+
+    // Every body sharing a changed mesh or height field updates its shapes, not only the ones
+    // whose shape noticed the change
+    auto notifyShape = [&](QAbstractCollisionShape *shape) {
+        if (auto *meshShape = qobject_cast<QMeshShape *>(shape)) {
+            if (refittedMeshes.contains(meshShape->physicsMesh())) {
+                emit meshShape->needsGeometryUpdate(meshShape);
+                m_shapeGeometriesChanged = true;
+            }
+        } else if (auto *heightFieldShape = qobject_cast<QHeightFieldShape *>(shape)) {
+            if (modifiedHeightFields.contains(heightFieldShape->physicsHeightField())) {
+                emit heightFieldShape->needsGeometryUpdate(heightFieldShape);
+                m_shapeGeometriesChanged = true;
+            }
+        }
+    };
+    for (auto *physXBody : std::as_const(m_physXBodies)) {
+        if (!physXBody->frontendNode)
+            continue;
+        for (auto *shape : physXBody->frontendNode->getCollisionShapesList())
+            notifyShape(shape);
+    }
+    for (auto *bodyPool : std::as_const(m_bodyPools))
+        notifyShape(bodyPool->collisionShape());
+}
+
+// Updates the shapes using meshes or height fields that were changed outside of frameFinished()
+void QPhysicsWorld::updateChangedShapeGeometries()
+{
+    for (auto *physXBody : std::as_const(m_physXBodies)) {
+        if (physXBody->shapeGeometriesDirty()) {
+            physXBody->updateShapeGeometries();
+            releaseDebugModels(physXBody);
+        }
+    }
+    for (auto *bodyPool : std::as_const(m_bodyPools))
+        bodyPool->sync(m_physx);
+    m_shapeGeometriesChanged = false;
+}
+
+void QPhysicsWorld::simulateNextFrame()
+{
+    if (m_shapeGeometriesChanged)
+        updateChangedShapeGeometries();
+    m_simulating = true;
+    emit simulateFrame(m_minTimestep, m_maxTimestep);
+}
+
+void QPhysicsWorld::finishPreparationJob()
+{
+    if (m_preparationJobs == 0)
+        return;
+
+    m_finishedPreparationJobs++;
+    if (m_finishedPreparationJobs < m_preparationJobs) {
+        emit preparationProgressChanged();
+        return;
+    }
+
+    m_preparationJobs = 0;
+    m_finishedPreparationJobs = 0;
+    emit preparationProgressChanged();
+    emit preparingChanged();
+    QCacheUtils::saveCacheIndex();
+
+    if (m_waitingForPreparation) {
+        m_waitingForPreparation = false;
+        if (m_running)
+            simulateNextFrame();
+    }
+}
+
 void QPhysicsWorld::frameFinishedDesignStudio()
 {
+    m_simulating = false;
     // Note sure if this is needed but do it anyway
     matchOrphanNodes();
     emitContactCallbacks();
@@ -1248,7 +2113,7 @@ void QPhysicsWorld::frameFinishedDesignStudio()
 
     updateDebugDrawDesignStudio();
 
-    emit simulateFrame(m_minTimestep, m_maxTimestep);
+    simulateNextFrame();
 }
 
 QPhysicsWorld *QPhysicsWorld::getWorld(QQuick3DNode *node)
@@ -1326,6 +2191,7 @@ void QPhysicsWorld::findPhysicsNodes()
 
 void QPhysicsWorld::emitContactCallbacks()
 {
+    Q_TRACE_SCOPE(QPhysicsWorld_emitContactCallbacks, int(m_registeredContacts.size()));
     for (const QPhysicsWorld::BodyContact &contact : m_registeredContacts) {
         if (m_removedPhysicsNodes.contains(contact.sender)
             || m_removedPhysicsNodes.contains(contact.receiver))
@@ -1337,6 +2203,56 @@ void QPhysicsWorld::emitContactCallbacks()
     m_registeredContacts.clear();
 }
 
+void QPhysicsWorld::registerBodyPool(QPhysicsBodyPool *bodyPool)
+{
+    if (!m_bodyPools.contains(bodyPool))
+        m_bodyPools.push_back(bodyPool);
+}
+
+void QPhysicsWorld::deregisterBodyPool(QPhysicsBodyPool *bodyPool)
+{
+    m_bodyPools.removeAll(bodyPool);
+}
+
+void QPhysicsWorld::releaseLater(physx::PxBase *object)
+{
+    // The simulation might be running so the object is released when the current frame is done
+    m_pendingReleases.push_back(object);
+}
+
+void QPhysicsWorld::releasePendingObjects()
+{
+    for (auto *object : std::as_const(m_pendingReleases))
+        object->release();
+    m_pendingReleases.clear();
+    // Deserialized meshes whose last shape was released above can free their memory now
+    QCacheUtils::releaseUnusedSerializedData();
+}
+
+void QPhysicsWorld::emitSleepStateCallbacks()
+{
+    const auto updateNodes = [this](QList<QAbstractPhysicsNode *> &nodes, bool isSleeping) {
+        nodes.removeIf([this](QAbstractPhysicsNode *node) {
+            return m_removedPhysicsNodes.contains(node);
+        });
+        for (QAbstractPhysicsNode *node : std::as_const(nodes)) {
+            if (auto *dynamicBody = qobject_cast<QDynamicRigidBody *>(node))
+                dynamicBody->setIsSleeping(isSleeping);
+        }
+    };
+
+    updateNodes(m_wokenNodes, false);
+    updateNodes(m_sleptNodes, true);
+
+    if (!m_wokenNodes.isEmpty())
+        emit bodiesWoke(m_wokenNodes);
+    if (!m_sleptNodes.isEmpty())
+        emit bodiesSlept(m_sleptNodes);
+
+    m_wokenNodes.clear();
+    m_sleptNodes.clear();
+}
+
 physx::PxPhysics *QPhysicsWorld::getPhysics()
 {
     return StaticPhysXObjects::getReference().physics;
@@ -1427,6 +2343,149 @@ void QPhysicsWorld::setReportStaticKinematicCollisions(bool newReportStaticKinem
     emit reportStaticKinematicCollisionsChanged();
 }
 
+bool QPhysicsWorld::directTransformUpdates() const
+{
+    return m_directTransformUpdates;
+}
+
+void QPhysicsWorld::setDirectTransformUpdates(bool newDirectTransformUpdates)
+{
+    if (m_directTransformUpdates == newDirectTransformUpdates)
+        return;
+    m_directTransformUpdates = newDirectTransformUpdates;
+
+    for (auto *physXBody : std::as_const(m_physXBodies)) {
+        if (physXBody->frontendNode)
+            physXBody->frontendNode->m_directTransformUpdates = m_directTransformUpdates;
+    }
+
+    emit directTransformUpdatesChanged();
+}
+
+bool QPhysicsWorld::isPreparing() const
+{
+    return m_preparationJobs > 0;
+}
+
+float QPhysicsWorld::preparationProgress() const
+{
+    if (m_preparationJobs == 0)
+        return 1.f;
+    return float(m_finishedPreparationJobs) / float(m_preparationJobs);
+}
+
+QCookingParameters *QPhysicsWorld::cookingParameters() const
+{
+    return m_cookingParameters;
+}
+
+void QPhysicsWorld::setCookingParameters(QCookingParameters *newCookingParameters)
+{
+    if (m_cookingParameters == newCookingParameters)
+        return;
+    if (m_cookingParameters)
+        m_cookingParameters->disconnect(this);
+
+    m_cookingParameters = newCookingParameters;
+
+    if (m_cookingParameters != nullptr) {
+        connect(m_cookingParameters, &QObject::destroyed, this,
+                [this] { setCookingParameters(nullptr); });
+        connect(m_cookingParameters, &QCookingParameters::settingsChanged, this,
+                &QPhysicsWorld::updateCookingSettings);
+    }
+
+    updateCookingSettings();
+    emit cookingParametersChanged();
+}
+
+bool QPhysicsWorld::batchDebugDraw() const
+{
+    return m_batchDebugDraw;
+}
+
+void QPhysicsWorld::setBatchDebugDraw(bool newBatchDebugDraw)
+{
+    if (m_batchDebugDraw == newBatchDebugDraw)
+        return;
+    m_batchDebugDraw = newBatchDebugDraw;
+
+    // The models of one mode are not used by the other
+    clearDebugModels();
+    if (m_forceDebugDraw || m_hasIndividualDebugDraw)
+        updateDebugDraw();
+
+    emit batchDebugDrawChanged();
+}
+
+QPhysicsWorld::DebugVisualizations QPhysicsWorld::debugVisualization() const
+{
+    return m_debugVisualization;
+}
+
+void QPhysicsWorld::setDebugVisualization(DebugVisualizations newDebugVisualization)
+{
+    if (m_debugVisualization == newDebugVisualization)
+        return;
+    m_debugVisualization = newDebugVisualization;
+    // The scene is only changed between frames
+    m_debugVisualizationDirty = true;
+    emit debugVisualizationChanged();
+}
+
+QQuick3DCamera *QPhysicsWorld::debugDrawCamera() const
+{
+    return m_debugDrawCamera;
+}
+
+void QPhysicsWorld::setDebugDrawCamera(QQuick3DCamera *newDebugDrawCamera)
+{
+    if (m_debugDrawCamera == newDebugDrawCamera)
+        return;
+    if (m_debugDrawCamera)
+        m_debugDrawCamera->disconnect(this);
+
+    m_debugDrawCamera = newDebugDrawCamera;
+
+    if (m_debugDrawCamera != nullptr) {
+        connect(m_debugDrawCamera, &QObject::destroyed, this,
+                [this] { setDebugDrawCamera(nullptr); });
+    }
+
+    emit debugDrawCameraChanged();
+}
+
+float QPhysicsWorld::debugDrawDistance() const
+{
+    return m_debugDrawDistance;
+}
+
+void QPhysicsWorld::setDebugDrawDistance(float newDebugDrawDistance)
+{
+    if (qFuzzyCompare(m_debugDrawDistance, newDebugDrawDistance))
+        return;
+    m_debugDrawDistance = newDebugDrawDistance;
+    emit debugDrawDistanceChanged();
+}
+
+QPhysicsStatistics *QPhysicsWorld::statistics() const
+{
+    return m_statistics;
+}
+
+// Lets the mesh shapes in the world cook their meshes again if the settings they use changed
+void QPhysicsWorld::updateCookingSettings()
+{
+    for (auto *physXBody : std::as_const(m_physXBodies)) {
+        if (!physXBody->frontendNode)
+            continue;
+        for (auto *shape : physXBody->frontendNode->getCollisionShapesList()) {
+            if (auto *meshShape = qobject_cast<QMeshShape *>(shape))
+                meshShape->updateCookingSettings();
+        }
+    }
+}
+
 QT_END_NAMESPACE
 
 #include "qphysicsworld.moc"
@@ -16,15 +16,20 @@
 //
 
 #include <QtQuick3DPhysics/qtquick3dphysicsglobal.h>
+#include <QtQuick3DPhysics/private/qcookingparameters_p.h>
+#include <QtQuick3DPhysics/private/qphysicsstatistics_p.h>
 
+#include <QtCore/QHash>
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QObject>
 #include <QtCore/QTimerEvent>
 #include <QtCore/QElapsedTimer>
+#include <QtGui/QMatrix4x4>
 #include <QtGui/QVector3D>
 #include <QtQml/qqml.h>
 #include <QBasicTimer>
 
+#include <QtQuick3D/private/qquick3dcamera_p.h>
 #include <QtQuick3D/private/qquick3dviewport_p.h>
 
 namespace physx {
@@ -39,6 +44,8 @@ class PxControllerManager;
 class PxConvexMesh;
 class PxTriangleMesh;
 class PxHeightField;
+class PxBase;
+class PxTransform;
 }
 
 QT_BEGIN_NAMESPACE
@@ -53,6 +60,9 @@ class QQuick3DModel;
 class QQuick3DGeometry;
 class QQuick3DDefaultMaterial;
 class QPhysXWorld;
+class QPhysicsBodyPool;
+class QQuick3DPhysicsMesh;
+class QQuick3DPhysicsHeightField;
 
 class Q_QUICK3DPHYSICS_EXPORT QPhysicsWorld : public QObject, public QQmlParserStatus
 {
@@ -84,6 +94,23 @@ class Q_QUICK3DPHYSICS_EXPORT QPhysicsWorld : public QObject, public QQmlParserS
     Q_PROPERTY(bool reportStaticKinematicCollisions READ reportStaticKinematicCollisions WRITE
                        setReportStaticKinematicCollisions NOTIFY
                                reportStaticKinematicCollisionsChanged FINAL REVISION(6, 7))
+    Q_PROPERTY(bool directTransformUpdates READ directTransformUpdates WRITE
+                       setDirectTransformUpdates NOTIFY directTransformUpdatesChanged FINAL
+                               REVISION(6, 9))
+    Q_PROPERTY(bool preparing READ isPreparing NOTIFY preparingChanged FINAL REVISION(6, 9))
+    Q_PROPERTY(float preparationProgress READ preparationProgress NOTIFY
+                       preparationProgressChanged FINAL REVISION(6, 9))
+    Q_PROPERTY(QCookingParameters *cookingParameters READ cookingParameters WRITE
+                       setCookingParameters NOTIFY cookingParametersChanged FINAL REVISION(6, 9))
+    Q_PROPERTY(bool batchDebugDraw READ batchDebugDraw WRITE setBatchDebugDraw NOTIFY
+                       batchDebugDrawChanged FINAL REVISION(6, 9))
+    Q_PROPERTY(DebugVisualizations debugVisualization READ debugVisualization WRITE
+                       setDebugVisualization NOTIFY debugVisualizationChanged FINAL REVISION(6, 9))
+    Q_PROPERTY(QQuick3DCamera *debugDrawCamera READ debugDrawCamera WRITE setDebugDrawCamera NOTIFY
+                       debugDrawCameraChanged FINAL REVISION(6, 9))
+    Q_PROPERTY(float debugDrawDistance READ debugDrawDistance WRITE setDebugDrawDistance NOTIFY
+                       debugDrawDistanceChanged FINAL REVISION(6, 9))
+    Q_PROPERTY(QPhysicsStatistics *statistics READ statistics CONSTANT FINAL REVISION(6, 9))
 
     QML_NAMED_ELEMENT(PhysicsWorld)
 
@@ -91,6 +118,17 @@ public:
     explicit QPhysicsWorld(QObject *parent = nullptr);
     ~QPhysicsWorld();
 
+    enum class DebugVisualization {
+        None = 0,
+        CollisionShapes = 1 << 0,
+        ContactPoints = 1 << 1,
+        ContactNormals = 1 << 2,
+        BoundingBoxes = 1 << 3,
+        BodyAxes = 1 << 4,
+    };
+    Q_DECLARE_FLAGS(DebugVisualizations, DebugVisualization)
+    Q_FLAG(DebugVisualizations)
+
     void classBegin() override;
     void componentComplete() override;
 
@@ -115,6 +153,11 @@ public:
     void registerContact(QAbstractPhysicsNode *sender, QAbstractPhysicsNode *receiver,
                          const QVector<QVector3D> &positions, const QVector<QVector3D> &impulses,
                          const QVector<QVector3D> &normals);
+    void registerSleepStateChange(QAbstractPhysicsNode *node, bool isSleeping);
+
+    void registerBodyPool(QPhysicsBodyPool *bodyPool);
+    void deregisterBodyPool(QPhysicsBodyPool *bodyPool);
+    void releaseLater(physx::PxBase *object);
 
     Q_REVISION(6, 5) QQuick3DNode *viewport() const;
     void setHasIndividualDebugDraw();
@@ -127,6 +170,21 @@ public:
     Q_REVISION(6, 7) bool reportStaticKinematicCollisions() const;
     Q_REVISION(6, 7)
     void setReportStaticKinematicCollisions(bool newReportStaticKinematicCollisions);
+    Q_REVISION(6, 9) bool directTransformUpdates() const;
+    Q_REVISION(6, 9) void setDirectTransformUpdates(bool newDirectTransformUpdates);
+    Q_REVISION(6, 9) bool isPreparing() const;
+    Q_REVISION(6, 9) float preparationProgress() const;
+    Q_REVISION(6, 9) QCookingParameters *cookingParameters() const;
+    Q_REVISION(6, 9) void setCookingParameters(QCookingParameters *newCookingParameters);
+    Q_REVISION(6, 9) bool batchDebugDraw() const;
+    Q_REVISION(6, 9) void setBatchDebugDraw(bool newBatchDebugDraw);
+    Q_REVISION(6, 9) DebugVisualizations debugVisualization() const;
+    Q_REVISION(6, 9) void setDebugVisualization(DebugVisualizations newDebugVisualization);
+    Q_REVISION(6, 9) QQuick3DCamera *debugDrawCamera() const;
+    Q_REVISION(6, 9) void setDebugDrawCamera(QQuick3DCamera *newDebugDrawCamera);
+    Q_REVISION(6, 9) float debugDrawDistance() const;
+    Q_REVISION(6, 9) void setDebugDrawDistance(float newDebugDrawDistance);
+    Q_REVISION(6, 9) QPhysicsStatistics *statistics() const;
 
 public slots:
     void setGravity(QVector3D gravity);
@@ -159,6 +217,16 @@ signals:
     Q_REVISION(6, 7) void numThreadsChanged();
     Q_REVISION(6, 7) void reportKinematicKinematicCollisionsChanged();
     Q_REVISION(6, 7) void reportStaticKinematicCollisionsChanged();
+    Q_REVISION(6, 9) void directTransformUpdatesChanged();
+    Q_REVISION(6, 9) void bodiesWoke(const QList<QAbstractPhysicsNode *> &bodies);
+    Q_REVISION(6, 9) void bodiesSlept(const QList<QAbstractPhysicsNode *> &bodies);
+    Q_REVISION(6, 9) void preparingChanged();
+    Q_REVISION(6, 9) void preparationProgressChanged();
+    Q_REVISION(6, 9) void cookingParametersChanged();
+    Q_REVISION(6, 9) void batchDebugDrawChanged();
+    Q_REVISION(6, 9) void debugVisualizationChanged();
+    Q_REVISION(6, 9) void debugDrawCameraChanged();
+    Q_REVISION(6, 9) void debugDrawDistanceChanged();
 
 private:
     void frameFinished(float deltaTime);
@@ -166,12 +234,30 @@ private:
     void initPhysics();
     void cleanupRemovedNodes();
     void updateDebugDraw();
+    void updateBatchedDebugDraw(QQuick3DNode *sceneNode);
     void updateDebugDrawDesignStudio();
     void setupDebugMaterials(QQuick3DNode *sceneNode);
     void disableDebugDraw();
+    void releaseDebugModels(QAbstractPhysXNode *body);
+    void clearDebugModels();
+    void updateDebugVisualization();
+    bool isDebugDrawVisible(QAbstractPhysXNode *node) const;
+    void releaseDebugVisualization();
     void matchOrphanNodes();
     void findPhysicsNodes();
     void emitContactCallbacks();
+    void emitSleepStateCallbacks();
+    void releasePendingObjects();
+    bool prepareNewNodes();
+    void addCookedNodes();
+    bool applyGeometryChanges();
+    void notifyGeometryChanges(const QSet<QQuick3DPhysicsMesh *> &refittedMeshes,
+                               const QSet<QQuick3DPhysicsHeightField *> &modifiedHeightFields);
+    void updateChangedShapeGeometries();
+    void simulateNextFrame();
+    void writeDirectTransforms();
+    void finishPreparationJob();
+    void updateCookingSettings();
 
     struct BodyContact
     {
@@ -182,12 +268,46 @@ private:
         QVector<QVector3D> normals;
     };
 
+    // Identifies a debug geometry that is shared by all shapes using the same mesh or height field
+    struct DebugGeometryKey
+    {
+        void *mesh = nullptr;
+        // The row, height and column scales of height fields, which are part of their geometry
+        QVector3D scale;
+
+        friend bool operator==(const DebugGeometryKey &a, const DebugGeometryKey &b)
+        {
+            return a.mesh == b.mesh && a.scale == b.scale;
+        }
+        friend size_t qHash(const DebugGeometryKey &key, size_t seed = 0)
+        {
+            return qHashMulti(seed, key.mesh, key.scale.x(), key.scale.y(), key.scale.z());
+        }
+    };
+
+    struct SharedDebugGeometry
+    {
+        QQuick3DGeometry *geometry = nullptr;
+        int refCount = 0;
+    };
+
     struct DebugModelHolder
     {
         QQuick3DModel *model = nullptr;
         QQuick3DGeometry *geometry = nullptr;
         QVector3D data;
         void *ptr = nullptr;
+        // Set when the geometry is shared with other holders instead of owned by this one
+        bool sharedGeometry = false;
+        DebugGeometryKey geometryKey;
+
+        // Used by the batched debug draw: the vertices of the geometry in scene coordinates, the
+        // transform they were computed with and the batch they are drawn in
+        QByteArray vertices;
+        QMatrix4x4 transform;
+        QVector3D boundsMin;
+        QVector3D boundsMax;
+        int batch = -1;
 
         void releaseMeshPointer();
 
@@ -219,15 +339,39 @@ private:
         void setHeightField(physx::PxHeightField *hf);
     };
 
+    // All shapes drawn with the same debug material when the debug draw is batched
+    struct DebugDrawBatch
+    {
+        QQuick3DModel *model = nullptr;
+        QQuick3DGeometry *geometry = nullptr;
+        QList<QPair<QAbstractCollisionShape *, QAbstractPhysXNode *>> shapes;
+    };
+
+    bool updateDebugGeometry(DebugModelHolder &holder, QAbstractPhysXNode *node, int idx,
+                             bool &geometryChanged, physx::PxTransform &pose, QVector3D &scale);
+    QQuick3DGeometry *sharedDebugGeometry(const DebugGeometryKey &key) const;
+    void setSharedDebugGeometry(DebugModelHolder &holder, const DebugGeometryKey &key,
+                                QQuick3DGeometry *geometry);
+    void setDebugGeometry(DebugModelHolder &holder, QQuick3DGeometry *geometry);
+    void releaseDebugGeometry(DebugModelHolder &holder);
+    void releaseDebugModel(DebugModelHolder &holder);
+
     QList<QAbstractPhysXNode *> m_physXBodies;
     QList<QAbstractPhysicsNode *> m_newPhysicsNodes;
     QHash<QPair<QAbstractCollisionShape *, QAbstractPhysicsNode *>, DebugModelHolder>
             m_DesignStudioDebugModels;
     QHash<QPair<QAbstractCollisionShape *, QAbstractPhysXNode *>, DebugModelHolder>
             m_collisionShapeDebugModels;
+    QList<DebugDrawBatch> m_debugDrawBatches;
+    QHash<DebugGeometryKey, SharedDebugGeometry> m_sharedDebugGeometries;
     QSet<QAbstractPhysicsNode *> m_removedPhysicsNodes;
     QMutex m_removedPhysicsNodesMutex;
     QList<BodyContact> m_registeredContacts;
+    QList<QAbstractPhysicsNode *> m_wokenNodes;
+    QList<QAbstractPhysicsNode *> m_sleptNodes;
+    QList<QPhysicsBodyPool *> m_bodyPools;
+    // PhysX objects that can only be released when the simulation is not running
+    QList<physx::PxBase *> m_pendingReleases;
 
     QVector3D m_gravity = QVector3D(0.f, -981.f, 0.f);
     float m_typicalLength = 100.f; // 100 cm
@@ -262,8 +406,36 @@ private:
     int m_numThreads = -1;
     bool m_reportKinematicKinematicCollisions = false;
     bool m_reportStaticKinematicCollisions = false;
+    bool m_directTransformUpdates = false;
+    // Number of cooking jobs started and finished by the current preparation phase
+    int m_preparationJobs = 0;
+    int m_finishedPreparationJobs = 0;
+    // Set when the simulation loop stopped to wait for the preparation to finish
+    bool m_waitingForPreparation = false;
+    // Set once the initial nodes have been added, later nodes do not stop the simulation
+    bool m_initialPreparationDone = false;
+    // Set from starting a simulation step until its results are synced in frameFinished()
+    bool m_simulating = false;
+    // Set when the simulation loop stopped to wait for other worlds to finish their step, so
+    // that the shared meshes and height fields can be changed
+    bool m_waitingForGeometryChanges = false;
+    // Set when shapes of the world use a mesh or height field that another world changed
+    bool m_shapeGeometriesChanged = false;
+    QCookingParameters *m_cookingParameters = nullptr;
+    bool m_batchDebugDraw = false;
+    DebugVisualizations m_debugVisualization = DebugVisualization::None;
+    // Set when the visualization parameters of the scene have to be set again
+    bool m_debugVisualizationDirty = false;
+    QQuick3DModel *m_debugVisualizationModel = nullptr;
+    QQuick3DGeometry *m_debugVisualizationGeometry = nullptr;
+    QQuick3DDefaultMaterial *m_debugVisualizationMaterial = nullptr;
+    QQuick3DCamera *m_debugDrawCamera = nullptr;
+    float m_debugDrawDistance = 0.f;
+    QPhysicsStatistics *m_statistics = nullptr;
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(QPhysicsWorld::DebugVisualizations)
+
 QT_END_NAMESPACE
 
 #endif // PHYSICSWORLD_H
@@ -0,0 +1,458 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "qtiledheightfield_p.h"
+
+#include <QImageReader>
+#include <QQmlContext>
+#include <QQmlFile>
+#include <QtMath>
+
+#include "qheightfieldshape_p.h"
+#include "qphysicsworld_p.h"
+#include "qstaticphysxobjects_p.h"
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \qmltype TiledHeightField
+    \inqmlmodule QtQuick3D.Physics
+    \inherits StaticRigidBody
+    \since 6.9
+    \brief A static body with a large height field terrain that is loaded in tiles.
+
+    The TiledHeightField type splits a terrain that is too large to keep in memory as a single
+    \l HeightFieldShape into a grid of tiles. Only the tiles within \l loadDistance of the
+    \l focusNode are loaded. Each tile is a height field that is cooked on a background thread
+    and added as a collision shape of the body when it is ready. Tiles that are further away
+    than \l loadDistance are released, with some margin so that a tile is not loaded and
+    released repeatedly while the focus node moves along its edge.
+
+    The tiles come either from parts of one large height map image set as the \l source, or from
+    separate image or cooked files given by \l tileSource. The terrain is centered on the body,
+    like a \l HeightFieldShape: The x-axis of the images is mapped to the positive x-axis of the
+    scene and the y-axis of the images to the positive z-axis.
+
+    The collision shapes of a TiledHeightField are managed by the type and should not be set.
+
+    \qml
+    TiledHeightField {
+        source: "terrain.png"
+        tileSize: 257
+        tileExtents: Qt.vector3d(1000, 200, 1000)
+        focusNode: camera
+        loadDistance: 2000
+    }
+    \endqml
+
+    \sa HeightFieldShape, {Qt Quick 3D Physics Shapes and Bodies}{Shapes and Bodies overview
+    documentation}
+*/
+
+/*!
+    \qmlproperty url TiledHeightField::source
+    This property holds the height map image that is split into tiles of \l tileSize samples.
+    Only the part of the image needed for a tile is kept in memory while the tile is cooked. Image
+    formats that cannot read parts of an image are decoded completely for each tile.
+
+    If both \l source and \l tileSource are set, \l source is used.
+*/
+
+/*!
+    \qmlproperty url TiledHeightField::tileSource
+    This property holds the location of the tile files. The \c{{x}} and \c{{y}} placeholders in
+    the url are replaced by the column and row of the tile, for example
+    \c{"tiles/terrain_{x}_{y}.png"}. The files can be height map images or height fields
+    \l{Qt Quick 3D Physics Cooking}{cooked} in advance. The number of tiles is set by
+    \l tileCount.
+
+    Neighboring tiles should have the same samples along their shared edge so that there is no
+    gap or step between them.
+*/
+
+/*!
+    \qmlproperty size TiledHeightField::tileCount
+    This property holds the number of tile columns and rows. It has to be set when using
+    \l tileSource. When using \l source, it is set from the size of the image and the
+    \l tileSize.
+*/
+
+/*!
+    \qmlproperty int TiledHeightField::tileSize
+    This property holds the number of samples along each side of a tile when splitting the
+    \l source image. Neighboring tiles share the samples along their edge, so a tile starts
+    \c{tileSize - 1} samples after the previous one. Tiles in the last column and row may be
+    smaller. The minimum value is \c 2.
+
+    Default value: \c 257
+*/
+
+/*!
+    \qmlproperty vector3d TiledHeightField::tileExtents
+    This property holds the size of one tile, with the y component giving the range of heights
+    like \l{HeightFieldShape::}{extents}. Smaller tiles in the last column and row of a split
+    \l source image keep the same distance between samples.
+
+    Default value: \c{(100, 100, 100)}
+*/
+
+/*!
+    \qmlproperty Node TiledHeightField::focusNode
+    This property holds the node around which tiles are loaded, typically the camera or the
+    player character. If it is \c null, all tiles are loaded.
+*/
+
+/*!
+    \qmlproperty real TiledHeightField::loadDistance
+    This property holds the distance in the xz plane from the \l focusNode, in the local
+    coordinates of the TiledHeightField, within which tiles are loaded. Tiles are released when
+    they are more than 1.25 times this distance away.
+
+    Default value: \c 1000
+*/
+
+/*!
+    \qmlproperty int TiledHeightField::loadedTileCount
+    \readonly
+    This property holds the number of tiles that have been loaded and added to the body.
+*/
+
+namespace {
+// Tiles are released a bit further away than they are loaded
+constexpr float releaseDistanceFactor = 1.25f;
+
+float distanceTo(const QRectF &rect, const QVector3D &point)
+{
+    const qreal dx = qMax(qMax(rect.left() - point.x(), 0.), point.x() - rect.right());
+    const qreal dz = qMax(qMax(rect.top() - point.z(), 0.), point.z() - rect.bottom());
+    return float(qSqrt(dx * dx + dz * dz));
+}
+}
+
+QTiledHeightField::QTiledHeightField() = default;
+
+QTiledHeightField::~QTiledHeightField() = default;
+
+void QTiledHeightField::componentComplete()
+{
+    QStaticRigidBody::componentComplete();
+    m_componentComplete = true;
+    updateLayout();
+    // Load the first tiles right away, so that they are added with the body
+    updateTiles();
+}
+
+const QUrl &QTiledHeightField::source() const
+{
+    return m_source;
+}
+
+void QTiledHeightField::setSource(const QUrl &newSource)
+{
+    if (m_source == newSource)
+        return;
+    m_source = newSource;
+    resetTiles();
+    emit sourceChanged();
+}
+
+const QUrl &QTiledHeightField::tileSource() const
+{
+    return m_tileSource;
+}
+
+void QTiledHeightField::setTileSource(const QUrl &newTileSource)
+{
+    if (m_tileSource == newTileSource)
+        return;
+    m_tileSource = newTileSource;
+    resetTiles();
+    emit tileSourceChanged();
+}
+
+QSize QTiledHeightField::tileCount() const
+{
+    if (m_source.isEmpty())
+        return m_tileCount;
+    if (m_imageSize.width() < 2 || m_imageSize.height() < 2)
+        return QSize();
+
+    // The last tile in each direction has at least two samples
+    const int step = m_tileSize - 1;
+    return QSize((m_imageSize.width() - 2) / step + 1, (m_imageSize.height() - 2) / step + 1);
+}
+
+void QTiledHeightField::setTileCount(const QSize &newTileCount)
+{
+    if (m_tileCount == newTileCount)
+        return;
+    const QSize oldTileCount = tileCount();
+    m_tileCount = newTileCount;
+    if (m_source.isEmpty())
+        resetTiles();
+    if (tileCount() != oldTileCount)
+        emit tileCountChanged();
+}
+
+int QTiledHeightField::tileSize() const
+{
+    return m_tileSize;
+}
+
+void QTiledHeightField::setTileSize(int newTileSize)
+{
+    newTileSize = qMax(2, newTileSize);
+    if (m_tileSize == newTileSize)
+        return;
+    m_tileSize = newTileSize;
+    resetTiles();
+    emit tileSizeChanged();
+}
+
+const QVector3D &QTiledHeightField::tileExtents() const
+{
+    return m_tileExtents;
+}
+
+void QTiledHeightField::setTileExtents(const QVector3D &newTileExtents)
+{
+    if (m_tileExtents == newTileExtents)
+        return;
+    m_tileExtents = newTileExtents;
+    resetTiles();
+    emit tileExtentsChanged();
+}
+
+QQuick3DNode *QTiledHeightField::focusNode() const
+{
+    return m_focusNode;
+}
+
+void QTiledHeightField::setFocusNode(QQuick3DNode *newFocusNode)
+{
+    if (m_focusNode == newFocusNode)
+        return;
+
+    if (m_focusNode)
+        m_focusNode->disconnect(this);
+
+    m_focusNode = newFocusNode;
+
+    if (m_focusNode) {
+        connect(m_focusNode, &QObject::destroyed, this, &QTiledHeightField::focusNodeDestroyed);
+        connect(m_focusNode, &QQuick3DNode::scenePositionChanged, this,
+                &QTiledHeightField::scheduleUpdate);
+    }
+
+    scheduleUpdate();
+    emit focusNodeChanged();
+}
+
+float QTiledHeightField::loadDistance() const
+{
+    return m_loadDistance;
+}
+
+void QTiledHeightField::setLoadDistance(float newLoadDistance)
+{
+    if (qFuzzyCompare(m_loadDistance, newLoadDistance))
+        return;
+    m_loadDistance = newLoadDistance;
+    scheduleUpdate();
+    emit loadDistanceChanged();
+}
+
+int QTiledHeightField::loadedTileCount() const
+{
+    return m_loadedTileCount;
+}
+
+void QTiledHeightField::focusNodeDestroyed(QObject *node)
+{
+    Q_ASSERT(m_focusNode == node);
+    setFocusNode(nullptr);
+}
+
+void QTiledHeightField::scheduleUpdate()
+{
+    if (!m_componentComplete || m_updatePending)
+        return;
+    m_updatePending = true;
+    QMetaObject::invokeMethod(this, &QTiledHeightField::updateTiles, Qt::QueuedConnection);
+}
+
+void QTiledHeightField::resetTiles()
+{
+    for (Tile &tile : m_tiles)
+        releaseTile(tile);
+    m_tiles.clear();
+
+    if (!m_componentComplete)
+        return;
+    updateLayout();
+    scheduleUpdate();
+}
+
+void QTiledHeightField::updateLayout()
+{
+    const QSize oldTileCount = tileCount();
+
+    m_imageSize = QSize();
+    if (!m_source.isEmpty()) {
+        const QQmlContext *context = qmlContext(this);
+        const QUrl resolvedUrl = context ? context->resolvedUrl(m_source) : m_source;
+        QImageReader reader(QQmlFile::urlToLocalFileOrQrc(resolvedUrl));
+        m_imageSize = reader.size();
+        if (!m_imageSize.isValid()) {
+            qWarning() << "TiledHeightField: could not read the size of" << m_source << ":"
+                       << reader.errorString();
+        }
+    }
+
+    if (tileCount() != oldTileCount)
+        emit tileCountChanged();
+}
+
+QSizeF QTiledHeightField::terrainSize() const
+{
+    const QSize count = tileCount();
+    if (m_source.isEmpty())
+        return QSizeF(count.width() * m_tileExtents.x(), count.height() * m_tileExtents.z());
+
+    // The samples of split images are the same distance apart in all tiles
+    const int step = m_tileSize - 1;
+    return QSizeF((m_imageSize.width() - 1) * m_tileExtents.x() / step,
+                  (m_imageSize.height() - 1) * m_tileExtents.z() / step);
+}
+
+QRectF QTiledHeightField::tileBounds(const QPoint &tile) const
+{
+    const QSizeF size = terrainSize();
+    const qreal left = tile.x() * m_tileExtents.x();
+    const qreal top = tile.y() * m_tileExtents.z();
+    return QRectF(left - size.width() / 2, top - size.height() / 2,
+                  qMin(qreal(m_tileExtents.x()), size.width() - left),
+                  qMin(qreal(m_tileExtents.z()), size.height() - top));
+}
+
+void QTiledHeightField::updateTiles()
+{
+    m_updatePending = false;
+
+    const QSize count = tileCount();
+    if (count.isEmpty() || m_tileExtents.x() <= 0 || m_tileExtents.z() <= 0)
+        return;
+
+    QRect range(QPoint(0, 0), count);
+    QVector3D focus;
+    if (m_focusNode) {
+        // Only the tiles in the square around the focus are candidates for loading
+        focus = mapPositionFromScene(m_focusNode->scenePosition());
+        const QSizeF size = terrainSize();
+        const float x = focus.x() + size.width() / 2;
+        const float z = focus.z() + size.height() / 2;
+        const QRect nearTiles(QPoint(qFloor((x - m_loadDistance) / m_tileExtents.x()),
+                                     qFloor((z - m_loadDistance) / m_tileExtents.z())),
+                              QPoint(qFloor((x + m_loadDistance) / m_tileExtents.x()),
+                                     qFloor((z + m_loadDistance) / m_tileExtents.z())));
+        range = range.intersected(nearTiles);
+
+        for (auto it = m_tiles.begin(); it != m_tiles.end();) {
+            if (distanceTo(tileBounds(it.key()), focus) > m_loadDistance * releaseDistanceFactor) {
+                releaseTile(it.value());
+                it = m_tiles.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    for (int row = range.top(); row <= range.bottom(); ++row) {
+        for (int column = range.left(); column <= range.right(); ++column) {
+            const QPoint tile(column, row);
+            if (m_tiles.contains(tile))
+                continue;
+            if (!m_focusNode || distanceTo(tileBounds(tile), focus) <= m_loadDistance)
+                loadTile(tile);
+        }
+    }
+}
+
+void QTiledHeightField::loadTile(const QPoint &tile)
+{
+    const QQmlContext *context = qmlContext(this);
+    const QRectF bounds = tileBounds(tile);
+
+    auto *shape = new QHeightFieldShape();
+    shape->setParent(this);
+    shape->setPosition(QVector3D(bounds.center().x(), 0, bounds.center().y()));
+    shape->setExtents(QVector3D(bounds.width(), m_tileExtents.y(), bounds.height()));
+
+    if (!m_source.isEmpty()) {
+        const int step = m_tileSize - 1;
+        const QPoint first(tile.x() * step, tile.y() * step);
+        shape->setSourceRect(QRect(first.x(), first.y(),
+                                   qMin(m_tileSize, m_imageSize.width() - first.x()),
+                                   qMin(m_tileSize, m_imageSize.height() - first.y())));
+        shape->setSource(context ? context->resolvedUrl(m_source) : m_source);
+    } else {
+        QString url = QUrl::fromPercentEncoding(m_tileSource.toString().toUtf8());
+        url.replace(QLatin1String("{x}"), QString::number(tile.x()));
+        url.replace(QLatin1String("{y}"), QString::number(tile.y()));
+        shape->setSource(context ? context->resolvedUrl(QUrl(url)) : QUrl(url));
+    }
+
+    Tile &entry = m_tiles[tile];
+    entry.shape = shape;
+    entry.serial = ++m_tileSerial;
+
+    // Until the first world has been initialized there is nothing to cook with, the world
+    // prepares the shapes of the body itself
+    if (StaticPhysXObjects::getReference().cooking == nullptr) {
+        addTileShape(entry);
+        return;
+    }
+
+    // The shape is only added when its height field is ready, so that the world does not have
+    // to wait for it
+    QFuture<QByteArray> cooking = shape->cookAsync();
+    if (!cooking.isValid()) {
+        addTileShape(entry);
+        return;
+    }
+
+    const quint64 serial = entry.serial;
+    cooking.then(this, [this, tile, serial](const QByteArray &data) {
+        auto it = m_tiles.find(tile);
+        if (it == m_tiles.end() || it->serial != serial)
+            return;
+        if (data.isEmpty()) {
+            qCWarning(lcQuick3dPhysics) << "TiledHeightField: could not load tile" << tile;
+            return;
+        }
+        addTileShape(*it);
+    });
+}
+
+void QTiledHeightField::addTileShape(Tile &tile)
+{
+    auto shapes = collisionShapes();
+    shapes.append(&shapes, tile.shape);
+    tile.added = true;
+    ++m_loadedTileCount;
+    emit loadedTileCountChanged();
+}
+
+void QTiledHeightField::releaseTile(Tile &tile)
+{
+    // The shape is removed from the collision shapes when it is destroyed
+    delete tile.shape;
+    tile.shape = nullptr;
+    if (tile.added) {
+        tile.added = false;
+        --m_loadedTileCount;
+        emit loadedTileCountChanged();
+    }
+}
+
+QT_END_NAMESPACE
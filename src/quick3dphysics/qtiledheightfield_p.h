@@ -0,0 +1,130 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#ifndef QTILEDHEIGHTFIELD_P_H
+#define QTILEDHEIGHTFIELD_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuick3DPhysics/qtquick3dphysicsglobal.h>
+#include <QtQuick3DPhysics/private/qstaticrigidbody_p.h>
+#include <QtCore/QHash>
+#include <QtCore/QPoint>
+#include <QtCore/QRect>
+#include <QtCore/QSize>
+#include <QtCore/QUrl>
+#include <QtGui/QVector3D>
+#include <QtQml/QQmlEngine>
+
+QT_BEGIN_NAMESPACE
+
+class QHeightFieldShape;
+
+class Q_QUICK3DPHYSICS_EXPORT QTiledHeightField : public QStaticRigidBody
+{
+    Q_OBJECT
+    Q_PROPERTY(QUrl source READ source WRITE setSource NOTIFY sourceChanged)
+    Q_PROPERTY(QUrl tileSource READ tileSource WRITE setTileSource NOTIFY tileSourceChanged)
+    Q_PROPERTY(QSize tileCount READ tileCount WRITE setTileCount NOTIFY tileCountChanged)
+    Q_PROPERTY(int tileSize READ tileSize WRITE setTileSize NOTIFY tileSizeChanged)
+    Q_PROPERTY(QVector3D tileExtents READ tileExtents WRITE setTileExtents NOTIFY
+                       tileExtentsChanged)
+    Q_PROPERTY(QQuick3DNode *focusNode READ focusNode WRITE setFocusNode NOTIFY focusNodeChanged)
+    Q_PROPERTY(float loadDistance READ loadDistance WRITE setLoadDistance NOTIFY
+                       loadDistanceChanged)
+    Q_PROPERTY(int loadedTileCount READ loadedTileCount NOTIFY loadedTileCountChanged)
+    QML_NAMED_ELEMENT(TiledHeightField)
+    QML_ADDED_IN_VERSION(6, 9)
+public:
+    QTiledHeightField();
+    ~QTiledHeightField();
+
+    const QUrl &source() const;
+    void setSource(const QUrl &newSource);
+
+    const QUrl &tileSource() const;
+    void setTileSource(const QUrl &newTileSource);
+
+    QSize tileCount() const;
+    void setTileCount(const QSize &newTileCount);
+
+    int tileSize() const;
+    void setTileSize(int newTileSize);
+
+    const QVector3D &tileExtents() const;
+    void setTileExtents(const QVector3D &newTileExtents);
+
+    QQuick3DNode *focusNode() const;
+    void setFocusNode(QQuick3DNode *newFocusNode);
+
+    float loadDistance() const;
+    void setLoadDistance(float newLoadDistance);
+
+    int loadedTileCount() const;
+
+signals:
+    void sourceChanged();
+    void tileSourceChanged();
+    void tileCountChanged();
+    void tileSizeChanged();
+    void tileExtentsChanged();
+    void focusNodeChanged();
+    void loadDistanceChanged();
+    void loadedTileCountChanged();
+
+protected:
+    void componentComplete() override;
+
+private slots:
+    void focusNodeDestroyed(QObject *node);
+
+private:
+    struct Tile
+    {
+        QHeightFieldShape *shape = nullptr;
+        // Identifies the tile while its height field is cooking
+        quint64 serial = 0;
+        bool added = false;
+    };
+
+    void scheduleUpdate();
+    void updateTiles();
+    void resetTiles();
+    void updateLayout();
+    void loadTile(const QPoint &tile);
+    void addTileShape(Tile &tile);
+    void releaseTile(Tile &tile);
+
+    // The area of the tile in the xz plane
+    QRectF tileBounds(const QPoint &tile) const;
+    QSizeF terrainSize() const;
+
+    QUrl m_source;
+    QUrl m_tileSource;
+    QSize m_tileCount;
+    int m_tileSize = 257;
+    QVector3D m_tileExtents = { 100, 100, 100 };
+    QQuick3DNode *m_focusNode = nullptr;
+    float m_loadDistance = 1000;
+
+    // Set from the source image, in samples
+    QSize m_imageSize;
+    QHash<QPoint, Tile> m_tiles;
+    quint64 m_tileSerial = 0;
+    int m_loadedTileCount = 0;
+    bool m_componentComplete = false;
+    bool m_updatePending = false;
+};
+
+QT_END_NAMESPACE
+
+#endif // QTILEDHEIGHTFIELD_P_H
@@ -44,6 +44,78 @@ QT_BEGIN_NAMESPACE
     \since 6.7
 */
 
+/*!
+    \qmlproperty bool TriangleMeshShape::asynchronous
+    \since 6.9
+
+    This property holds whether the mesh is cooked on a background thread. While the mesh is
+    cooking, the shape has no collision geometry unless
+    \l{TriangleMeshShape::}{boundingBoxPlaceholder} is set, and \l{TriangleMeshShape::}{ready} is \c false.
+    When cooking finishes, the shapes of the bodies using it are rebuilt.
+
+    Default value: \c false
+*/
+
+/*!
+    \qmlproperty bool TriangleMeshShape::boundingBoxPlaceholder
+    \since 6.9
+
+    This property holds whether a box with the size of the mesh bounds is used as the collision
+    geometry while the mesh is being cooked in the background. The box is centered on the shape.
+    Only used when \l{TriangleMeshShape::}{asynchronous} is \c true.
+
+    Default value: \c false
+*/
+
+/*!
+    \qmlproperty bool TriangleMeshShape::ready
+    \since 6.9
+    \readonly
+
+    This property holds whether the mesh geometry is available. It is \c false while the mesh is
+    being cooked in the background.
+*/
+
+/*!
+    \qmlproperty CookingParameters TriangleMeshShape::cookingParameters
+    \since 6.9
+
+    This property holds the parameters used when cooking the mesh of this shape. If it is not
+    set, the \l{PhysicsWorld::}{cookingParameters} of the physics world are used, and if
+    those are not set either, the default parameters.
+
+    Changing the parameters cooks the mesh again. Meshes loaded from
+    \l{Qt Quick 3D Physics Cooking}{precooked files} are used as they are.
+
+    Default value: \c null
+*/
+
+/*!
+    \qmlproperty bool TriangleMeshShape::refitGeometry
+    \since 6.9
+
+    This property holds whether changes to the vertex positions of the
+    \l{TriangleMeshShape::}{geometry} update the existing mesh instead of cooking it again.
+
+    When the geometry changes and its vertex count and index data are the same as before, the new
+    positions are copied into the cooked mesh and its bounding volume hierarchy is refitted. This is
+    much cheaper than cooking the mesh again, and the bodies using the shape keep their shapes.
+    The mesh is refitted before the next simulation step, and all bodies with shapes sharing the
+    geometry are updated, also in other physics worlds. Since the mesh is shared, it is refitted
+    when none of the worlds is simulating, so a world may wait for the step of another world to
+    finish first. Changes to the topology still cook the mesh again.
+
+    To keep the vertices of the cooked mesh in the same order as the vertices of the geometry, the
+    mesh is cooked without cleaning and welding and with the \c BVH33 mid-phase structure,
+    overriding the \l{TriangleMeshShape::}{cookingParameters}. Refitting does not reoptimize the
+    bounding volume hierarchy, so it is meant for meshes that deform, such as animated terrain,
+    rather than meshes that change their shape completely.
+
+    This property is only used with \l{TriangleMeshShape::}{geometry}.
+
+    Default value: \c false
+*/
+
 QMeshShape::MeshType QTriangleMeshShape::shapeType() const
 {
     return QMeshShape::MeshType::TRIANGLE;
@@ -54,4 +126,20 @@ bool QTriangleMeshShape::isStaticShape() const
     return true;
 }
 
+bool QTriangleMeshShape::refitGeometry() const
+{
+    return m_refitGeometry;
+}
+
+void QTriangleMeshShape::setRefitGeometry(bool newRefitGeometry)
+{
+    if (m_refitGeometry == newRefitGeometry)
+        return;
+    m_refitGeometry = newRefitGeometry;
+
+    // The mesh is cooked with different settings for refitting
+    updateCookingSettings();
+    emit refitGeometryChanged();
+}
+
 QT_END_NAMESPACE
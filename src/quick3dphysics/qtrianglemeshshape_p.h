@@ -22,9 +22,18 @@ QT_BEGIN_NAMESPACE
 class Q_QUICK3DPHYSICS_EXPORT QTriangleMeshShape : public QMeshShape
 {
     Q_OBJECT
+    Q_PROPERTY(bool refitGeometry READ refitGeometry WRITE setRefitGeometry NOTIFY
+                       refitGeometryChanged REVISION(6, 9))
     QML_NAMED_ELEMENT(TriangleMeshShape)
+public:
     virtual QMeshShape::MeshType shapeType() const override;
     virtual bool isStaticShape() const override;
+
+    Q_REVISION(6, 9) bool refitGeometry() const;
+    Q_REVISION(6, 9) void setRefitGeometry(bool newRefitGeometry);
+
+signals:
+    Q_REVISION(6, 9) void refitGeometryChanged();
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,177 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+import QtQuick
+import QtTest
+import QtQuick3D
+import QtQuick3D.Physics
+import QtQuick3D.Physics.Helpers
+
+Item {
+    width: 640
+    height: 480
+    visible: true
+
+    PhysicsWorld {
+        id: physicsWorld
+        scene: viewport.scene
+        forceDebugDraw: true
+    }
+
+    View3D {
+        id: viewport
+        anchors.fill: parent
+
+        PerspectiveCamera {
+            position: Qt.vector3d(0, 200, 500)
+            clipFar: 5000
+            clipNear: 1
+        }
+
+        DirectionalLight {
+            eulerRotation.x: -45
+            eulerRotation.y: 45
+        }
+
+        StaticRigidBody {
+            position: Qt.vector3d(0, -100, 0)
+            eulerRotation: Qt.vector3d(-90, 0, 0)
+            collisionShapes: PlaneShape {}
+        }
+
+        DynamicRigidBody {
+            id: placeholderCapsule
+            property bool hit: false
+            onBodyContact: () => {
+                placeholderCapsule.hit = true
+            }
+            receiveContactReports: true
+            position: Qt.vector3d(-100, 300, 0)
+            collisionShapes: ConvexMeshShape {
+                id: placeholderShape
+                asynchronous: true
+                boundingBoxPlaceholder: true
+                geometry: CapsuleGeometry {}
+            }
+        }
+
+        DynamicRigidBody {
+            id: capsule
+            property bool hit: false
+            onBodyContact: () => {
+                capsule.hit = true
+            }
+            receiveContactReports: true
+            position: Qt.vector3d(100, 300, 0)
+            collisionShapes: ConvexMeshShape {
+                id: shape
+                asynchronous: true
+                geometry: CapsuleGeometry {}
+            }
+        }
+
+        DynamicRigidBody {
+            id: preparedCapsule
+            property bool hit: false
+            onBodyContact: () => {
+                preparedCapsule.hit = true
+            }
+            receiveContactReports: true
+            position: Qt.vector3d(0, 300, 0)
+            collisionShapes: ConvexMeshShape {
+                geometry: CapsuleGeometry {}
+            }
+        }
+
+        DynamicRigidBody {
+            id: mover
+            gravityEnabled: false
+            position: Qt.vector3d(0, 300, -1000)
+            collisionShapes: BoxShape {}
+        }
+
+        Node {
+            id: spawner
+        }
+    }
+
+    Component {
+        id: spawnComponent
+        DynamicRigidBody {
+            property bool hit: false
+            onBodyContact: () => {
+                hit = true
+            }
+            receiveContactReports: true
+            position: Qt.vector3d(0, 300, 200)
+            collisionShapes: ConvexMeshShape {
+                geometry: CapsuleGeometry {
+                    longitudes: 128
+                    latitudes: 128
+                    rings: 64
+                }
+            }
+        }
+    }
+
+    SignalSpy {
+        id: preparingSpy
+        target: physicsWorld
+        signalName: "preparingChanged"
+    }
+
+    SignalSpy {
+        id: frameSpy
+        target: physicsWorld
+        signalName: "frameDone"
+    }
+
+    TestCase {
+        name: "prepared capsule hit"
+        when: preparedCapsule.hit
+        function test_prepared() {
+            verify(!physicsWorld.preparing)
+            compare(physicsWorld.preparationProgress, 1)
+        }
+    }
+
+    TestCase {
+        name: "placeholder hit"
+        when: placeholderCapsule.hit
+        function test_ready() {
+            tryVerify(() => placeholderShape.ready)
+        }
+    }
+
+    TestCase {
+        name: "capsule hit"
+        when: capsule.hit
+        function test_ready() {
+            verify(shape.ready)
+        }
+    }
+
+    TestCase {
+        name: "runtime spawn"
+        when: preparedCapsule.hit
+        function test_spawn() {
+            mover.setLinearVelocity(Qt.vector3d(100, 0, 0))
+            tryVerify(() => mover.position.x > 1)
+
+            preparingSpy.clear()
+            let spawned = spawnComponent.createObject(spawner)
+            verify(spawned)
+
+            // The existing bodies keep moving while the new body is being cooked
+            let x = mover.position.x
+            frameSpy.clear()
+            tryVerify(() => frameSpy.count >= 2)
+            verify(mover.position.x > x)
+            verify(!physicsWorld.preparing)
+
+            tryVerify(() => spawned.hit, 10000)
+            compare(preparingSpy.count, 0)
+            verify(mover.position.x > x)
+        }
+    }
+}
@@ -0,0 +1,114 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QTemporaryDir>
+#include <QtQuick3DPhysics/private/qcacheutils_p.h>
+
+// Tests that a cache index prepared in advance, in the format written by the cooker, is used in
+// trusted mode without looking at the source files
+
+class tst_cache_index : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void keys();
+    void trustedIndex();
+    void unindexedSource();
+    void indexNotWritten();
+    void writtenFormat();
+
+private:
+    QTemporaryDir m_cacheDir;
+    QString m_root;
+    QByteArray m_index;
+};
+
+void tst_cache_index::initTestCase()
+{
+    QVERIFY(m_cacheDir.isValid());
+    const QString indexPath = QFINDTESTDATA("data/index.json");
+    QVERIFY(!indexPath.isEmpty());
+    m_root = QFileInfo(indexPath).absolutePath();
+
+    QFile indexFile(indexPath);
+    QVERIFY(indexFile.open(QIODevice::ReadOnly));
+    m_index = indexFile.readAll();
+    QFile cachedIndexFile(m_cacheDir.filePath(QStringLiteral("index.json")));
+    QVERIFY(cachedIndexFile.open(QIODevice::WriteOnly));
+    QCOMPARE(cachedIndexFile.write(m_index), m_index.size());
+    cachedIndexFile.close();
+
+    // The environment is read when the cache is first used
+    qputenv("QT_PHYSICS_CACHE_PATH", QFile::encodeName(m_cacheDir.path()));
+    qputenv("QT_PHYSICS_CACHE_TRUSTED", "1");
+    qputenv("QT_PHYSICS_CACHE_ROOT", QFile::encodeName(m_root));
+}
+
+void tst_cache_index::keys()
+{
+    const QString sourcePath = m_root + QStringLiteral("/assets/tetrahedron.mesh");
+    QCOMPARE(QCacheUtils::cacheIndexKey(sourcePath, m_root),
+             QStringLiteral("assets/tetrahedron.mesh"));
+    QCOMPARE(QCacheUtils::cacheIndexKey(QStringLiteral(":/assets/../meshes/cup.mesh"), m_root),
+             QStringLiteral(":/meshes/cup.mesh"));
+
+    // Files outside of the root are not keyed by a relative path
+    const QString outside = QFileInfo(m_root + QStringLiteral("/../cup.mesh")).absoluteFilePath();
+    QCOMPARE(QCacheUtils::cacheIndexKey(outside, m_root), outside);
+}
+
+void tst_cache_index::trustedIndex()
+{
+    // The recorded hash is used although the size and time of the file do not match the entry
+    const QString sourcePath = m_root + QStringLiteral("/assets/tetrahedron.mesh");
+    QVERIFY(QFile::exists(sourcePath));
+    QCOMPARE(QCacheUtils::sourceHash(sourcePath), QByteArray(32, char(0xcc)));
+
+    // The source files are not needed at all
+    QCOMPARE(QCacheUtils::sourceHash(m_root + QStringLiteral("/assets/missing.mesh")),
+             QByteArray(32, char(0xaa)));
+    QCOMPARE(QCacheUtils::sourceHash(QStringLiteral(":/assets/resource.mesh")),
+             QByteArray(32, char(0xbb)));
+}
+
+void tst_cache_index::unindexedSource()
+{
+    // Files without an entry are still hashed
+    const QString sourcePath = m_root + QStringLiteral("/index.json");
+    QCOMPARE(QCacheUtils::sourceHash(sourcePath),
+             QCryptographicHash::hash(m_index, QCryptographicHash::Sha256));
+}
+
+void tst_cache_index::indexNotWritten()
+{
+    QCacheUtils::saveCacheIndex();
+    QFile indexFile(m_cacheDir.filePath(QStringLiteral("index.json")));
+    QVERIFY(indexFile.open(QIODevice::ReadOnly));
+    QCOMPARE(indexFile.readAll(), m_index);
+}
+
+void tst_cache_index::writtenFormat()
+{
+    // The cooker writes its index with the same function, it has to match the prepared file
+    QHash<QString, QCacheUtils::CacheIndexEntry> index;
+    index.insert(QStringLiteral(":/assets/resource.mesh"),
+                 { 2008, 1735689600000, QByteArray(32, char(0xbb)) });
+    index.insert(QStringLiteral("assets/missing.mesh"),
+                 { 2008, 1735689600000, QByteArray(32, char(0xaa)) });
+    index.insert(QStringLiteral("assets/tetrahedron.mesh"),
+                 { 2008, 1735689600000, QByteArray(32, char(0xcc)) });
+
+    const QString indexPath = m_cacheDir.filePath(QStringLiteral("written.json"));
+    QVERIFY(QCacheUtils::writeCacheIndex(indexPath, index));
+    QFile indexFile(indexPath);
+    QVERIFY(indexFile.open(QIODevice::ReadOnly));
+    QCOMPARE(QJsonDocument::fromJson(indexFile.readAll()), QJsonDocument::fromJson(m_index));
+}
+
+QTEST_GUILESS_MAIN(tst_cache_index)
+#include "tst_cache_index.moc"
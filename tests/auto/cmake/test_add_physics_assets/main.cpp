@@ -0,0 +1,43 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtCore/QFile>
+#include <QtCore/QStringList>
+
+#include <iostream>
+
+// Checks that the cooked assets were added to the resources with their expected paths
+int main()
+{
+    const QStringList expected = {
+        QStringLiteral(":/assets/meshes/tetrahedron.cooked.tri"),
+        QStringLiteral(":/assets/meshes/tetrahedron.cooked.cvx"),
+        QStringLiteral(":/assets/heightmaps/hf.cooked.hf"),
+        QStringLiteral(":/triangles/tetrahedron.cooked.tri"),
+    };
+    const QStringList unexpected = {
+        QStringLiteral(":/triangles/tetrahedron.cooked.cvx"),
+    };
+
+    int result = 0;
+    for (const QString &path : expected) {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly) || file.size() == 0) {
+            std::cerr << "Missing cooked asset " << qPrintable(path) << std::endl;
+            result = 1;
+            continue;
+        }
+        // Cooked streams start with the PhysX stream identifier
+        if (file.peek(3) != "NXS") {
+            std::cerr << "Invalid cooked asset " << qPrintable(path) << std::endl;
+            result = 1;
+        }
+    }
+    for (const QString &path : unexpected) {
+        if (QFile::exists(path)) {
+            std::cerr << "Unexpected cooked asset " << qPrintable(path) << std::endl;
+            result = 1;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,98 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+import QtQuick
+import QtTest
+import QtQuick3D
+import QtQuick3D.Physics
+import QtQuick3D.Physics.Helpers
+
+Item {
+    width: 640
+    height: 480
+    visible: true
+
+    PhysicsWorld {
+        id: physicsWorld
+        scene: viewport.scene
+        cookingParameters: CookingParameters {
+            meshCookingHint: CookingParameters.CookingPerformance
+            precomputeActiveEdges: false
+        }
+    }
+
+    CookingParameters {
+        id: convexParameters
+        convexVertexLimit: 16
+    }
+
+    View3D {
+        id: viewport
+        anchors.fill: parent
+
+        PerspectiveCamera {
+            position: Qt.vector3d(0, 200, 500)
+            clipFar: 5000
+            clipNear: 1
+        }
+
+        StaticRigidBody {
+            position: Qt.vector3d(0, -100, 0)
+            scale: Qt.vector3d(5, 1, 5)
+            eulerRotation.z: 90
+            collisionShapes: TriangleMeshShape {
+                id: floorShape
+                geometry: CapsuleGeometry {}
+            }
+        }
+
+        DynamicRigidBody {
+            id: capsule
+            property bool hit: false
+            onBodyContact: () => {
+                capsule.hit = true
+            }
+            receiveContactReports: true
+            position: Qt.vector3d(0, 300, 0)
+            collisionShapes: ConvexMeshShape {
+                id: capsuleShape
+                cookingParameters: convexParameters
+                geometry: CapsuleGeometry {}
+            }
+        }
+    }
+
+    TestCase {
+        name: "defaults"
+        function test_defaults() {
+            let parameters = Qt.createQmlObject("import QtQuick3D.Physics; CookingParameters {}",
+                                                physicsWorld)
+            compare(parameters.midPhase, CookingParameters.BVH33)
+            compare(parameters.meshCookingHint, CookingParameters.SimulationPerformance)
+            fuzzyCompare(parameters.meshSizePerformanceTradeOff, 0.55, 0.0001)
+            compare(parameters.primitivesPerLeaf, 4)
+            verify(parameters.precomputeActiveEdges)
+            verify(parameters.cleanMesh)
+            compare(parameters.weldTolerance, 0)
+            verify(!parameters.buildGPUData)
+            compare(parameters.convexVertexLimit, 255)
+            compare(parameters.convexQuantizedCount, 0)
+
+            parameters.convexVertexLimit = 1000
+            compare(parameters.convexVertexLimit, 255)
+            parameters.primitivesPerLeaf = 1
+            compare(parameters.primitivesPerLeaf, 4)
+            parameters.destroy()
+        }
+    }
+
+    TestCase {
+        name: "capsule hit"
+        when: capsule.hit
+        function test_hit() {
+            verify(floorShape.ready)
+            verify(capsuleShape.ready)
+            compare(capsuleShape.cookingParameters, convexParameters)
+        }
+    }
+}
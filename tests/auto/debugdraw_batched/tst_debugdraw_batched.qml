@@ -0,0 +1,135 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+import QtQuick
+import QtTest
+import QtQuick3D
+import QtQuick3D.Physics
+import DebugDrawInspector
+
+// Test that batched debug drawing creates one model per debug color holding the vertices of all
+// shapes with that color, and that it can be switched on and off
+
+Item {
+    width: 640
+    height: 480
+    visible: true
+
+    PhysicsWorld {
+        id: world
+        scene: viewport.scene
+        forceDebugDraw: true
+        batchDebugDraw: true
+        viewport: debugRoot
+    }
+
+    View3D {
+        id: viewport
+        anchors.fill: parent
+
+        PerspectiveCamera {
+            position: Qt.vector3d(0, 200, 800)
+            clipFar: 5000
+            clipNear: 1
+        }
+
+        DirectionalLight {
+            eulerRotation.x: -45
+            eulerRotation.y: 45
+        }
+
+        Node {
+            id: debugRoot
+        }
+
+        DynamicRigidBody {
+            id: box
+            property bool hit: false
+            onBodyContact: () => {
+                hit = true
+            }
+            receiveContactReports: true
+
+            position: Qt.vector3d(0, 600, 0)
+            collisionShapes: [
+                BoxShape {},
+                SphereShape {
+                    position: Qt.vector3d(0, 100, 0)
+                }
+            ]
+            Model {
+                source: "#Cube"
+                materials: PrincipledMaterial {
+                    baseColor: "yellow"
+                }
+            }
+        }
+
+        StaticRigidBody {
+            position: Qt.vector3d(-300, 0, 0)
+            collisionShapes: [
+                BoxShape {},
+                CapsuleShape {
+                    position: Qt.vector3d(0, 100, 0)
+                }
+            ]
+        }
+
+        TriggerBody {
+            position: Qt.vector3d(300, 0, 0)
+            collisionShapes: SphereShape {}
+        }
+
+        StaticRigidBody {
+            position: Qt.vector3d(0, -100, 0)
+            eulerRotation: Qt.vector3d(-90, 0, 0)
+            collisionShapes: PlaneShape {}
+            sendContactReports: true
+        }
+    }
+
+    SignalSpy {
+        id: frameSpy
+        target: world
+        signalName: "frameDone"
+    }
+
+    TestCase {
+        name: "batched"
+        when: box.hit
+        function test_batched() {
+            verify(box.position.y < 100)
+            // The color of a dynamic body changes when it falls asleep
+            tryVerify(() => box.isSleeping, 10000)
+
+            world.batchDebugDraw = false
+            frameSpy.clear()
+            tryVerify(() => frameSpy.count >= 2)
+
+            // One model for each of the six shapes
+            const shapeModels = DebugDrawInspector.models(debugRoot)
+            compare(shapeModels.length, 6)
+            let colorVertices = {}
+            for (const model of shapeModels) {
+                const color = DebugDrawInspector.color(model).toString()
+                colorVertices[color] = (colorVertices[color] ?? 0)
+                        + DebugDrawInspector.vertexCount(model)
+            }
+            // Static, sleeping and trigger bodies
+            compare(Object.keys(colorVertices).length, 3)
+
+            world.batchDebugDraw = true
+            frameSpy.clear()
+            tryVerify(() => frameSpy.count >= 2)
+
+            // One model per used color with the vertices of all its shapes, and no other models
+            const batchModels = DebugDrawInspector.models(debugRoot)
+            compare(batchModels.length, 3)
+            compare(DebugDrawInspector.visibleModels(debugRoot).length, 3)
+            for (const model of batchModels) {
+                const color = DebugDrawInspector.color(model).toString()
+                verify(color in colorVertices)
+                compare(DebugDrawInspector.vertexCount(model), colorVertices[color])
+            }
+        }
+    }
+}
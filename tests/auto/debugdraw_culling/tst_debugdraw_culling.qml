@@ -0,0 +1,152 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+import QtQuick
+import QtTest
+import QtQuick3D
+import QtQuick3D.Physics
+import DebugDrawInspector
+
+// Test that only the debug models of bodies in view of the camera and within the distance are
+// shown, both for individual and batched debug drawing
+
+Item {
+    width: 640
+    height: 480
+    visible: true
+
+    PhysicsWorld {
+        id: world
+        scene: viewport.scene
+        forceDebugDraw: true
+        debugDrawCamera: camera
+        debugDrawDistance: 2000
+        viewport: debugRoot
+    }
+
+    View3D {
+        id: viewport
+        anchors.fill: parent
+        camera: camera
+
+        PerspectiveCamera {
+            id: camera
+            position: Qt.vector3d(0, 200, 800)
+            clipFar: 5000
+            clipNear: 1
+        }
+
+        DirectionalLight {
+            eulerRotation.x: -45
+            eulerRotation.y: 45
+        }
+
+        Node {
+            id: debugRoot
+        }
+
+        DynamicRigidBody {
+            id: box
+            property bool hit: false
+            onBodyContact: () => {
+                hit = true
+            }
+            receiveContactReports: true
+
+            position: Qt.vector3d(0, 600, 0)
+            collisionShapes: BoxShape {}
+        }
+
+        // Behind the camera
+        StaticRigidBody {
+            position: Qt.vector3d(0, 0, 1500)
+            collisionShapes: BoxShape {}
+        }
+
+        // Too far away
+        StaticRigidBody {
+            position: Qt.vector3d(0, 0, -3000)
+            collisionShapes: SphereShape {}
+        }
+
+        StaticRigidBody {
+            position: Qt.vector3d(0, -100, 0)
+            eulerRotation: Qt.vector3d(-90, 0, 0)
+            collisionShapes: PlaneShape {}
+            sendContactReports: true
+        }
+    }
+
+    SignalSpy {
+        id: frameSpy
+        target: world
+        signalName: "frameDone"
+    }
+
+    TestCase {
+        name: "culling"
+        when: box.hit
+
+        // True if a debug model around the depth z is shown
+        function isShownAt(z) {
+            return DebugDrawInspector.visibleModels(debugRoot).some(
+                    model => Math.abs(model.position.z - z) < 50)
+        }
+
+        function batchVertexCount() {
+            let count = 0
+            for (const model of DebugDrawInspector.visibleModels(debugRoot))
+                count += DebugDrawInspector.vertexCount(model)
+            return count
+        }
+
+        function waitFrames() {
+            frameSpy.clear()
+            tryVerify(() => frameSpy.count >= 2)
+        }
+
+        function test_culling() {
+            verify(box.position.y < 100)
+
+            // The box and the plane are shown, the body behind the camera and the one too far
+            // away have no models
+            tryCompare(DebugDrawInspector.visibleModels(debugRoot), "length", 2)
+            verify(isShownAt(0))
+            verify(!isShownAt(1500))
+            verify(!isShownAt(-3000))
+            compare(DebugDrawInspector.models(debugRoot).length, 2)
+
+            // Turn around so the body behind comes into view and the box goes out of it. The
+            // model of the box is kept but hidden.
+            camera.eulerRotation.y = 180
+            tryVerify(() => isShownAt(1500))
+            verify(!isShownAt(0))
+            compare(DebugDrawInspector.visibleModels(debugRoot).length, 2)
+            compare(DebugDrawInspector.models(debugRoot).length, 3)
+
+            // A larger distance brings the far body into view
+            camera.eulerRotation.y = 0
+            world.debugDrawDistance = 5000
+            tryVerify(() => isShownAt(-3000))
+            verify(isShownAt(0))
+            verify(!isShownAt(1500))
+            compare(DebugDrawInspector.visibleModels(debugRoot).length, 3)
+        }
+
+        function test_culling_batched() {
+            world.batchDebugDraw = true
+            world.debugDrawDistance = 2000
+            waitFrames()
+            const nearVertices = batchVertexCount()
+            verify(nearVertices > 0)
+
+            // The batches only hold the vertices of the shapes in view
+            world.debugDrawDistance = 5000
+            tryVerify(() => batchVertexCount() > nearVertices)
+            const farVertices = batchVertexCount()
+
+            // Without a camera nothing is culled
+            world.debugDrawCamera = null
+            tryVerify(() => batchVertexCount() > farVertices)
+        }
+    }
+}
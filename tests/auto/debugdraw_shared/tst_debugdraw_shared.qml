@@ -0,0 +1,125 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+import QtQuick
+import QtTest
+import QtQuick3D
+import QtQuick3D.Physics
+import DebugDrawInspector
+
+// Test that bodies sharing the same mesh or height field are drawn from one debug geometry, and
+// that the shared geometry is generated again when the height field is changed in place
+
+Item {
+    width: 640
+    height: 480
+    visible: true
+
+    PhysicsWorld {
+        id: world
+        scene: viewport.scene
+        forceDebugDraw: true
+        viewport: debugRoot
+    }
+
+    View3D {
+        id: viewport
+        anchors.fill: parent
+
+        PerspectiveCamera {
+            position: Qt.vector3d(0, 200, 800)
+            clipFar: 5000
+            clipNear: 1
+        }
+
+        DirectionalLight {
+            eulerRotation.x: -45
+            eulerRotation.y: 45
+        }
+
+        Node {
+            id: debugRoot
+        }
+
+        Repeater3D {
+            id: bodies
+            model: 5
+            DynamicRigidBody {
+                property bool hit: false
+                onBodyContact: () => {
+                    hit = true
+                }
+                receiveContactReports: true
+
+                position: Qt.vector3d(-200 + index * 100, 300, 0)
+                scale: Qt.vector3d(20, 20, 20)
+                collisionShapes: ConvexMeshShape {
+                    source: "qrc:/data/tetrahedron.mesh"
+                }
+            }
+        }
+
+        StaticRigidBody {
+            position: Qt.vector3d(0, 0, 0)
+            collisionShapes: HeightFieldShape {
+                id: heightField
+                source: "qrc:/data/flat.png"
+                extents: "400, 200, 400"
+            }
+            sendContactReports: true
+        }
+
+        StaticRigidBody {
+            position: Qt.vector3d(0, 0, -400)
+            collisionShapes: HeightFieldShape {
+                source: "qrc:/data/flat.png"
+                extents: "400, 200, 400"
+            }
+        }
+    }
+
+    function allHit() {
+        for (let i = 0; i < bodies.count; i++) {
+            if (!bodies.objectAt(i).hit)
+                return false
+        }
+        return true
+    }
+
+    // The debug models sharing their geometry with count models in total
+    function modelsSharing(count) {
+        const models = DebugDrawInspector.models(debugRoot)
+        for (const model of models) {
+            const sharing = models.filter(other => other.geometry === model.geometry)
+            if (sharing.length === count)
+                return sharing
+        }
+        return []
+    }
+
+    TestCase {
+        name: "shared"
+        when: allHit()
+        function test_shared() {
+            for (let i = 0; i < bodies.count; i++)
+                verify(bodies.objectAt(i).position.y < 0)
+
+            // One model per body, but only one geometry for the mesh and one for the height field
+            compare(DebugDrawInspector.models(debugRoot).length, 7)
+            compare(DebugDrawInspector.geometryCount(debugRoot), 2)
+            compare(modelsSharing(5).length, 5)
+            const heightFieldModels = modelsSharing(2)
+            compare(heightFieldModels.length, 2)
+            const flatHeight = DebugDrawInspector.boundsMax(heightFieldModels[0]).y
+
+            // The geometry of both height fields is generated again with the raised corner
+            verify(heightField.modifySamples(Qt.rect(0, 0, 2, 2), [0.5, 0.5, 0.5, 0.5]))
+            tryVerify(() => {
+                const models = modelsSharing(2)
+                return models.length === 2
+                        && DebugDrawInspector.boundsMax(models[0]).y > flatHeight
+            })
+            compare(DebugDrawInspector.models(debugRoot).length, 7)
+            compare(DebugDrawInspector.geometryCount(debugRoot), 2)
+        }
+    }
+}
@@ -0,0 +1,93 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+import QtQuick
+import QtTest
+import QtQuick3D
+import QtQuick3D.Physics
+import DebugDrawInspector
+
+// Test that the debug visualization of the physics engine is drawn into a model whose geometry
+// follows the enabled visualizations, and that the model is removed when it is switched off
+
+Item {
+    width: 640
+    height: 480
+    visible: true
+
+    PhysicsWorld {
+        id: world
+        scene: viewport.scene
+        debugVisualization: PhysicsWorld.CollisionShapes
+        viewport: debugRoot
+    }
+
+    View3D {
+        id: viewport
+        anchors.fill: parent
+
+        PerspectiveCamera {
+            position: Qt.vector3d(0, 200, 800)
+            clipFar: 5000
+            clipNear: 1
+        }
+
+        DirectionalLight {
+            eulerRotation.x: -45
+            eulerRotation.y: 45
+        }
+
+        Node {
+            id: debugRoot
+        }
+
+        DynamicRigidBody {
+            id: box
+            property bool hit: false
+            onBodyContact: () => {
+                hit = true
+            }
+            receiveContactReports: true
+
+            position: Qt.vector3d(0, 600, 0)
+            collisionShapes: BoxShape {}
+            Model {
+                source: "#Cube"
+                materials: PrincipledMaterial {
+                    baseColor: "yellow"
+                }
+            }
+        }
+
+        StaticRigidBody {
+            position: Qt.vector3d(0, -100, 0)
+            eulerRotation: Qt.vector3d(-90, 0, 0)
+            collisionShapes: PlaneShape {}
+            sendContactReports: true
+        }
+    }
+
+    TestCase {
+        name: "visualization"
+        when: box.hit
+        function test_visualization() {
+            // Only the render buffer of the engine is drawn, there is no collision debug drawing
+            tryVerify(() => DebugDrawInspector.visibleModels(debugRoot).length === 1)
+            compare(DebugDrawInspector.models(debugRoot).length, 1)
+            const shapeVertices =
+                    DebugDrawInspector.vertexCount(DebugDrawInspector.models(debugRoot)[0])
+            verify(shapeVertices > 0)
+
+            // The bounding boxes and axes add lines to the same model
+            world.debugVisualization = PhysicsWorld.CollisionShapes | PhysicsWorld.BoundingBoxes
+                    | PhysicsWorld.BodyAxes
+            tryVerify(() => {
+                const models = DebugDrawInspector.models(debugRoot)
+                return models.length === 1
+                        && DebugDrawInspector.vertexCount(models[0]) > shapeVertices
+            })
+
+            world.debugVisualization = PhysicsWorld.None
+            tryVerify(() => DebugDrawInspector.models(debugRoot).length === 0)
+        }
+    }
+}
@@ -0,0 +1,116 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+import QtQuick
+import QtTest
+import QtQuick3D
+import QtQuick3D.Physics
+
+// Test that the transforms of simulated bodies are updated and that the change handlers still fire
+// when the transforms are written directly into the nodes
+
+Item {
+    width: 640
+    height: 480
+    visible: true
+
+    PhysicsWorld {
+        id: world
+        scene: viewport.scene
+        directTransformUpdates: true
+    }
+
+    View3D {
+        id: viewport
+        anchors.fill: parent
+
+        PerspectiveCamera {
+            position: Qt.vector3d(0, 200, 800)
+            clipFar: 5000
+            clipNear: 1
+        }
+
+        DirectionalLight {
+            eulerRotation.x: -45
+            eulerRotation.y: 45
+        }
+
+        // A body with handlers on its transform
+        DynamicRigidBody {
+            id: watched
+            property int positionChanges: 0
+            property int rotationChanges: 0
+            // The transform of the other body when the handler ran
+            property real unwatchedY: 0
+            onPositionChanged: {
+                positionChanges++
+                unwatchedY = unwatched.y
+            }
+            onRotationChanged: rotationChanges++
+
+            position: Qt.vector3d(-200, 600, 0)
+            Component.onCompleted: setAngularVelocity(Qt.vector3d(0, 90, 0))
+            collisionShapes: BoxShape {}
+            Model {
+                source: "#Cube"
+                materials: PrincipledMaterial {
+                    baseColor: "yellow"
+                }
+            }
+        }
+
+        // Follows the body through a binding on its position
+        Node {
+            id: follower
+            position: watched.position
+        }
+
+        // A body nothing is connected to
+        DynamicRigidBody {
+            id: unwatched
+            position: Qt.vector3d(200, 600, 0)
+            Component.onCompleted: setAngularVelocity(Qt.vector3d(0, 90, 0))
+            collisionShapes: BoxShape {}
+            Model {
+                source: "#Cube"
+                materials: PrincipledMaterial {
+                    baseColor: "red"
+                }
+            }
+        }
+
+        StaticRigidBody {
+            position: Qt.vector3d(0, -100, 0)
+            eulerRotation: Qt.vector3d(-90, 0, 0)
+            collisionShapes: PlaneShape {}
+        }
+    }
+
+    TestCase {
+        name: "direct_transform_updates"
+        when: world.running
+
+        function test_watched() {
+            tryVerify(() => watched.y < 300)
+            verify(watched.positionChanges > 0)
+            verify(watched.rotationChanges > 0)
+            verify(!watched.rotation.fuzzyEquals(Qt.quaternion(1, 0, 0, 0)))
+            compare(follower.position, watched.position)
+
+            // All transforms are written before the handlers run
+            verify(unwatched.y < 600)
+            compare(watched.unwatchedY, unwatched.y)
+
+            // The handlers keep firing while the body moves
+            const positionChanges = watched.positionChanges
+            const rotationChanges = watched.rotationChanges
+            tryVerify(() => watched.positionChanges > positionChanges)
+            tryVerify(() => watched.rotationChanges > rotationChanges)
+        }
+
+        function test_unwatched() {
+            tryVerify(() => unwatched.y < 300)
+            verify(!unwatched.rotation.fuzzyEquals(Qt.quaternion(1, 0, 0, 0)))
+            verify(unwatched.scenePosition.y < 300)
+        }
+    }
+}
@@ -0,0 +1,43 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "quadgeometry.h"
+#include <QtGui/QVector3D>
+
+QuadGeometry::QuadGeometry()
+{
+    updateData();
+}
+
+float QuadGeometry::height() const
+{
+    return m_height;
+}
+
+void QuadGeometry::setHeight(float height)
+{
+    if (qFuzzyCompare(m_height, height))
+        return;
+    m_height = height;
+    updateData();
+    emit heightChanged();
+}
+
+void QuadGeometry::updateData()
+{
+    const QVector3D vertices[] = { QVector3D(-200, m_height, -200), QVector3D(-200, m_height, 200),
+                                   QVector3D(200, m_height, 200), QVector3D(200, m_height, -200) };
+    const quint32 indices[] = { 0, 1, 2, 0, 2, 3 };
+
+    clear();
+    setVertexData(QByteArray(reinterpret_cast<const char *>(vertices), sizeof(vertices)));
+    setIndexData(QByteArray(reinterpret_cast<const char *>(indices), sizeof(indices)));
+    setStride(sizeof(QVector3D));
+    setBounds(QVector3D(-200, m_height, -200), QVector3D(200, m_height, 200));
+    setPrimitiveType(QQuick3DGeometry::PrimitiveType::Triangles);
+    addAttribute(QQuick3DGeometry::Attribute::PositionSemantic, 0,
+                 QQuick3DGeometry::Attribute::F32Type);
+    addAttribute(QQuick3DGeometry::Attribute::IndexSemantic, 0,
+                 QQuick3DGeometry::Attribute::U32Type);
+    update();
+}
@@ -0,0 +1,31 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#ifndef QUADGEOMETRY_H
+#define QUADGEOMETRY_H
+
+#include <QtQuick3D/QQuick3DGeometry>
+
+// A horizontal quad whose height can be changed without changing its topology
+class QuadGeometry : public QQuick3DGeometry
+{
+    Q_OBJECT
+    QML_NAMED_ELEMENT(QuadGeometry)
+
+    Q_PROPERTY(float height READ height WRITE setHeight NOTIFY heightChanged FINAL)
+
+public:
+    QuadGeometry();
+
+    float height() const;
+    void setHeight(float height);
+
+signals:
+    void heightChanged();
+
+private:
+    void updateData();
+    float m_height = 0.f;
+};
+
+#endif
@@ -0,0 +1,169 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+import QtQuick
+import QtTest
+import QtQuick3D
+import QtQuick3D.Physics
+import QuadGeometry
+
+// Drops balls on two quads far below them, then moves the vertices of the quads up. The triangle
+// mesh shared by both quads is refitted in place and the balls have to land on the quads at their
+// new height. A second physics world with a different time step uses the same mesh, so the mesh
+// can only be refitted when neither world is simulating, and the quad of the second world has to
+// be updated as well.
+
+Item {
+    width: 640
+    height: 480
+    visible: true
+
+    PhysicsWorld {
+        scene: viewport.scene
+        minimumTimestep: 16
+        maximumTimestep: 16
+    }
+
+    PhysicsWorld {
+        scene: secondViewport.scene
+        minimumTimestep: 5
+        maximumTimestep: 5
+    }
+
+    View3D {
+        id: viewport
+        width: parent.width / 2
+        height: parent.height
+
+        PerspectiveCamera {
+            position: Qt.vector3d(0, 200, 600)
+            clipFar: 5000
+            clipNear: 1
+        }
+
+        DynamicRigidBody {
+            id: ball
+            position: Qt.vector3d(0, 200, 0)
+            scale: Qt.vector3d(0.3, 0.3, 0.3)
+            collisionShapes: SphereShape {}
+            sendContactReports: true
+        }
+
+        StaticRigidBody {
+            id: quad
+            collisionShapes: TriangleMeshShape {
+                id: quadShape
+                refitGeometry: true
+                geometry: QuadGeometry {
+                    id: quadGeometry
+                    height: -1000
+                }
+            }
+
+            receiveContactReports: true
+            property bool ballHit: false
+            property real hitHeight: 0
+            onBodyContact: (body, positions, impulses, normals) => {
+                if (body === ball && !ballHit) {
+                    hitHeight = positions[0].y
+                    ballHit = true
+                }
+            }
+        }
+
+        DynamicRigidBody {
+            id: otherBall
+            position: Qt.vector3d(300, 200, 0)
+            scale: Qt.vector3d(0.3, 0.3, 0.3)
+            collisionShapes: SphereShape {}
+            sendContactReports: true
+        }
+
+        StaticRigidBody {
+            id: otherQuad
+            position: Qt.vector3d(300, 0, 0)
+            collisionShapes: TriangleMeshShape {
+                refitGeometry: true
+                geometry: quadGeometry
+            }
+
+            receiveContactReports: true
+            property bool ballHit: false
+            property real hitHeight: 0
+            onBodyContact: (body, positions, impulses, normals) => {
+                if (body === otherBall && !ballHit) {
+                    hitHeight = positions[0].y
+                    ballHit = true
+                }
+            }
+        }
+    }
+
+    View3D {
+        id: secondViewport
+        x: parent.width / 2
+        width: parent.width / 2
+        height: parent.height
+
+        PerspectiveCamera {
+            position: Qt.vector3d(0, 200, 600)
+            clipFar: 5000
+            clipNear: 1
+        }
+
+        DynamicRigidBody {
+            id: secondWorldBall
+            position: Qt.vector3d(0, 200, 0)
+            scale: Qt.vector3d(0.3, 0.3, 0.3)
+            collisionShapes: SphereShape {}
+            sendContactReports: true
+        }
+
+        StaticRigidBody {
+            id: secondWorldQuad
+            collisionShapes: TriangleMeshShape {
+                refitGeometry: true
+                geometry: quadGeometry
+            }
+
+            receiveContactReports: true
+            property bool ballHit: false
+            property real hitHeight: 0
+            onBodyContact: (body, positions, impulses, normals) => {
+                if (body === secondWorldBall && !ballHit) {
+                    hitHeight = positions[0].y
+                    ballHit = true
+                }
+            }
+        }
+    }
+
+    Timer {
+        interval: 100; running: true; repeat: false
+        onTriggered: quadGeometry.height = 0
+    }
+
+    TestCase {
+        name: "refit"
+        when: quad.ballHit
+        function test_hit() {
+            verify(quadShape.ready)
+            fuzzyCompare(quad.hitHeight, 0, 5)
+        }
+    }
+
+    TestCase {
+        name: "shared refit"
+        when: otherQuad.ballHit
+        function test_hit() {
+            fuzzyCompare(otherQuad.hitHeight, 0, 5)
+        }
+    }
+
+    TestCase {
+        name: "refit in two worlds"
+        when: secondWorldQuad.ballHit
+        function test_hit() {
+            fuzzyCompare(secondWorldQuad.hitHeight, 0, 5)
+        }
+    }
+}
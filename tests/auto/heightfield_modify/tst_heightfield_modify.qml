@@ -0,0 +1,143 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+import QtQuick
+import QtTest
+import QtQuick3D
+import QtQuick3D.Physics
+
+// Test raising a flat height field in place before a box lands on it. A second physics world with
+// a different time step shares the height field, its box has to land on the raised height field
+// as well.
+
+Item {
+    width: 640
+    height: 480
+    visible: true
+
+    PhysicsWorld {
+        scene: viewport.scene
+        forceDebugDraw: true
+        onFrameDone: {
+            if (heightField.modified)
+                return
+            let heights = []
+            for (let i = 0; i < 16 * 16; i++)
+                heights.push(1)
+            heightField.modified = heightField.modifySamples(Qt.rect(0, 0, 16, 16), heights)
+        }
+    }
+
+    PhysicsWorld {
+        scene: secondViewport.scene
+        minimumTimestep: 5
+        maximumTimestep: 5
+    }
+
+    View3D {
+        id: viewport
+        width: parent.width / 2
+        height: parent.height
+
+        PerspectiveCamera {
+            position: Qt.vector3d(0, 200, 800)
+            clipFar: 5000
+            clipNear: 1
+        }
+
+        DirectionalLight {
+            eulerRotation.x: -45
+            eulerRotation.y: 45
+        }
+
+        DynamicRigidBody {
+            id: box
+            property bool hit: false
+            onBodyContact: () => {
+                hit = true
+            }
+            receiveContactReports: true
+
+            position: Qt.vector3d(0, 600, 0)
+            collisionShapes: BoxShape {}
+            Model {
+                source: "#Cube"
+                materials: PrincipledMaterial {
+                    baseColor: "yellow"
+                }
+            }
+        }
+
+        StaticRigidBody {
+            collisionShapes: HeightFieldShape {
+                id: heightField
+                property bool modified: false
+                source: "qrc:/data/flat.png"
+                extents: "400, 200, 400"
+            }
+            sendContactReports: true
+        }
+    }
+
+    View3D {
+        id: secondViewport
+        x: parent.width / 2
+        width: parent.width / 2
+        height: parent.height
+
+        PerspectiveCamera {
+            position: Qt.vector3d(0, 200, 800)
+            clipFar: 5000
+            clipNear: 1
+        }
+
+        DynamicRigidBody {
+            id: secondWorldBox
+            property bool hit: false
+            onBodyContact: () => {
+                hit = true
+            }
+            receiveContactReports: true
+
+            position: Qt.vector3d(0, 600, 0)
+            collisionShapes: BoxShape {}
+        }
+
+        StaticRigidBody {
+            collisionShapes: HeightFieldShape {
+                source: "qrc:/data/flat.png"
+                extents: "400, 200, 400"
+            }
+            sendContactReports: true
+        }
+    }
+
+    TestCase {
+        name: "invalid"
+        when: heightField.modified
+        function test_invalid() {
+            ignoreWarning(/is outside of the height field/)
+            verify(!heightField.modifySamples(Qt.rect(8, 8, 16, 16), new Array(16 * 16).fill(0)))
+            ignoreWarning(/expected 4 heights/)
+            verify(!heightField.modifySamples(Qt.rect(0, 0, 2, 2), [0, 0, 0]))
+        }
+    }
+
+    TestCase {
+        name: "raised"
+        when: box.hit
+        function test_raised() {
+            verify(heightField.modified)
+            // The flat height field is at -100 and the raised one at 100
+            verify(box.position.y > 100)
+        }
+    }
+
+    TestCase {
+        name: "raised in two worlds"
+        when: secondWorldBox.hit
+        function test_raised() {
+            verify(heightField.modified)
+            verify(secondWorldBox.position.y > 100)
+        }
+    }
+}
@@ -0,0 +1,103 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+import QtTest
+import QtQuick3D
+import QtQuick3D.Physics
+import QtQuick
+
+Item {
+    width: 640
+    height: 480
+    visible: true
+
+    PhysicsWorld {
+        id: world
+        gravity: Qt.vector3d(0, -9.81, 0)
+        running: true
+        forceDebugDraw: true
+        typicalLength: 1
+        typicalSpeed: 10
+        minimumTimestep: 16.6667
+        maximumTimestep: 16.6667
+        scene: viewport.scene
+    }
+
+    PhysicsInstancing {
+        id: boxes
+        physicsWorld: world
+        collisionShape: BoxShape {
+            extents: Qt.vector3d(1, 1, 1)
+        }
+        Component.onCompleted: {
+            for (let i = 0; i < 10; i++)
+                addInstance(Qt.vector3d(i * 2 - 9, 5, 0))
+        }
+        property bool landed: false
+        property real lastY: 5
+        property int stillFrames: 0
+    }
+
+    // The first box has landed once it stayed in place on the plane for a number of frames
+    Connections {
+        target: world
+        function onFrameDone(timeStep) {
+            if (boxes.landed || boxes.count === 0)
+                return
+            const y = boxes.instancePosition(0).y
+            if (y < 1 && Math.abs(y - boxes.lastY) < 0.001)
+                boxes.stillFrames++
+            else
+                boxes.stillFrames = 0
+            boxes.lastY = y
+            boxes.landed = boxes.stillFrames >= 10
+        }
+    }
+
+    View3D {
+        id: viewport
+        anchors.fill: parent
+
+        PerspectiveCamera {
+            position: Qt.vector3d(0, 5, 20)
+            clipFar: 100
+            clipNear: 0.01
+        }
+
+        DirectionalLight {
+            eulerRotation.x: -45
+            eulerRotation.y: 45
+        }
+
+        StaticRigidBody {
+            eulerRotation: Qt.vector3d(-90, 0, 0)
+            collisionShapes: PlaneShape {}
+        }
+
+        Model {
+            source: "#Cube"
+            instancing: boxes
+            materials: PrincipledMaterial {
+                baseColor: "red"
+            }
+        }
+    }
+
+    TestCase {
+        name: "InstancesLand"
+        when: boxes.landed
+        function test_landed() {
+            compare(boxes.count, 10)
+            fuzzyCompare(boxes.instancePosition(0).y, 0.5, 0.05)
+            fuzzyCompare(boxes.instancePosition(0).x, -9, 0.05)
+        }
+        function test_remove() {
+            boxes.removeInstance(0)
+            compare(boxes.count, 9)
+            // The last instance was moved into the removed slot
+            fuzzyCompare(boxes.instancePosition(0).x, 9, 0.05)
+            boxes.clear()
+            compare(boxes.count, 0)
+        }
+    }
+}
@@ -13,6 +13,7 @@ Item {
     visible: true
 
     PhysicsWorld {
+        id: physicsWorld
         gravity: Qt.vector3d(0, -9.81, 0)
         running: true
         forceDebugDraw: true
@@ -269,6 +270,30 @@ Item {
                 }
             }
 
+            Node {
+                id: sleepNode
+                z: 5
+                StaticRigidBody {
+                    position: Qt.vector3d(0, -1, 0)
+                    collisionShapes: BoxShape {
+                        extents: Qt.vector3d(2, 1, 2)
+                    }
+                }
+
+                TestCube {
+                    id: sleeper
+                    color: "blue"
+                }
+
+                DynamicRigidBody {
+                    id: hitter
+                    y: 3
+                    gravityEnabled: false
+                    collisionShapes: SphereShape {
+                        diameter: 0.5
+                    }
+                }
+            }
 
             // Trick to get a callback when the physics simulation advances, no matter how slowly the CI machine is running
             DynamicRigidBody {
@@ -320,6 +345,52 @@ Item {
             fuzzyCompare(fallingBox.eulerRotation.x, 0, 1)
             fuzzyCompare(fallingBox.eulerRotation.z, 0, 1)
             compare(fallingBox.isSleeping, true)
+            verify(bodiesSleptSpy.count > 0)
+            verify(bodiesSleptSpy.signalArguments.some(
+                       args => Array.from(args[0]).includes(fallingBox)))
+        }
+        SignalSpy {
+            id: bodiesSleptSpy
+            target: physicsWorld
+            signalName: "bodiesSlept"
+        }
+    }
+
+    Connections {
+        id: sleepEvents
+        target: physicsWorld
+        property var woke: []
+        property var slept: []
+        function onBodiesWoke(bodies) {
+            woke = woke.concat(Array.from(bodies))
+        }
+        function onBodiesSlept(bodies) {
+            slept = slept.concat(Array.from(bodies))
+        }
+    }
+
+    TestCase {
+        name: "SleepEvents"
+        when: sleeper.isSleeping && hitter.isSleeping
+        function test_wake() {
+            verify(sleepEvents.slept.includes(sleeper))
+            verify(sleepEvents.slept.includes(hitter))
+
+            // A command wakes a sleeping body up and its position is updated again
+            const sleepingY = sleeper.y
+            sleepEvents.woke = []
+            sleeper.applyCentralImpulse(Qt.vector3d(0, 2000, 0))
+            tryVerify(() => sleepEvents.woke.includes(sleeper))
+            verify(!sleepEvents.woke.includes(hitter))
+            tryVerify(() => sleeper.y > sleepingY + 0.01)
+            tryVerify(() => sleeper.isSleeping, 10000)
+
+            // A body that is hit is woken up
+            sleepEvents.woke = []
+            hitter.setLinearVelocity(Qt.vector3d(0, -5, 0))
+            tryVerify(() => sleepEvents.woke.includes(sleeper))
+            verify(sleepEvents.woke.includes(hitter))
+            verify(!sleeper.isSleeping)
         }
     }
 
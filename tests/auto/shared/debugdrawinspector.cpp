@@ -0,0 +1,69 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "debugdrawinspector.h"
+
+#include <QtCore/QSet>
+#include <QtQml/QQmlListReference>
+#include <QtQuick3D/QQuick3DGeometry>
+
+static QQuick3DGeometry *modelGeometry(QObject *model)
+{
+    return model ? model->property("geometry").value<QQuick3DGeometry *>() : nullptr;
+}
+
+QList<QObject *> DebugDrawInspector::models(QObject *node) const
+{
+    QList<QObject *> result;
+    if (!node)
+        return result;
+    for (QObject *child : node->children()) {
+        if (child->inherits("QQuick3DModel"))
+            result.append(child);
+    }
+    return result;
+}
+
+QList<QObject *> DebugDrawInspector::visibleModels(QObject *node) const
+{
+    QList<QObject *> result;
+    for (QObject *model : models(node)) {
+        if (model->property("visible").toBool() && vertexCount(model) > 0)
+            result.append(model);
+    }
+    return result;
+}
+
+int DebugDrawInspector::geometryCount(QObject *node) const
+{
+    QSet<QQuick3DGeometry *> geometries;
+    for (QObject *model : models(node)) {
+        if (auto *geometry = modelGeometry(model))
+            geometries.insert(geometry);
+    }
+    return geometries.size();
+}
+
+int DebugDrawInspector::vertexCount(QObject *model) const
+{
+    auto *geometry = modelGeometry(model);
+    if (!geometry || geometry->stride() <= 0)
+        return 0;
+    return int(geometry->vertexData().size() / geometry->stride());
+}
+
+QVector3D DebugDrawInspector::boundsMax(QObject *model) const
+{
+    auto *geometry = modelGeometry(model);
+    return geometry ? geometry->boundsMax() : QVector3D();
+}
+
+QColor DebugDrawInspector::color(QObject *model) const
+{
+    if (!model)
+        return QColor();
+    QQmlListReference materials(model, "materials");
+    if (materials.count() == 0)
+        return QColor();
+    return materials.at(0)->property("diffuseColor").value<QColor>();
+}
@@ -0,0 +1,36 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#ifndef DEBUGDRAWINSPECTOR_H
+#define DEBUGDRAWINSPECTOR_H
+
+#include <QtCore/QObject>
+#include <QtGui/QColor>
+#include <QtGui/QVector3D>
+#include <QtQml/qqmlregistration.h>
+
+// Gives the tests access to the models the physics world creates for debug drawing. The models
+// are children of the viewport node of the world.
+class DebugDrawInspector : public QObject
+{
+    Q_OBJECT
+    QML_ELEMENT
+    QML_SINGLETON
+
+public:
+    // The models that are children of the node
+    Q_INVOKABLE QList<QObject *> models(QObject *node) const;
+    // The visible models with vertices that are children of the node
+    Q_INVOKABLE QList<QObject *> visibleModels(QObject *node) const;
+    // The number of different geometries used by the models that are children of the node
+    Q_INVOKABLE int geometryCount(QObject *node) const;
+
+    // The number of vertices of the geometry of the model
+    Q_INVOKABLE int vertexCount(QObject *model) const;
+    // The upper corner of the bounds of the geometry of the model
+    Q_INVOKABLE QVector3D boundsMax(QObject *model) const;
+    // The diffuse color of the first material of the model
+    Q_INVOKABLE QColor color(QObject *model) const;
+};
+
+#endif
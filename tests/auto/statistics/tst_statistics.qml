@@ -0,0 +1,90 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+import QtQuick
+import QtTest
+import QtQuick3D
+import QtQuick3D.Physics
+
+// Test that the statistics of the world are updated every frame
+
+Item {
+    width: 640
+    height: 480
+    visible: true
+
+    PhysicsWorld {
+        id: world
+        scene: viewport.scene
+    }
+
+    Connections {
+        id: statistics
+        target: world.statistics
+        property int updates: 0
+        property int shapeRebuilds: 0
+        function onUpdated() {
+            updates++
+            shapeRebuilds += world.statistics.shapeRebuildCount
+        }
+    }
+
+    View3D {
+        id: viewport
+        anchors.fill: parent
+
+        PerspectiveCamera {
+            position: Qt.vector3d(0, 200, 800)
+            clipFar: 5000
+            clipNear: 1
+        }
+
+        DirectionalLight {
+            eulerRotation.x: -45
+            eulerRotation.y: 45
+        }
+
+        DynamicRigidBody {
+            id: box
+            property bool hit: false
+            onBodyContact: () => {
+                hit = true
+            }
+            receiveContactReports: true
+
+            position: Qt.vector3d(0, 600, 0)
+            collisionShapes: BoxShape {
+                id: boxShape
+            }
+            Model {
+                source: "#Cube"
+                materials: PrincipledMaterial {
+                    baseColor: "yellow"
+                }
+            }
+        }
+
+        StaticRigidBody {
+            position: Qt.vector3d(0, -100, 0)
+            eulerRotation: Qt.vector3d(-90, 0, 0)
+            collisionShapes: PlaneShape {}
+            sendContactReports: true
+        }
+    }
+
+    TestCase {
+        name: "statistics"
+        when: box.hit
+        function test_statistics() {
+            verify(statistics.updates > 0)
+            compare(world.statistics.staticActorCount, 1)
+            compare(world.statistics.activeActorCount + world.statistics.sleepingActorCount, 1)
+            verify(world.statistics.fetchTime >= 0)
+            verify(world.statistics.syncTime >= world.statistics.commandTime)
+
+            // Resizing the box creates its shape again
+            const rebuilds = statistics.shapeRebuilds
+            boxShape.extents = Qt.vector3d(50, 50, 50)
+            tryVerify(() => statistics.shapeRebuilds > rebuilds)
+        }
+    }
+}
@@ -0,0 +1,98 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+import QtQuick
+import QtTest
+import QtQuick3D
+import QtQuick3D.Physics
+
+// Test that only the tiles near the focus node are loaded and that they collide
+
+Item {
+    width: 640
+    height: 480
+    visible: true
+
+    PhysicsWorld {
+        scene: viewport.scene
+        forceDebugDraw: true
+    }
+
+    View3D {
+        id: viewport
+        anchors.fill: parent
+
+        PerspectiveCamera {
+            position: Qt.vector3d(0, 400, 600)
+            eulerRotation.x: -30
+            clipFar: 5000
+            clipNear: 1
+        }
+
+        DirectionalLight {
+            eulerRotation.x: -45
+            eulerRotation.y: 45
+        }
+
+        Node {
+            id: focus
+            position: Qt.vector3d(-150, 0, -150)
+        }
+
+        DynamicRigidBody {
+            id: box
+            property bool hit: false
+            onBodyContact: () => {
+                hit = true
+            }
+            receiveContactReports: true
+
+            position: Qt.vector3d(-150, 300, -150)
+            scale: Qt.vector3d(0.2, 0.2, 0.2)
+            collisionShapes: BoxShape {}
+            Model {
+                source: "#Cube"
+                materials: PrincipledMaterial {
+                    baseColor: "yellow"
+                }
+            }
+        }
+
+        // 33x33 samples in tiles of 9 samples gives 4x4 tiles of 100x100
+        TiledHeightField {
+            id: terrain
+            source: "qrc:/data/terrain.png"
+            tileSize: 9
+            tileExtents: Qt.vector3d(100, 200, 100)
+            focusNode: focus
+            loadDistance: 60
+            sendContactReports: true
+        }
+    }
+
+    SignalSpy {
+        id: loadedSpy
+        target: terrain
+        signalName: "loadedTileCountChanged"
+    }
+
+    TestCase {
+        name: "tiles"
+        when: box.hit
+        function test_tiles() {
+            compare(terrain.tileCount, Qt.size(4, 4))
+            // The tile under the focus node and its two direct neighbors
+            compare(terrain.loadedTileCount, 3)
+            // The flat terrain is at -100
+            verify(box.position.y < 0)
+
+            // The three tiles are released and the three in the opposite corner loaded
+            loadedSpy.clear()
+            focus.position = Qt.vector3d(150, 0, 150)
+            tryVerify(() => loadedSpy.count >= 6)
+            compare(terrain.loadedTileCount, 3)
+
+            terrain.focusNode = null
+            tryCompare(terrain, "loadedTileCount", 16)
+        }
+    }
+}
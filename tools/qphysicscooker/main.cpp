@@ -0,0 +1,579 @@
+// Copyright (C) 2021 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include "cooking/PxCooking.h"
+
+#include <QtQuick3DPhysics/private/qcacheutils_p.h>
+#include <QtQuick3DPhysics/private/qphysicsheightmap_p.h>
+#include <QtQuick3DPhysics/private/qphysicsmeshreader_p.h>
+
+#include <QtCore/QBuffer>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDir>
+#include <QtCore/QDirIterator>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMutex>
+#include <QtCore/QSaveFile>
+#include <QtCore/QSet>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtCore/QTimeZone>
+#include <QtGui/QImage>
+#include <QtGui/QImageReader>
+#include <QCommandLineParser>
+#include <QScopeGuard>
+
+#include "PxPhysicsAPI.h"
+#include "cooking/PxCooking.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+
+enum OutputKind { TriangleMesh = 0x1, ConvexMesh = 0x2, HeightField = 0x4 };
+
+struct CookJob
+{
+    QString inputPath;
+    // Output path without the .cooked.{tri/cvx/hf} suffix
+    QString outputBase;
+};
+
+struct CookedOutput
+{
+    QString inputPath;
+    qint64 inputSize = 0;
+    qint64 inputLastModified = 0;
+    QByteArray inputHash;
+    QString outputPath;
+    const char *kind = nullptr;
+    qint64 size = 0;
+    QByteArray hash;
+};
+
+static QMutex outputMutex;
+
+static void printMessage(std::ostream &stream, const QString &message)
+{
+    QMutexLocker locker(&outputMutex);
+    stream << message.toStdString() << std::endl;
+}
+
+bool tryReadMesh(const QByteArray &data, QPhysicsMeshReader::MeshData &mesh)
+{
+    QBuffer buffer;
+    buffer.setData(data);
+    if (!buffer.open(QIODevice::ReadOnly))
+        return false;
+    const quint32 id = 1;
+    mesh = QPhysicsMeshReader::readMesh(&buffer, id);
+    return mesh.isValid();
+}
+
+bool tryReadImage(const QString &inputPath, QImage &image)
+{
+    image = QImage(inputPath);
+    return image.format() != QImage::Format_Invalid;
+}
+
+// Set when the outputs are written as PhysX binary collections instead of cooked streams
+static physx::PxPhysics *serializationPhysics = nullptr;
+static QMutex serializationMutex;
+
+static bool serializeCooked(physx::PxDefaultMemoryOutputStream &cooked, const char *kind,
+                            physx::PxDefaultMemoryOutputStream &serialized)
+{
+    physx::PxDefaultMemoryInputData input(cooked.getData(), cooked.getSize());
+
+    // Creating and serializing objects goes through the shared PxPhysics
+    QMutexLocker locker(&serializationMutex);
+    physx::PxBase *object = nullptr;
+    if (qstrcmp(kind, "tri") == 0)
+        object = serializationPhysics->createTriangleMesh(input);
+    else if (qstrcmp(kind, "cvx") == 0)
+        object = serializationPhysics->createConvexMesh(input);
+    else
+        object = serializationPhysics->createHeightField(input);
+    if (!object)
+        return false;
+
+    auto *registry = physx::PxSerialization::createSerializationRegistry(*serializationPhysics);
+    auto *collection = PxCreateCollection();
+    collection->add(*object);
+    const bool ok = physx::PxSerialization::serializeCollectionToBinary(serialized, *collection,
+                                                                       *registry);
+    collection->release();
+    registry->release();
+    if (auto *mesh = object->is<physx::PxTriangleMesh>())
+        mesh->release();
+    else if (auto *convex = object->is<physx::PxConvexMesh>())
+        convex->release();
+    else if (auto *heightField = object->is<physx::PxHeightField>())
+        heightField->release();
+    return ok;
+}
+
+static bool writeOutput(const QString &outputPath, physx::PxDefaultMemoryOutputStream &cooked,
+                        const char *kind, CookedOutput output, QList<CookedOutput> *outputs)
+{
+    physx::PxDefaultMemoryOutputStream serialized;
+    if (serializationPhysics && !serializeCooked(cooked, kind, serialized)) {
+        printMessage(std::cerr, QStringLiteral("Error: could not serialize '%1'.").arg(outputPath));
+        return false;
+    }
+    physx::PxDefaultMemoryOutputStream &buf = serializationPhysics ? serialized : cooked;
+
+    QSaveFile outputFile(outputPath);
+    if (!outputFile.open(QIODevice::WriteOnly)) {
+        printMessage(std::cerr, QStringLiteral("Error: could not open '%1' for writing.").arg(outputPath));
+        return false;
+    }
+
+    const QByteArrayView data(reinterpret_cast<const char *>(buf.getData()), buf.getSize());
+    outputFile.write(data.data(), data.size());
+    if (!outputFile.commit()) {
+        printMessage(std::cerr, QStringLiteral("Error: could not write '%1'.").arg(outputPath));
+        return false;
+    }
+
+    output.outputPath = outputPath;
+    output.kind = kind;
+    output.size = data.size();
+    output.hash = QCryptographicHash::hash(data, QCryptographicHash::Sha256);
+
+    QMutexLocker locker(&outputMutex);
+    outputs->append(output);
+    return true;
+}
+
+bool cookMeshes(const QString &inputPath, const QPhysicsMeshReader::MeshData &mesh,
+                physx::PxCooking *cooking, int kinds, const QString &outputBase,
+                const CookedOutput &input, QList<CookedOutput> *outputs)
+{
+    Q_ASSERT(cooking);
+
+    // The reader returns tightly packed positions
+    const int vCount = mesh.vertexCount();
+    const auto *vd = mesh.positions.constData();
+
+    const int iStride = mesh.u16Indices ? 2 : 4;
+    const int iCount = mesh.indices.size() / iStride;
+
+    if (kinds & TriangleMesh) {
+        physx::PxTriangleMeshCookingResult::Enum result;
+        physx::PxTriangleMeshDesc triangleDesc;
+        triangleDesc.points.count = vCount;
+        triangleDesc.points.stride = sizeof(physx::PxVec3);
+        triangleDesc.points.data = vd;
+
+        triangleDesc.flags = {};
+        if (iStride == 2)
+            triangleDesc.flags.set(physx::PxMeshFlag::e16_BIT_INDICES);
+        triangleDesc.triangles.count = iCount / 3;
+        triangleDesc.triangles.stride = iStride * 3;
+        triangleDesc.triangles.data = mesh.indices.constData();
+
+        physx::PxDefaultMemoryOutputStream buf;
+        if (!cooking->cookTriangleMesh(triangleDesc, buf, &result)) {
+            printMessage(std::cerr, QStringLiteral("Error: could not cook triangle mesh '%1'.").arg(inputPath));
+            return false;
+        }
+
+        const QString output = outputBase + QStringLiteral(".cooked.tri");
+        if (!writeOutput(output, buf, "tri", input, outputs))
+            return false;
+
+        printMessage(std::cout, QStringLiteral("Success: wrote triangle mesh '%1'.").arg(output));
+    }
+
+    if (kinds & ConvexMesh) {
+        physx::PxConvexMeshCookingResult::Enum result;
+        physx::PxConvexMeshDesc convexDesc;
+        convexDesc.points.count = vCount;
+        convexDesc.points.stride = sizeof(physx::PxVec3);
+        convexDesc.points.data = vd;
+        convexDesc.flags = physx::PxConvexFlag::eCOMPUTE_CONVEX;
+
+        physx::PxDefaultMemoryOutputStream buf;
+        if (!cooking->cookConvexMesh(convexDesc, buf, &result)) {
+            printMessage(std::cerr, QStringLiteral("Error: could not cook convex mesh '%1'.").arg(inputPath));
+            return false;
+        }
+
+        const QString output = outputBase + QStringLiteral(".cooked.cvx");
+        if (!writeOutput(output, buf, "cvx", input, outputs))
+            return false;
+
+        printMessage(std::cout, QStringLiteral("Success: wrote convex mesh '%1'.").arg(output));
+    }
+
+    return true;
+}
+
+bool cookHeightfield(const QString &inputPath, QImage &heightMap, physx::PxCooking *cooking,
+                     const QString &outputBase, const CookedOutput &input,
+                     QList<CookedOutput> *outputs)
+{
+    Q_ASSERT(cooking);
+
+    int numRows = heightMap.height();
+    int numCols = heightMap.width();
+
+    QList<physx::PxHeightFieldSample> samples(qsizetype(numRows) * numCols);
+    QPhysicsHeightMap::fillSamples(heightMap, samples.data());
+
+    physx::PxHeightFieldDesc hfDesc;
+    hfDesc.format = physx::PxHeightFieldFormat::eS16_TM;
+    hfDesc.nbColumns = numRows;
+    hfDesc.nbRows = numCols;
+    hfDesc.samples.data = samples.constData();
+    hfDesc.samples.stride = sizeof(physx::PxHeightFieldSample);
+
+    physx::PxDefaultMemoryOutputStream buf;
+    if (!(numRows && numCols && cooking->cookHeightField(hfDesc, buf))) {
+        printMessage(std::cerr, QStringLiteral("Could not create height field from '%1'.").arg(inputPath));
+        return false;
+    }
+
+    const QString output = outputBase + QStringLiteral(".cooked.hf");
+    if (!writeOutput(output, buf, "hf", input, outputs))
+        return false;
+
+    printMessage(std::cout, QStringLiteral("Success: wrote height field '%1'").arg(output));
+
+    return true;
+}
+
+static bool cookFile(const CookJob &job, physx::PxCooking *cooking, int kinds,
+                     QList<CookedOutput> *outputs)
+{
+    const QString &inputPath = job.inputPath;
+    QFile file(inputPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        printMessage(std::cerr, QStringLiteral("Error: could not open input file '%1'").arg(inputPath));
+        return false;
+    }
+    const QByteArray data = file.readAll();
+
+    CookedOutput input;
+    input.inputPath = inputPath;
+    input.inputSize = data.size();
+    input.inputLastModified =
+            QFileInfo(file).lastModified(QTimeZone::UTC).toMSecsSinceEpoch();
+    input.inputHash = QCryptographicHash::hash(data, QCryptographicHash::Sha256);
+
+    QImage image;
+    QPhysicsMeshReader::MeshData mesh;
+    if (tryReadImage(inputPath, image)) {
+        if (!(kinds & HeightField)) {
+            printMessage(std::cout, QStringLiteral("Skipping image '%1'").arg(inputPath));
+            return true;
+        }
+        return cookHeightfield(inputPath, image, cooking, job.outputBase, input, outputs);
+    } else if (tryReadMesh(data, mesh)) {
+        if (!(kinds & (TriangleMesh | ConvexMesh))) {
+            printMessage(std::cout, QStringLiteral("Skipping mesh '%1'").arg(inputPath));
+            return true;
+        }
+        return cookMeshes(inputPath, mesh, cooking, kinds, job.outputBase, input, outputs);
+    }
+
+    printMessage(std::cerr, QStringLiteral("Error: failed to read mesh or image from file '%1'").arg(inputPath));
+    return false;
+}
+
+static QStringList inputNameFilters()
+{
+    QStringList filters = { QStringLiteral("*.mesh") };
+    const auto formats = QImageReader::supportedImageFormats();
+    for (const QByteArray &format : formats)
+        filters.append(QStringLiteral("*.") + QString::fromLatin1(format));
+    return filters;
+}
+
+// Expands an input argument, which can be a file, a directory or a wildcard pattern, to cooking
+// jobs. Files found in a directory keep their relative path below the output directory.
+static bool collectJobs(const QString &input, const QDir &outputDir, QList<CookJob> *jobs)
+{
+    const QFileInfo info(input);
+
+    if (info.isDir()) {
+        const QDir inputDir(input);
+        QDirIterator it(input, inputNameFilters(), QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            const QFileInfo file(it.next());
+            const QString relativeDir = inputDir.relativeFilePath(file.path());
+            jobs->append({ file.filePath(),
+                           outputDir.filePath(QDir(relativeDir).filePath(file.baseName())) });
+        }
+        return true;
+    }
+
+    if (input.contains(QLatin1Char('*')) || input.contains(QLatin1Char('?'))
+        || input.contains(QLatin1Char('['))) {
+        const QDir dir(info.path());
+        const QFileInfoList files = dir.entryInfoList({ info.fileName() }, QDir::Files, QDir::Name);
+        if (files.isEmpty()) {
+            std::cerr << "Error: no input files match '" << input.toStdString() << "'" << std::endl;
+            return false;
+        }
+        for (const QFileInfo &file : files)
+            jobs->append({ file.filePath(), outputDir.filePath(file.baseName()) });
+        return true;
+    }
+
+    jobs->append({ input, outputDir.filePath(info.baseName()) });
+    return true;
+}
+
+// Returns the files that cooking the job writes, images produce a height field and other files
+// meshes
+static QStringList jobOutputPaths(const CookJob &job, int kinds)
+{
+    const QString outputBase = QDir::cleanPath(job.outputBase);
+    QStringList paths;
+    if (!QImageReader::imageFormat(job.inputPath).isEmpty()) {
+        if (kinds & HeightField)
+            paths.append(outputBase + QStringLiteral(".cooked.hf"));
+        return paths;
+    }
+    if (kinds & TriangleMesh)
+        paths.append(outputBase + QStringLiteral(".cooked.tri"));
+    if (kinds & ConvexMesh)
+        paths.append(outputBase + QStringLiteral(".cooked.cvx"));
+    return paths;
+}
+
+static bool writeManifest(const QString &manifestPath, QList<CookedOutput> outputs)
+{
+    std::sort(outputs.begin(), outputs.end(), [](const CookedOutput &a, const CookedOutput &b) {
+        return a.outputPath < b.outputPath;
+    });
+
+    QJsonArray files;
+    for (const CookedOutput &output : std::as_const(outputs)) {
+        QJsonObject object;
+        object.insert(QLatin1String("input"), output.inputPath);
+        object.insert(QLatin1String("inputSize"), output.inputSize);
+        object.insert(QLatin1String("inputSha256"), QString::fromLatin1(output.inputHash.toHex()));
+        object.insert(QLatin1String("output"), output.outputPath);
+        object.insert(QLatin1String("kind"), QLatin1String(output.kind));
+        object.insert(QLatin1String("size"), output.size);
+        object.insert(QLatin1String("sha256"), QString::fromLatin1(output.hash.toHex()));
+        files.append(object);
+    }
+
+    QJsonObject root;
+    root.insert(QLatin1String("physxVersion"), qint64(PX_PHYSICS_VERSION));
+    root.insert(QLatin1String("files"), files);
+
+    QSaveFile manifestFile(manifestPath);
+    if (!manifestFile.open(QIODevice::WriteOnly)) {
+        std::cerr << "Error: could not open '" << manifestPath.toStdString() << "' for writing." << std::endl;
+        return false;
+    }
+    manifestFile.write(QJsonDocument(root).toJson());
+    if (!manifestFile.commit()) {
+        std::cerr << "Error: could not write '" << manifestPath.toStdString() << "'." << std::endl;
+        return false;
+    }
+    std::cout << "Success: wrote manifest '" << manifestPath.toStdString() << "'" << std::endl;
+    return true;
+}
+
+// Writes the inputs to a cache index that the runtime reads from the cache directory. The inputs
+// are keyed by their path relative to the root, with the prefix prepended if one is given.
+static bool writeIndex(const QString &indexPath, const QString &root, const QString &prefix,
+                       const QList<CookedOutput> &outputs)
+{
+    QHash<QString, QCacheUtils::CacheIndexEntry> index;
+    for (const CookedOutput &output : outputs) {
+        QString key = QCacheUtils::cacheIndexKey(output.inputPath, root);
+        if (!prefix.isEmpty()) {
+            const QString relativePath =
+                    QDir(root).relativeFilePath(QFileInfo(output.inputPath).absoluteFilePath());
+            key = QDir::cleanPath(prefix + QLatin1Char('/') + relativePath);
+        }
+        QCacheUtils::CacheIndexEntry entry;
+        entry.size = output.inputSize;
+        entry.lastModified = output.inputLastModified;
+        entry.hash = output.inputHash;
+        index.insert(key, entry);
+    }
+
+    if (!QCacheUtils::writeCacheIndex(indexPath, index)) {
+        std::cerr << "Error: could not write '" << indexPath.toStdString() << "'." << std::endl;
+        return false;
+    }
+    std::cout << "Success: wrote cache index '" << indexPath.toStdString() << "'" << std::endl;
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("qphysicscooker");
+    QCoreApplication::setApplicationVersion("6.5.7");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+            "A commandline utility for pre-cooking meshes for use with the QtQuick3DPhysics module.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("input",
+                                 "The input file(s). Accepts either a .mesh created by QtQuick3D's balsam"
+                                 " or a Qt compatible image file. Directories are searched recursively and"
+                                 " wildcard patterns are expanded. The output filename will be of the format"
+                                 " input.cooked.{cvx/tri/hf}. The filename suffixes .cvx, .tri, and .hf"
+                                 " mean it is a convex mesh, a triangle mesh or a heightfield.");
+    QCommandLineOption outputDirOption({ "o", "output-dir" },
+                                       "Write the cooked files to <directory> instead of the current"
+                                       " directory.",
+                                       "directory", ".");
+    QCommandLineOption kindsOption({ "k", "kinds" },
+                                   "Comma separated list of the outputs to cook: tri, cvx and hf. Meshes"
+                                   " produce tri and cvx, images produce hf. Defaults to all.",
+                                   "kinds", "tri,cvx,hf");
+    QCommandLineOption jobsOption({ "j", "jobs" },
+                                  "Cook <count> files in parallel. Defaults to the number of cores.",
+                                  "count");
+    QCommandLineOption manifestOption({ "m", "manifest" },
+                                      "Write a JSON manifest with the size and SHA-256 of every input"
+                                      " and output file to <file>.",
+                                      "file");
+    parser.addOption(outputDirOption);
+    parser.addOption(kindsOption);
+    parser.addOption(jobsOption);
+    QCommandLineOption serializeOption({ "s", "serialize" },
+                                       "Write PhysX binary collections that are loaded in place from"
+                                       " memory mapped files instead of cooked streams. Binary"
+                                       " collections are specific to the platform and PhysX version"
+                                       " the tool was built for.");
+    QCommandLineOption indexOption({ "i", "index" },
+                                   "Write a cache index with the size and SHA-256 of every"
+                                   " input to <file>. Copied to the cache directory as"
+                                   " index.json, it is used with QT_PHYSICS_CACHE_TRUSTED.",
+                                   "file");
+    QCommandLineOption indexRootOption("index-root",
+                                       "Key the inputs in the cache index by their path"
+                                       " relative to <directory>, which is deployed as the"
+                                       " application directory or QT_PHYSICS_CACHE_ROOT."
+                                       " Defaults to the current directory.",
+                                       "directory", ".");
+    QCommandLineOption indexPrefixOption("index-prefix",
+                                         "Prepend <prefix> to the keys in the cache index, for"
+                                         " example :/assets for inputs that are added to the"
+                                         " resources under that prefix.",
+                                         "prefix");
+    parser.addOption(manifestOption);
+    parser.addOption(serializeOption);
+    parser.addOption(indexOption);
+    parser.addOption(indexRootOption);
+    parser.addOption(indexPrefixOption);
+    parser.process(app);
+
+    const QStringList args = parser.positionalArguments();
+    if (args.isEmpty())
+        parser.showHelp(0);
+
+    int kinds = 0;
+    const QStringList kindNames = parser.value(kindsOption).split(QLatin1Char(','), Qt::SkipEmptyParts);
+    for (const QString &kind : kindNames) {
+        if (kind == QLatin1String("tri")) {
+            kinds |= TriangleMesh;
+        } else if (kind == QLatin1String("cvx")) {
+            kinds |= ConvexMesh;
+        } else if (kind == QLatin1String("hf")) {
+            kinds |= HeightField;
+        } else {
+            std::cerr << "Error: unknown output kind '" << kind.toStdString() << "'" << std::endl;
+            return -1;
+        }
+    }
+
+    int jobCount = QThread::idealThreadCount();
+    if (parser.isSet(jobsOption)) {
+        bool ok = false;
+        jobCount = parser.value(jobsOption).toInt(&ok);
+        if (!ok || jobCount < 1) {
+            std::cerr << "Error: invalid job count '" << parser.value(jobsOption).toStdString() << "'" << std::endl;
+            return -1;
+        }
+    }
+
+    const QDir outputDir(parser.value(outputDirOption));
+    QList<CookJob> jobs;
+    for (const QString &input : args) {
+        if (!collectJobs(input, outputDir, &jobs))
+            return -1;
+    }
+
+    // Two inputs writing the same output file would overwrite each other's output
+    QSet<QString> outputPaths;
+    for (const CookJob &job : std::as_const(jobs)) {
+        for (const QString &outputPath : jobOutputPaths(job, kinds)) {
+            if (outputPaths.contains(outputPath)) {
+                std::cerr << "Error: more than one input would be written to '" << outputPath.toStdString()
+                          << "'" << std::endl;
+                return -1;
+            }
+            outputPaths.insert(outputPath);
+        }
+        if (!QDir().mkpath(QFileInfo(job.outputBase).path())) {
+            std::cerr << "Error: could not create directory for '" << job.outputBase.toStdString() << "'"
+                      << std::endl;
+            return -1;
+        }
+    }
+
+    physx::PxDefaultErrorCallback defaultErrorCallback;
+    physx::PxDefaultAllocator defaultAllocatorCallback;
+    auto foundation = PxCreateFoundation(PX_PHYSICS_VERSION, defaultAllocatorCallback, defaultErrorCallback);
+    auto cooking = PxCreateCooking(PX_PHYSICS_VERSION, *foundation, physx::PxCookingParams(physx::PxTolerancesScale()));
+    physx::PxPhysics *physics = nullptr;
+    if (parser.isSet(serializeOption)) {
+        physics = PxCreatePhysics(PX_PHYSICS_VERSION, *foundation, physx::PxTolerancesScale());
+        serializationPhysics = physics;
+    }
+    auto cleanup = qScopeGuard([&] {
+        serializationPhysics = nullptr;
+        if (physics)
+            physics->release();
+        cooking->release();
+        foundation->release();
+    });
+
+    // The cooking functions do not modify the PxCooking object and can run in parallel
+    std::atomic<bool> failed = false;
+    QList<CookedOutput> outputs;
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(jobCount);
+    for (const CookJob &job : std::as_const(jobs)) {
+        threadPool.start([&, job] {
+            if (failed)
+                return;
+            if (!cookFile(job, cooking, kinds, &outputs))
+                failed = true;
+        });
+    }
+    threadPool.waitForDone();
+
+    if (failed)
+        return -1;
+
+    if (parser.isSet(manifestOption) && !writeManifest(parser.value(manifestOption), outputs))
+        return -1;
+
+    if (parser.isSet(indexOption)
+        && !writeIndex(parser.value(indexOption),
+                       QFileInfo(parser.value(indexRootOption)).absoluteFilePath(),
+                       parser.value(indexPrefixOption), outputs)) {
+        return -1;
+    }
+
+    return 0;
+}